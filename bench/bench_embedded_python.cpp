@@ -0,0 +1,87 @@
+// Накладные расходы одного вызова Python: встроенный интерпретатор (GIL + memoryview
+// поверх буфера + вызов) против HTTP-запроса к серверу с тем же объёмом float32.
+// HTTP-запрос уходит на /predict/binary без модели: сервер отвечает ошибкой до
+// разбора тензоров, так что замеряется только транспорт и фреймворк.
+// Сборка: -DRESSYS_EMBED_PYTHON=ON -DRESSYS_BUILD_BENCHMARKS=ON; сервер должен быть запущен.
+// Использование: bench_embedded_python <python_server_dir> [python_home] [port=8000] [floats=65536] [calls=2000]
+#include "curl_handle_pool.h"
+#include "embedded_python.h"
+#include "http_client.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static void report(const std::string& name, const std::function<bool()>& call, int calls) {
+    call(); // прогрев: соединение / первый вызов
+
+    std::vector<double> latencies_us;
+    latencies_us.reserve(calls);
+    int failures = 0;
+
+    for (int i = 0; i < calls; ++i) {
+        auto start = Clock::now();
+        if (!call()) {
+            ++failures;
+        }
+        latencies_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    double total = 0.0;
+    for (double v : latencies_us) {
+        total += v;
+    }
+    auto percentile = [&](double p) {
+        return latencies_us[std::min(latencies_us.size() - 1, static_cast<size_t>(p * latencies_us.size()))];
+    };
+
+    std::cout << name << ": mean " << total / calls << " us, p50 " << percentile(0.50) << " us, p99 "
+              << percentile(0.99) << " us, failures " << failures << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: bench_embedded_python <python_server_dir> [python_home] [port=8000] [floats=65536] "
+                     "[calls=2000]" << std::endl;
+        return 1;
+    }
+    std::string server_dir = argv[1];
+    std::string python_home = argc > 2 ? argv[2] : "";
+    int port = argc > 3 ? std::stoi(argv[3]) : 8000;
+    size_t floats = argc > 4 ? std::stoul(argv[4]) : 65536;
+    int calls = argc > 5 ? std::stoi(argv[5]) : 2000;
+
+    Logger logger(false);
+    EmbeddedPython python(logger);
+    auto started_at = Clock::now();
+    if (!python.start(server_dir, python_home)) {
+        std::cerr << python.lastError() << std::endl;
+        return 1;
+    }
+    std::cout << "embedded start (import ml.predict, ml.train): "
+              << std::chrono::duration<double, std::milli>(Clock::now() - started_at).count() << " ms" << std::endl;
+
+    std::vector<float> data(floats, 1.0f);
+    std::string payload(floats * sizeof(float), '\0');
+    std::memcpy(&payload[0], data.data(), payload.size());
+
+    report("embedded " + std::to_string(floats) + " floats", [&]() { return python.ping(data.data(), data.size()); },
+           calls);
+
+    CurlHandlePool::instance();
+    HttpClient client("localhost", port, 5000);
+    if (!client.healthCheck()) {
+        std::cout << "server on port " << port << " is not running, HTTP part skipped" << std::endl;
+        return 0;
+    }
+    report("http /health", [&]() { return client.healthCheck(); }, calls);
+    report("http " + std::to_string(floats) + " floats",
+           [&]() { return !client.predictWithModelBinary("bench", "", "", payload).empty(); }, calls);
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Задержка healthCheck(): новый хэндл и соединение на каждый запрос (как раньше)
+// против пула хэндлов с keep-alive. Сервер должен быть уже запущен.
+// Использование: bench_http_health [host=localhost] [port=8000] [requests=500]
+#include "curl_handle_pool.h"
+#include "http_client.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static size_t discardBody(void*, size_t size, size_t nmemb, void*) {
+    return size * nmemb;
+}
+
+// Прежняя схема: curl_easy_init/cleanup и новое TCP-соединение на каждый запрос
+static bool freshHandleHealth(const std::string& url) {
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        return false;
+    }
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discardBody);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, 5000L);
+    CURLcode res = curl_easy_perform(curl);
+    curl_easy_cleanup(curl);
+    return res == CURLE_OK;
+}
+
+template <typename Fn>
+static void report(const std::string& name, int requests, Fn fn) {
+    std::vector<double> latencies_us;
+    latencies_us.reserve(requests);
+    int failures = 0;
+
+    for (int i = 0; i < requests; ++i) {
+        auto start = Clock::now();
+        if (!fn()) {
+            ++failures;
+        }
+        latencies_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    double total = 0.0;
+    for (double v : latencies_us) {
+        total += v;
+    }
+    auto percentile = [&](double p) {
+        return latencies_us[std::min(latencies_us.size() - 1, static_cast<size_t>(p * latencies_us.size()))];
+    };
+
+    std::cout << name << ": mean " << total / requests << " us, p50 " << percentile(0.50)
+              << " us, p99 " << percentile(0.99) << " us, failures " << failures << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::string host = argc > 1 ? argv[1] : "localhost";
+    int port = argc > 2 ? std::stoi(argv[2]) : 8000;
+    int requests = argc > 3 ? std::stoi(argv[3]) : 500;
+
+    CurlHandlePool::instance(); // curl_global_init до первого замера
+    std::string url = "http://" + host + ":" + std::to_string(port) + "/health";
+
+    report("fresh handle per request", requests, [&]() { return freshHandleHealth(url); });
+
+    HttpClient client(host, port, 5000);
+    client.healthCheck(); // устанавливаем keep-alive соединение
+    report("pooled keep-alive client", requests, [&]() { return client.healthCheck(); });
+    return 0;
+}
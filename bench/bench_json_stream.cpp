@@ -0,0 +1,169 @@
+// Разбор ответа /predict/binary?inline=1: PredictionReplyDecoder по кускам, как из write
+// callback curl, против прежней схемы - тело накапливается в std::string и разбирается
+// jsoncpp в дерево. Печатает время, MB/s и пик памяти кучи сверх исходной.
+// Использование: bench_json_stream [samples=500000] [targets=4] [chunk_kb=16]
+#include "prediction_reply.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include <json/json.h>
+
+// Учёт кучи: размер блока хранится перед ним
+static std::atomic<size_t> g_heap_current{0};
+static std::atomic<size_t> g_heap_peak{0};
+static const size_t kHeader = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+    char* block = static_cast<char*>(std::malloc(size + kHeader));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    size_t current = g_heap_current += size;
+    size_t peak = g_heap_peak.load();
+    while (current > peak && !g_heap_peak.compare_exchange_weak(peak, current)) {
+    }
+    return block + kHeader;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr) {
+        char* block = static_cast<char*>(ptr) - kHeader;
+        g_heap_current -= *reinterpret_cast<size_t*>(block);
+        std::free(block);
+    }
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+static std::string makeResponse(size_t samples, int targets, std::vector<float>& expected) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    expected.resize(samples * targets);
+    std::string text = "{\"status\": \"success\", \"metrics\": {\"mse\": 0.0123, \"r2\": 0.987, \"test_loss\": 0.0125}, "
+                       "\"num_samples\": " + std::to_string(samples) + ", \"num_targets\": " + std::to_string(targets) +
+                       ", \"predictions\": [";
+    char number[32];
+    for (size_t i = 0; i < expected.size(); ++i) {
+        expected[i] = dist(rng);
+        int len = std::snprintf(number, sizeof(number), "%.9g", expected[i]);
+        if (i > 0) {
+            text += ',';
+        }
+        text.append(number, len);
+    }
+    text += "]}";
+    return text;
+}
+
+struct Result {
+    double ms = 0.0;
+    size_t peak_bytes = 0;
+    bool ok = false;
+};
+
+static void resetPeak() {
+    g_heap_peak = g_heap_current.load();
+}
+
+static Result runStreaming(const std::string& text, size_t chunk, const std::vector<float>& expected) {
+    Result result;
+    size_t base = g_heap_current;
+    resetPeak();
+    auto start = std::chrono::steady_clock::now();
+
+    PredictionReplyDecoder decoder(expected.size());
+    for (size_t offset = 0; offset < text.size(); offset += chunk) {
+        decoder.feed(text.data() + offset, std::min(chunk, text.size() - offset));
+    }
+    decoder.finish();
+    PredictionReply reply;
+    std::string error;
+    result.ok = decoder.take(reply, error);
+
+    result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.peak_bytes = g_heap_peak - base;
+    if (!result.ok) {
+        std::cerr << "Streaming decode failed: " << error << std::endl;
+    }
+    result.ok = result.ok && reply.predictions == expected;
+    return result;
+}
+
+static Result runJsonCpp(const std::string& text, size_t chunk, const std::vector<float>& expected) {
+    Result result;
+    size_t base = g_heap_current;
+    resetPeak();
+    auto start = std::chrono::steady_clock::now();
+
+    std::string body; // как writeCallback: тело копится целиком
+    for (size_t offset = 0; offset < text.size(); offset += chunk) {
+        body.append(text.data() + offset, std::min(chunk, text.size() - offset));
+    }
+    Json::Value value;
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    std::string error;
+    result.ok = reader->parse(body.data(), body.data() + body.size(), &value, &error) &&
+                value.get("status", "").asString() == "success";
+    std::vector<float> predictions;
+    if (result.ok) {
+        const Json::Value& array = value["predictions"];
+        predictions.reserve(array.size());
+        for (const auto& item : array) {
+            predictions.push_back(item.asFloat());
+        }
+    }
+
+    result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.peak_bytes = g_heap_peak - base;
+    if (!result.ok) {
+        std::cerr << "jsoncpp parse failed: " << error << std::endl;
+    }
+    result.ok = result.ok && predictions == expected;
+    return result;
+}
+
+int main(int argc, char** argv) {
+    size_t samples = argc > 1 ? std::stoul(argv[1]) : 500000;
+    int targets = argc > 2 ? std::stoi(argv[2]) : 4;
+    size_t chunk = (argc > 3 ? std::stoul(argv[3]) : 16) * 1024; // CURL_MAX_WRITE_SIZE по умолчанию - 16 КБ
+
+    std::vector<float> expected;
+    std::string text = makeResponse(samples, targets, expected);
+    double text_mb = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+    std::cout << "Response: " << text_mb << " MB, " << expected.size() << " predictions, chunks of "
+              << chunk / 1024 << " KB" << std::endl;
+
+    struct Variant {
+        const char* name;
+        Result (*run)(const std::string&, size_t, const std::vector<float>&);
+    };
+    for (const Variant& variant : {Variant{"streaming", runStreaming}, Variant{"jsoncpp", runJsonCpp}}) {
+        Result best;
+        for (int rep = 0; rep < 3; ++rep) {
+            Result result = variant.run(text, chunk, expected);
+            if (!result.ok) {
+                std::cerr << variant.name << ": predictions differ from the source" << std::endl;
+                return 1;
+            }
+            if (rep == 0 || result.ms < best.ms) {
+                best = result;
+            }
+        }
+        std::cout << variant.name << ": " << best.ms << " ms, " << text_mb / (best.ms / 1000.0) << " MB/s, peak heap +"
+                  << static_cast<double>(best.peak_bytes) / (1024.0 * 1024.0) << " MB" << std::endl;
+    }
+    return 0;
+}
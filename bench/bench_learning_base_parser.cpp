@@ -0,0 +1,103 @@
+// Пропускная способность LearningBaseParser (MB/s) на синтетической базе.
+// Использование: bench_learning_base_parser [size_mb=256] [threads=0]
+#include "learning_base_parser.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace fs = std::filesystem;
+
+static LearningBaseConfig makeConfig(int num_samples) {
+    LearningBaseConfig config;
+    config.name = "BenchBase";
+    config.num_samples = num_samples;
+    config.num_targets_y = 2;
+    config.y_precision = {0.01, 0.05};
+    config.num_features_x = 3;
+    config.x_lengths = {1024, 512, 256};
+    return config;
+}
+
+static void writeSyntheticBase(const std::string& path, const LearningBaseConfig& config) {
+    std::ofstream file(path, std::ios::binary);
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    char number[32];
+
+    file << "Synthetic learning base\n";
+    file << "array of records with " << config.num_samples << " records\n";
+    for (int s = 0; s < config.num_samples; ++s) {
+        file << kLearningBaseRecordMarker << "\n";
+        file << "nY=" << config.num_targets_y << "\n";
+        for (int i = 0; i < config.num_targets_y; ++i) {
+            file << "Y" << (i + 1) << "=" << dist(rng) << "\n";
+        }
+        file << "nX=" << config.num_features_x << "\n";
+        for (int c = 0; c < config.num_features_x; ++c) {
+            file << "array of X[" << c << "] with " << config.x_lengths[c] << " values\n";
+            for (int i = 0; i < config.x_lengths[c]; ++i) {
+                int len = std::snprintf(number, sizeof(number), "%.6e", dist(rng));
+                file.write(number, len);
+                file.put((i % 16 == 15) ? '\n' : ' ');
+            }
+            file.put('\n');
+        }
+    }
+}
+
+static double runOnce(const std::string& path, const LearningBaseConfig& config, unsigned threads) {
+    LearningBaseParser parser(threads);
+    LearningBaseData data;
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = parser.parse(path, config, data);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!ok) {
+        std::cerr << "Parse failed: " << parser.lastError() << std::endl;
+        return -1.0;
+    }
+    return elapsed;
+}
+
+int main(int argc, char** argv) {
+    size_t size_mb = argc > 1 ? std::stoul(argv[1]) : 256;
+    unsigned threads = argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 0;
+
+    // ~14 байт на значение в формате %.6e
+    const size_t bytes_per_sample = (1024 + 512 + 256) * 14 + 200;
+    int num_samples = static_cast<int>(size_mb * 1024 * 1024 / bytes_per_sample) + 1;
+    LearningBaseConfig config = makeConfig(num_samples);
+
+    std::string path = (fs::temp_directory_path() / "ressys_bench_base.txt").string();
+    writeSyntheticBase(path, config);
+    double file_mb = static_cast<double>(fs::file_size(path)) / (1024.0 * 1024.0);
+    std::cout << "File: " << path << " (" << file_mb << " MB, " << num_samples << " records)" << std::endl;
+
+    runOnce(path, config, threads); // прогрев кэша страниц
+
+    unsigned parallel = LearningBaseParser(threads).numThreads();
+    for (unsigned t : {1u, parallel}) {
+        double best = -1.0;
+        for (int rep = 0; rep < 3; ++rep) {
+            double elapsed = runOnce(path, config, t);
+            if (elapsed > 0 && (best < 0 || elapsed < best)) {
+                best = elapsed;
+            }
+        }
+        if (best > 0) {
+            std::cout << "threads=" << t << ": " << best * 1000.0 << " ms, "
+                      << file_mb / best << " MB/s" << std::endl;
+        }
+        if (parallel == 1) {
+            break;
+        }
+    }
+
+    fs::remove(path);
+    return 0;
+}
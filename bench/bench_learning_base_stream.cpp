@@ -0,0 +1,170 @@
+// Потоковая конвертация базы в .rslb на синтетическом файле произвольного размера:
+// скорость, пиковая память процесса и выборочная сверка записей с генератором.
+// Для проверки ограниченной памяти size_mb задаётся больше объёма RAM.
+// Использование: bench_learning_base_stream [size_mb=1024] [chunk_mb=8] [threads=0] [dir=temp]
+#include "learning_base_binary.h"
+#include "learning_base_stream.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static const int kPoolSize = 4096;
+
+static LearningBaseConfig makeConfig(int num_samples) {
+    LearningBaseConfig config;
+    config.name = "StreamBench";
+    config.num_samples = num_samples;
+    config.num_targets_y = 2;
+    config.y_precision = {0.01, 0.05};
+    config.num_features_x = 3;
+    config.x_lengths = {1024, 512, 256};
+    return config;
+}
+
+// Значение (запись, канал, позиция) выбирается из готового пула строк, чтобы
+// генерация гигабайт не упиралась в snprintf и чтобы его можно было сверить
+static uint32_t pick(uint64_t sample, uint32_t channel, uint32_t index) {
+    uint64_t h = sample * 0x9E3779B97F4A7C15ull ^ (static_cast<uint64_t>(channel) << 40) ^ index;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return static_cast<uint32_t>(h % kPoolSize);
+}
+
+static size_t peakRssBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+static void writeSyntheticBase(const std::string& path, const LearningBaseConfig& config,
+                               const std::vector<std::string>& pool) {
+    std::ofstream file(path, std::ios::binary);
+    std::string block;
+    block.reserve(1 << 20);
+
+    file << "Synthetic learning base\n";
+    file << "array of records with " << config.num_samples << " records\n";
+    for (int s = 0; s < config.num_samples; ++s) {
+        block += kLearningBaseRecordMarker;
+        block += "\nnY=" + std::to_string(config.num_targets_y) + "\n";
+        for (int i = 0; i < config.num_targets_y; ++i) {
+            block += "Y" + std::to_string(i + 1) + "=" + pool[pick(s, 100 + i, 0)] + "\n";
+        }
+        block += "nX=" + std::to_string(config.num_features_x) + "\n";
+        for (int c = 0; c < config.num_features_x; ++c) {
+            block += "array of X[" + std::to_string(c) + "] with " + std::to_string(config.x_lengths[c]) + " values\n";
+            for (int i = 0; i < config.x_lengths[c]; ++i) {
+                block += pool[pick(s, c, i)];
+                block += (i % 16 == 15) ? '\n' : ' ';
+            }
+            block += '\n';
+        }
+        if (block.size() >= (1 << 20)) {
+            file.write(block.data(), static_cast<std::streamsize>(block.size()));
+            block.clear();
+        }
+    }
+    file.write(block.data(), static_cast<std::streamsize>(block.size()));
+}
+
+static bool verifySample(const LearningBaseBinary& binary, const LearningBaseConfig& config,
+                         const std::vector<float>& values, int sample) {
+    for (int i = 0; i < config.num_targets_y; ++i) {
+        if (binary.sampleY(sample)[i] != values[pick(sample, 100 + i, 0)]) {
+            return false;
+        }
+    }
+    for (int c = 0; c < config.num_features_x; ++c) {
+        const float* x = binary.sampleX(c, sample);
+        for (int i = 0; i < config.x_lengths[c]; ++i) {
+            if (x[i] != values[pick(sample, c, i)]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t size_mb = argc > 1 ? std::stoul(argv[1]) : 1024;
+    size_t chunk_mb = argc > 2 ? std::stoul(argv[2]) : 8;
+    unsigned threads = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 0;
+    fs::path dir = argc > 4 ? fs::path(argv[4]) : fs::temp_directory_path();
+
+    std::vector<std::string> pool(kPoolSize);
+    std::vector<float> values(kPoolSize);
+    char number[32];
+    for (int i = 0; i < kPoolSize; ++i) {
+        float value = static_cast<float>(i - kPoolSize / 2) / 977.0f;
+        pool[i].assign(number, std::snprintf(number, sizeof(number), "%.6e", value));
+        values[i] = std::strtof(pool[i].c_str(), nullptr);
+    }
+
+    // ~14 байт на значение в формате %.6e
+    const size_t bytes_per_sample = (1024 + 512 + 256) * 14 + 200;
+    int num_samples = static_cast<int>(size_mb * 1024 * 1024 / bytes_per_sample) + 1;
+    LearningBaseConfig config = makeConfig(num_samples);
+
+    std::string text_path = (dir / "ressys_stream_base.txt").string();
+    std::string binary_path = (dir / "ressys_stream_base.rslb").string();
+    writeSyntheticBase(text_path, config, pool);
+    double file_mb = static_cast<double>(fs::file_size(text_path)) / (1024.0 * 1024.0);
+    std::cout << "File: " << text_path << " (" << file_mb << " MB, " << num_samples << " records)" << std::endl;
+
+    size_t rss_before = peakRssBytes();
+    LearningBaseStreamConverter converter(chunk_mb << 20, threads);
+    LearningBaseStreamStats stats;
+    bool ok = converter.convert(text_path, config, binary_path, &stats);
+    size_t rss_after = peakRssBytes();
+    fs::remove(text_path);
+
+    if (!ok) {
+        std::cerr << "Conversion failed: " << converter.lastError() << std::endl;
+        return 1;
+    }
+    std::cout << "threads=" << converter.numThreads() << ", chunk=" << chunk_mb << " MB: " << stats.elapsed_ms
+              << " ms, " << file_mb / (stats.elapsed_ms / 1000.0) << " MB/s" << std::endl;
+    std::cout << "Converter buffers: " << stats.peak_buffer_bytes / (1024.0 * 1024.0) << " MB, peak RSS "
+              << rss_before / (1024.0 * 1024.0) << " -> " << rss_after / (1024.0 * 1024.0) << " MB" << std::endl;
+
+    LearningBaseBinary binary;
+    if (!binary.open(binary_path)) {
+        std::cerr << binary.lastError() << std::endl;
+        return 1;
+    }
+    int checked = 0, failed = 0;
+    for (int s = 0; s < num_samples; s += std::max(1, num_samples / 1000)) {
+        ++checked;
+        failed += verifySample(binary, config, values, s) ? 0 : 1;
+    }
+    failed += verifySample(binary, config, values, num_samples - 1) ? 0 : 1;
+    binary.close();
+    fs::remove(binary_path);
+
+    std::cout << "Verified " << checked + 1 << " records, mismatches: " << failed << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+// Пропускная способность Logger (сообщений/с) при записи из нескольких потоков.
+// Использование: bench_logger [threads=4] [messages_per_thread=200000]
+#include "logger.h"
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+template <typename Fn>
+static double measure(int threads, int messages, Fn fn) {
+    auto start = Clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < messages; ++i) {
+                fn(t, i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return threads * static_cast<double>(messages) / seconds;
+}
+
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? std::stoi(argv[1]) : 4;
+    int messages = argc > 2 ? std::stoi(argv[2]) : 200000;
+    std::string path = (fs::temp_directory_path() / "ressys_bench_logger.txt").string();
+
+    {
+        Logger logger(path, false);
+        double rate = measure(threads, messages, [&](int t, int i) {
+            logger.info("worker " + std::to_string(t) + " message " + std::to_string(i));
+        });
+        std::cout << "enqueue info: " << static_cast<long long>(rate) << " msg/s" << std::endl;
+
+        auto start = Clock::now();
+        logger.flush();
+        std::cout << "drain after burst: "
+                  << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << std::endl;
+
+        logger.setLevel(Logger::Level::Info);
+        rate = measure(threads, messages, [&](int t, int i) {
+            if (logger.isEnabled(Logger::Level::Debug)) {
+                logger.debug("worker " + std::to_string(t) + " message " + std::to_string(i));
+            }
+        });
+        std::cout << "filtered debug: " << static_cast<long long>(rate) << " msg/s" << std::endl;
+    }
+
+    std::cout << "log size: " << fs::file_size(path) / 1024 << " KB" << std::endl;
+    fs::remove(path);
+    return 0;
+}
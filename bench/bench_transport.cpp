@@ -0,0 +1,62 @@
+// Задержка мелких запросов (/health) через loopback TCP и через Unix domain socket.
+// Сервер должен слушать оба адреса, например два экземпляра:
+//   python main.py --port 8000   и   python main.py --uds /tmp/ressys.sock
+// Использование: bench_transport <socket_path> [host=localhost] [port=8000] [requests=2000]
+#include "curl_handle_pool.h"
+#include "http_client.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static void report(const std::string& name, HttpClient& client, int requests) {
+    client.healthCheck(); // keep-alive соединение устанавливается до замера
+
+    std::vector<double> latencies_us;
+    latencies_us.reserve(requests);
+    int failures = 0;
+
+    for (int i = 0; i < requests; ++i) {
+        auto start = Clock::now();
+        if (!client.healthCheck()) {
+            ++failures;
+        }
+        latencies_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    double total = 0.0;
+    for (double v : latencies_us) {
+        total += v;
+    }
+    auto percentile = [&](double p) {
+        return latencies_us[std::min(latencies_us.size() - 1, static_cast<size_t>(p * latencies_us.size()))];
+    };
+
+    std::cout << name << ": mean " << total / requests << " us, p50 " << percentile(0.50)
+              << " us, p99 " << percentile(0.99) << " us, failures " << failures << std::endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: bench_transport <socket_path> [host=localhost] [port=8000] [requests=2000]" << std::endl;
+        return 1;
+    }
+    std::string socket_path = argv[1];
+    std::string host = argc > 2 ? argv[2] : "localhost";
+    int port = argc > 3 ? std::stoi(argv[3]) : 8000;
+    int requests = argc > 4 ? std::stoi(argv[4]) : 2000;
+
+    CurlHandlePool::instance();
+
+    HttpClient tcp_client(host, port, 5000);
+    report("tcp  " + host + ":" + std::to_string(port), tcp_client, requests);
+
+    HttpClient unix_client(host, port, 5000);
+    unix_client.setUnixSocketPath(socket_path);
+    report("unix " + socket_path, unix_client, requests);
+    return 0;
+}
@@ -7,9 +7,35 @@
 #include <vector>
 #include <sstream>
 #include <algorithm>
+#include <iomanip>
+#include <cstring>
 #include "http_client.h"
+#include "http_metrics.h"
 #include "config_loader.h"
 #include "logger.h"
+#include "learning_base_binary.h"
+#include "learning_base_config.h"
+#include "learning_base_parser.h"
+#include "learning_base_split.h"
+#include "learning_base_stream.h"
+#include "batch_runner.h"
+#include "native_regression.h"
+#include "nmr_inference.h"
+#include "prediction_output.h"
+#include "process_supervisor.h"
+#include "prediction_cache.h"
+#include "prediction_payload.h"
+#include "server_daemon.h"
+#include "shared_tensor_ring.h"
+#ifdef RESSYS_EMBED_PYTHON
+#include "embedded_python.h"
+#endif
+#include "sharded_predictor.h"
+#include "trace_recorder.h"
+#include "training_jobs.h"
+#include <map>
+#include <memory>
+#include <json/json.h>
 #include <windows.h>
 
 namespace fs = std::filesystem;
@@ -27,13 +53,73 @@ private:
     ConfigLoader config_;
     HttpClient http_client_;
     
-    std::thread server_thread_;
-    bool server_running_ = false;
+    ProcessSupervisor server_process_;
+    int server_startup_timeout_ms_ = 30000;
+    std::string server_socket_path_; // не пусто - сервер слушает Unix domain socket
+    
+    // workers > 1: дополнительные процессы сервера, воркер i слушает порт server_port_ + i (или socket_path.i);
+    // воркер 0 - это server_process_ / http_client_
+    int server_port_ = 8000; // [server] port
+    int server_workers_ = 1;
+    
+    // [server] daemon = true: сервер переживает сессию и переиспользуется следующими запусками
+    bool daemon_mode_ = false;
+    int daemon_idle_timeout_s_ = 1800;
+    
+    // [training]: разбиение базы на train/test (и фолды), которое сервер читает из .rssplit
+    uint64_t split_seed_ = 42;
+    int train_percent_ = 85;
+    int split_folds_ = 0;
+    bool daemon_attached_ = false; // сервер - демон (свой или от прошлой сессии), на выходе не останавливается
+    long daemon_pid_ = 0;
+    std::vector<std::unique_ptr<ProcessSupervisor>> worker_processes_;
+    std::vector<std::unique_ptr<HttpClient>> worker_clients_;
+    
+    TrainingJobTable training_jobs_;
     
     std::string python_path_;
     std::string server_script_;
     std::string output_file_;
     std::string learning_base_dir_;
+    std::string models_dir_;
+    std::string output_dir_;
+    bool native_inference_ = true;
+    bool binary_predict_ = true; // X/Y разбираются в клиенте и уходят на сервер как float32
+    bool inline_predictions_ = true; // предсказания в ответе /predict/binary, файл результатов пишет клиент
+    std::unique_ptr<SharedTensorRing> shm_ring_; // predict_mode = shm: тензоры через общую память
+#ifdef RESSYS_EMBED_PYTHON
+    std::unique_ptr<EmbeddedPython> embedded_python_; // [python] embedded = true: ml.* прямо в процессе клиента
+#endif
+    
+    std::unique_ptr<PredictionCache> prediction_cache_;
+    std::unique_ptr<HttpMetricsExporter> metrics_exporter_; // [metrics] dump_interval_s > 0
+    
+    // Версия файла модели на диске: загруженная модель устаревает, когда файл переписан
+    // (обучение в этой или другой сессии, замена вручную)
+    struct ModelFileVersion {
+        fs::file_time_type write_time;
+        uintmax_t size = 0;
+        
+        bool operator==(const ModelFileVersion& other) const {
+            return write_time == other.write_time && size == other.size;
+        }
+    };
+    
+    // Загруженные нативные модели: путь к .rsw -> движок и версия файла, с которой он загружен
+    struct NativeEngineEntry {
+        std::unique_ptr<NmrInferenceEngine> engine;
+        ModelFileVersion version;
+    };
+    std::map<std::string, NativeEngineEntry> native_engines_;
+    
+    // linear_regression и svr обучаются и считаются в клиенте: путь к .rsm -> модель
+    struct NativeModelEntry {
+        std::unique_ptr<NativeRegressor> model;
+        ModelFileVersion version;
+    };
+    std::map<std::string, NativeModelEntry> native_models_;
+    RidgeOptions ridge_options_;
+    SvrOptions svr_options_;
 
     std::vector<std::string> findLearningBases() {
         std::vector<std::string> bases;
@@ -53,10 +139,44 @@ private:
         return bases;
     }
 
+    // Строка списка баз: имя, число записей и статистика каналов из Configs (без чтения самой базы)
+    void printLearningBaseSummary(const std::string& base_name) {
+        LearningBaseConfig config;
+        std::string error;
+        if (!loadLearningBaseConfig(getLearningBaseConfigPath(base_name), config, error)) {
+            std::cout << base_name << std::endl;
+            return;
+        }
+        std::cout << base_name << " (" << config.num_samples << " records)" << std::endl;
+        if (!config.hasStats()) {
+            return;
+        }
+        
+        auto printStats = [](const std::string& label, double mean, double stddev, double min, double max) {
+            std::cout << "     " << label << ": mean " << mean << ", std " << stddev
+                      << ", range [" << min << ", " << max << "]" << std::endl;
+        };
+        for (int c = 0; c < config.num_features_x; ++c) {
+            printStats("X[" + std::to_string(c) + "] (" + std::to_string(config.x_lengths[c]) + " values)",
+                       config.x_mean[c], config.x_std[c], config.x_min[c], config.x_max[c]);
+        }
+        for (int i = 0; i < config.num_targets_y; ++i) {
+            printStats("Y" + std::to_string(i + 1), config.y_mean[i], config.y_std[i], config.y_min[i], config.y_max[i]);
+        }
+    }
+
     std::string getLearningBasePath(const std::string& base_name) {
         return learning_base_dir_ + "\\" + base_name + ".txt";
     }
 
+    std::string getLearningBaseBinaryPath(const std::string& base_name) {
+        return learning_base_dir_ + "\\" + base_name + ".rslb";
+    }
+
+    std::string getLearningBaseSplitPath(const std::string& base_name) {
+        return learning_base_dir_ + "\\" + base_name + ".rssplit";
+    }
+
     std::string getLearningBaseConfigPath(const std::string& base_name) {
         return learning_base_dir_ + "\\Configs\\" + base_name + ".txt";
     }
@@ -66,18 +186,127 @@ public:
     MLApplication()
     : logger_(false),
       config_(getExePath() + "\\app_config.ini"),  //full path to config 
-      http_client_("localhost", 8000, 5000, &logger_)
+      http_client_("localhost", 8000, 5000, &logger_),
+      server_process_(&logger_),
+      training_jobs_(http_client_, logger_)
       
     {
         std::string exeDir = getExePath();
         logger_.info("EXE directory: " + exeDir);
+        
+        training_jobs_.setFinishedHandler([](const TrainingJobStatus& job) {
+            std::cout << "\n[Training job " << job.id << " " << job.state << "] " << job.message << std::endl;
+        });
 
         if (config_.load()) {
+            logger_.setLevel(Logger::parseLevel(config_.getString("logging", "level", "debug")));
+            
             python_path_ = exeDir + "\\" + config_.getString("paths", "python_path");
             server_script_ = exeDir + "\\" + config_.getString("paths", "server_script");
             output_file_ = exeDir + "\\" + config_.getString("paths", "output_file");
             
             learning_base_dir_ = config_.getAppDataPath() + "\\data\\LearningBase";
+            models_dir_ = config_.getAppDataPath() + "\\models";
+            output_dir_ = config_.getAppDataPath() + "\\data\\Output";
+            native_inference_ = config_.getString("inference", "engine", "native") == "native";
+            std::string predict_mode = config_.getString("server", "predict_mode", "binary");
+            binary_predict_ = predict_mode == "binary" || predict_mode == "shm"; // shm откатывается на binary
+            inline_predictions_ = config_.getString("server", "inline_predictions", "true") == "true";
+            if (predict_mode == "shm") {
+                shm_ring_ = std::make_unique<SharedTensorRing>(&logger_);
+                size_t slot_bytes = static_cast<size_t>(config_.getInt("shm", "slot_size_mb", 64)) << 20;
+                if (!shm_ring_->create(SharedTensorRing::defaultName(), config_.getInt("shm", "slots", 4), slot_bytes)) {
+                    logger_.warning("Shared memory transport disabled: " + shm_ring_->lastError());
+                    shm_ring_.reset();
+                }
+            }
+            
+            server_port_ = config_.getInt("server", "port", 8000);
+            http_client_.setPort(server_port_);
+            configureRequestPolicies(http_client_);
+            http_client_.setMaxConcurrency(config_.getInt("server", "max_concurrency", 4));
+            if (config_.getString("server", "transport", "tcp") == "unix") {
+#ifdef _WIN32
+                // asyncio в CPython под Windows не умеет AF_UNIX-сервер: uvicorn --uds не поднялся бы,
+                // и клиент ждал бы его до startup_timeout_ms
+                logger_.warning("Server transport unix is not supported on Windows, using tcp");
+#else
+                server_socket_path_ = config_.getString("server", "socket_path");
+                if (server_socket_path_.empty()) {
+                    server_socket_path_ = config_.getAppDataPath() + "/ressys.sock";
+                }
+                http_client_.setUnixSocketPath(server_socket_path_);
+                logger_.info("Server transport: unix socket " + server_socket_path_);
+#endif
+            }
+            server_startup_timeout_ms_ = config_.getInt("server", "startup_timeout_ms", 30000);
+#ifdef RESSYS_EMBED_PYTHON
+            if (config_.getString("python", "embedded", "true") == "true") {
+                embedded_python_ = std::make_unique<EmbeddedPython>(logger_);
+            }
+#endif
+            
+            server_workers_ = std::max(1, config_.getInt("server", "workers", 1));
+            for (int i = 1; i < server_workers_; ++i) {
+                auto client = std::make_unique<HttpClient>("localhost", server_port_ + i, 5000, &logger_);
+                configureRequestPolicies(*client);
+                client->setMaxConcurrency(config_.getInt("server", "max_concurrency", 4));
+                if (!server_socket_path_.empty()) {
+                    client->setUnixSocketPath(workerSocketPath(i));
+                }
+                worker_clients_.push_back(std::move(client));
+                worker_processes_.push_back(std::make_unique<ProcessSupervisor>(&logger_));
+            }
+            
+            daemon_mode_ = config_.getString("server", "daemon", "false") == "true";
+            daemon_idle_timeout_s_ = config_.getInt("server", "idle_timeout_s", 1800);
+            if (daemon_mode_ && server_workers_ > 1) {
+                logger_.warning("Server daemon mode is not used with workers > 1");
+                daemon_mode_ = false;
+            }
+            
+            split_seed_ = static_cast<uint64_t>(config_.getInt("training", "split_seed", 42));
+            train_percent_ = config_.getInt("training", "train_percent", 85);
+            split_folds_ = std::max(0, config_.getInt("training", "folds", 0));
+            ridge_options_.lambda = config_.getDouble("training", "ridge_lambda", 1.0);
+            svr_options_.kernel = config_.getString("training", "svr_kernel", "rbf") == "linear" ? SvrKernel::Linear
+                                                                                                  : SvrKernel::Rbf;
+            svr_options_.c = config_.getDouble("training", "svr_c", 1.0);
+            svr_options_.epsilon = config_.getDouble("training", "svr_epsilon", 0.1);
+            svr_options_.gamma = config_.getDouble("training", "svr_gamma", 0.0);
+            svr_options_.max_samples = static_cast<size_t>(std::max(1, config_.getInt("training", "svr_max_samples", 4000)));
+            svr_options_.cache_mb = static_cast<size_t>(std::max(1, config_.getInt("training", "kernel_cache_mb", 256)));
+            
+            if (config_.getString("tracing", "enabled", "true") == "true") {
+                // Трассировка сессии рядом с её логом: session_N.txt -> session_N.trace.json
+                std::string trace_path = fs::path(logger_.getLogFilePath()).replace_extension(".trace.json").string();
+                std::string error;
+                if (TraceRecorder::instance().open(trace_path, error)) {
+                    logger_.info("Session trace: " + trace_path);
+                } else {
+                    logger_.warning("Tracing disabled: " + error);
+                }
+            }
+            
+            int metrics_interval_s = config_.getInt("metrics", "dump_interval_s", 15);
+            if (metrics_interval_s > 0) {
+                std::string metrics_file = config_.getString("metrics", "file");
+                if (metrics_file.empty()) {
+                    metrics_file = config_.getAppDataPath() + "\\metrics\\ressys_client.prom";
+                }
+                metrics_exporter_ = std::make_unique<HttpMetricsExporter>(
+                    metrics_file, std::chrono::seconds(metrics_interval_s), &logger_);
+                logger_.info("HTTP metrics file: " + metrics_file);
+            }
+            
+            if (config_.getString("cache", "enabled", "true") == "true") {
+                uint64_t max_bytes = static_cast<uint64_t>(config_.getInt("cache", "max_size_mb", 256)) << 20;
+                prediction_cache_ = std::make_unique<PredictionCache>(
+                    config_.getAppDataPath() + "\\cache\\predictions", max_bytes, &logger_);
+                if (!prediction_cache_->open()) {
+                    prediction_cache_.reset();
+                }
+            }
             
             logger_.info("Python path: " + python_path_);
             logger_.info("Server script: " + server_script_);
@@ -88,95 +317,308 @@ public:
         }
     }
 
+    RequestPolicy readRequestPolicy(const std::string& section, const RequestPolicy& defaults) {
+        RequestPolicy policy = defaults;
+        policy.timeout_ms = config_.getInt(section, "timeout_ms", static_cast<int>(defaults.timeout_ms));
+        policy.attempt_timeout_ms = config_.getInt(section, "attempt_timeout_ms",
+                                                   static_cast<int>(defaults.attempt_timeout_ms));
+        policy.max_attempts = std::max(1, config_.getInt(section, "max_attempts", defaults.max_attempts));
+        policy.backoff_ms = config_.getInt(section, "backoff_ms", static_cast<int>(defaults.backoff_ms));
+        policy.backoff_max_ms = config_.getInt(section, "backoff_max_ms", static_cast<int>(defaults.backoff_max_ms));
+        policy.hedge_after_ms = config_.getInt(section, "hedge_after_ms", static_cast<int>(defaults.hedge_after_ms));
+        policy.idempotent = config_.getString(section, "idempotent", defaults.idempotent ? "true" : "false") == "true";
+        return policy;
+    }
+    
+    // [server] timeout_ms и др. - политика по умолчанию, [request <endpoint>] - по endpoint-ам;
+    // дубли идемпотентных запросов уходят на другие запущенные воркеры
+    void configureRequestPolicies(HttpClient& client) {
+        RequestPolicy defaults = readRequestPolicy("server", RequestPolicy());
+        client.setDefaultPolicy(defaults);
+        const std::string prefix = "request ";
+        for (const auto& section : config_.sections(prefix)) {
+            client.setEndpointPolicy(section.substr(prefix.size()), readRequestPolicy(section, defaults));
+        }
+        client.setHedgePeers([this]() { return runningWorkers(); });
+    }
+    
+    std::string workerSocketPath(int worker) {
+        return worker == 0 ? server_socket_path_ : server_socket_path_ + "." + std::to_string(worker);
+    }
+    
+    ProcessSupervisor& workerProcess(int worker) {
+        return worker == 0 ? server_process_ : *worker_processes_[worker - 1];
+    }
+    
+    HttpClient& workerClient(int worker) {
+        return worker == 0 ? http_client_ : *worker_clients_[worker - 1];
+    }
+    
+    // Воркеры, которым можно отправлять предсказания; основной клиент есть всегда
+    // (сервер мог быть запущен и не нами)
+    std::vector<HttpClient*> runningWorkers() {
+        std::vector<HttpClient*> workers = {&http_client_};
+        for (int i = 1; i < server_workers_; ++i) {
+            if (workerProcess(i).isRunning()) {
+                workers.push_back(&workerClient(i));
+            }
+        }
+        return workers;
+    }
+    
     void startServer() {
+#ifdef RESSYS_EMBED_PYTHON
+        if (embedded_python_) {
+            startEmbeddedPython();
+            return;
+        }
+#endif
+        startServerProcess();
+    }
+    
+#ifdef RESSYS_EMBED_PYTHON
+    void startEmbeddedPython() {
+        if (embedded_python_->isRunning()) {
+            std::cout << "Embedded Python is already running" << std::endl;
+            return;
+        }
+        std::cout << "Starting embedded Python..." << std::endl;
+        if (embedded_python_->start(fs::path(server_script_).parent_path().string(),
+                                    fs::path(python_path_).parent_path().string())) {
+            std::cout << "✓ Embedded Python ready!" << std::endl;
+        } else {
+            std::cerr << "✗ Embedded Python failed to start!" << std::endl;
+            logger_.error(embedded_python_->lastError());
+        }
+    }
+    
+    bool embeddedPythonRunning() const {
+        return embedded_python_ && embedded_python_->isRunning();
+    }
+#endif
+    
+    bool serverRunning() const {
+        return server_process_.isRunning() || daemon_attached_;
+    }
+    
+    std::string daemonLockPath() {
+        return config_.getAppDataPath() + "\\server.lock";
+    }
+    
+    // Демон прошлой сессии уже держит torch в памяти: подключение за миллисекунды вместо холодного старта
+    bool attachToDaemon() {
+        auto started_at = std::chrono::steady_clock::now();
+        ServerLockInfo lock;
+        std::string error;
+        if (!readServerLock(daemonLockPath(), lock, error)) {
+            logger_.debug(error);
+            return false;
+        }
+        if (!verifyServerDaemon(http_client_, lock, server_port_, server_socket_path_, error)) {
+            logger_.info("Server daemon not reused: " + error);
+            if (lock.version != kServerVersion && ProcessSupervisor::isProcessAlive(lock.pid)) {
+                retireDaemon(lock.pid); // старая версия держит адрес - освобождаем его для новой
+            }
+            return false;
+        }
+        
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started_at).count();
+        daemon_attached_ = true;
+        daemon_pid_ = lock.pid;
+        std::cout << "✓ Connected to running server (pid " << lock.pid << ")" << std::endl;
+        logger_.info("Attached to server daemon pid " + std::to_string(lock.pid) + " started " + lock.started +
+                     " in " + std::to_string(elapsed_ms) + " ms");
+        return true;
+    }
+    
+    // Мягкая остановка демона через /shutdown и ожидание выхода его процесса
+    void retireDaemon(long pid) {
+        logger_.info("Stopping server daemon pid " + std::to_string(pid));
+        HttpClient temp_client("localhost", server_port_, 1000);
+        temp_client.setUnixSocketPath(server_socket_path_);
+        temp_client.post("/shutdown", "");
+        
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (ProcessSupervisor::isProcessAlive(pid) && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        if (ProcessSupervisor::isProcessAlive(pid)) {
+            logger_.warning("Server daemon pid " + std::to_string(pid) + " did not exit in time");
+        }
+    }
+    
+    void startServerProcess() {
+        if (serverRunning()) {
+            long pid = daemon_attached_ ? daemon_pid_ : server_process_.pid();
+            std::cout << "Server is already running (pid " << pid << ")" << std::endl;
+            return;
+        }
+        if (daemon_mode_ && attachToDaemon()) {
+            return;
+        }
         if (!fs::exists(python_path_) || !fs::exists(server_script_)) {
             logger_.error("Python server files not found!");
             return;
         }
         
-        server_running_ = true;
-        server_thread_ = std::thread([this]() {
-            std::string log_path = logger_.getLogFilePath();
-            size_t last_dot = log_path.find_last_of('.');
-            std::string python_log_path = log_path.substr(0, last_dot) + "_PyServer.txt";
-
-            std::string command = "cd /d \"" + 
-                         fs::path(server_script_).parent_path().string() + 
-                         "\" && \"" + python_path_ + "\" \"" + server_script_ + "\""+
-                         ">> \"" + python_log_path + "\" 2>&1";  // ПЕРЕНАПРАВЛЯЕМ ВСЕ В отдельный ЛОГ-файл
-            
-                         logger_.debug("Executing server command: " + command);
-            logger_.info("Python server logs will be saved to: " + python_log_path);
-            std::system(command.c_str());
-        });
+        std::string log_path = logger_.getLogFilePath();
+        size_t last_dot = log_path.find_last_of('.');
+        
+        // Несколько процессов делят ядра, иначе torch в каждом возьмёт все и они будут мешать друг другу
+        unsigned threads = server_workers_ > 1
+            ? std::max(1u, std::thread::hardware_concurrency() / static_cast<unsigned>(server_workers_)) : 0;
         
         std::cout << "Starting Python server..." << std::endl;
-        std::this_thread::sleep_for(std::chrono::seconds(3));
+        auto started_at = std::chrono::steady_clock::now();
         
-        if (waitForServer(10)) {
-            std::cout << "✓ Server started successfully!" << std::endl;
-            logger_.info("Python server started successfully on localhost:8000");
-        } else {
+        // Сначала запускаем все процессы, потом ждём готовности: импорт torch идёт параллельно
+        for (int i = 0; i < server_workers_; ++i) {
+            ProcessOptions options;
+            options.executable = python_path_;
+            options.args = {"-u", server_script_}; // -u: без буферизации, лог сервера пишется сразу
+            if (!server_socket_path_.empty()) {
+                options.args.insert(options.args.end(), {"--uds", workerSocketPath(i)});
+            } else {
+                options.args.insert(options.args.end(), {"--port", std::to_string(server_port_ + i)});
+            }
+            if (threads > 0) {
+                options.args.insert(options.args.end(), {"--threads", std::to_string(threads)});
+            }
+            options.working_dir = fs::path(server_script_).parent_path().string();
+            // ПЕРЕНАПРАВЛЯЕМ ВСЕ В отдельный ЛОГ-файл (у каждого воркера свой)
+            options.log_path = log_path.substr(0, last_dot) + "_PyServer" + (i > 0 ? std::to_string(i) : "") + ".txt";
+            if (i == 0 && daemon_mode_) {
+                // Демон живёт дольше сессии: свой лог в AppData, файл блокировки, выход по простою
+                options.args.insert(options.args.end(), {"--daemon", "--lock-file", daemonLockPath(),
+                                                         "--idle-timeout", std::to_string(daemon_idle_timeout_s_)});
+                options.log_path = config_.getAppDataPath() + "\\server_daemon.log";
+                options.detached = true;
+                options.restart_on_crash = false;
+            }
+            logger_.info("Python server logs will be saved to: " + options.log_path);
+            
+            if (workerProcess(i).start(options)) {
+                continue;
+            }
+            if (i == 0) {
+                std::cerr << "✗ Server failed to start!" << std::endl;
+                logger_.error("Failed to launch Python server process");
+                return;
+            }
+            logger_.warning("Failed to launch Python server worker " + std::to_string(i));
+        }
+        
+        // Вместо фиксированных пауз опрашиваем /health с нарастающим интервалом
+        bool ready = server_process_.waitUntilReady([this]() { return http_client_.healthCheck(); },
+                                                    std::chrono::milliseconds(server_startup_timeout_ms_));
+        if (!ready) {
             std::cerr << "✗ Server failed to start!" << std::endl;
-            logger_.error("Python server failed to start");
-            server_running_ = false;
+            logger_.error("Python server failed to start (exit code " +
+                          std::to_string(server_process_.lastExitCode()) + ")");
+            for (int i = server_workers_ - 1; i >= 0; --i) {
+                workerProcess(i).stop(std::chrono::seconds(2));
+            }
+            return;
         }
-    }
-    
-    bool waitForServer(int max_attempts) {
-        for (int i = 0; i < max_attempts; ++i) {
-            if (http_client_.healthCheck()) {
-                logger_.info("Server health check passed");
-                return true;
+        
+        int workers_ready = 1;
+        for (int i = 1; i < server_workers_; ++i) {
+            ProcessSupervisor& process = workerProcess(i);
+            if (!process.isRunning()) {
+                continue;
+            }
+            HttpClient& client = workerClient(i);
+            if (process.waitUntilReady([&client]() { return client.healthCheck(); },
+                                       std::chrono::milliseconds(server_startup_timeout_ms_))) {
+                ++workers_ready;
+            } else {
+                // Без этого воркера шардов просто станет меньше
+                logger_.warning("Python server worker " + std::to_string(i) + " failed to start (exit code " +
+                                std::to_string(process.lastExitCode()) + ")");
+                process.stop(std::chrono::seconds(2));
+            }
+        }
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started_at).count();
+        
+        std::cout << "✓ Server started successfully!" << std::endl;
+        std::string endpoint = server_socket_path_.empty() ? "localhost:" + std::to_string(server_port_) : server_socket_path_;
+        logger_.info("Python server started on " + endpoint + " in " + std::to_string(elapsed_ms) +
+                     " ms (pid " + std::to_string(server_process_.pid()) + ", workers " +
+                     std::to_string(workers_ready) + "/" + std::to_string(server_workers_) + ")");
+        
+        if (daemon_mode_) {
+            long pid = server_process_.pid();
+            if (server_process_.detach()) {
+                daemon_attached_ = true;
+                daemon_pid_ = pid;
+                logger_.info("Server runs as daemon, idle timeout " + std::to_string(daemon_idle_timeout_s_) + " s");
             }
-
-            std::cout << "Waiting for server... (" << i+1 << "/" << max_attempts << ")" << std::endl;
-            logger_.debug("Waiting for server... Attempt " + std::to_string(i+1) + "/" + std::to_string(max_attempts));
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-
         }
-        logger_.error("Server health check failed after " + std::to_string(max_attempts) + " attempts");
-        return false;
     }
     
     void stopServerSoft() {
-        server_running_ = false;
-        logger_.info("Attempting graceful server shutdown");
-        
-        HttpClient temp_client("localhost", 8000, 1000);
-        try {
-            temp_client.post("/shutdown", "");
-            logger_.info("Graceful shutdown signal sent to server");
-        } catch (...) {
-            logger_.warning("Failed to send graceful shutdown signal");
+#ifdef RESSYS_EMBED_PYTHON
+        if (embeddedPythonRunning()) {
+            // Py_Finalize необратим: повторный запуск в том же процессе невозможен
+            std::cout << "Embedded Python stops together with the application" << std::endl;
+            return;
+        }
+#endif
+        if (daemon_attached_) {
+            retireDaemon(daemon_pid_);
+            daemon_attached_ = false;
+            std::cout << "Server stopped" << std::endl;
+            return;
         }
+        if (!server_process_.isRunning()) {
+            std::cout << "Server is not running" << std::endl;
+            return;
+        }
+        logger_.info("Attempting graceful server shutdown");
         
-        if (server_thread_.joinable()) {
-            server_thread_.join();
+        for (int i = server_workers_ - 1; i >= 0; --i) {
+            ProcessSupervisor& process = workerProcess(i);
+            if (!process.isRunning()) {
+                continue;
+            }
+            process.stop(std::chrono::seconds(10), [this, i]() {
+                HttpClient temp_client("localhost", server_port_ + i, 1000);
+                temp_client.setUnixSocketPath(workerSocketPath(i));
+                if (temp_client.post("/shutdown", "").empty()) {
+                    logger_.warning("Failed to send graceful shutdown signal");
+                } else {
+                    logger_.info("Graceful shutdown signal sent to server");
+                }
+            });
         }
-        logger_.info("Server stopped gracefully");
+        logger_.info("Server stopped (exit code " + std::to_string(server_process_.lastExitCode()) + ")");
     }
     void stopServer() {
-        server_running_ = false;
-        
-        #ifdef _WIN32
-            system("taskkill /f /im python.exe 2>nul 1>nul");
-        #else
-            system("pkill -f python 2>/dev/null");
-        #endif
-        
-        if (server_thread_.joinable()) {
-            server_thread_.detach();
+#ifdef RESSYS_EMBED_PYTHON
+        if (embedded_python_) {
+            embedded_python_->stop(); // фоновые обучения отменяются и дожидаются
+        }
+#endif
+        if (daemon_attached_) {
+            // Следующая сессия подключится к нему сразу; сам он выйдет после idle_timeout_s без запросов
+            logger_.info("Server daemon pid " + std::to_string(daemon_pid_) + " left running");
+            return;
+        }
+        // Останавливаем только свои дочерние процессы, чужие python.exe не трогаем
+        if (!server_process_.isRunning()) {
+            return;
+        }
+        for (int i = server_workers_ - 1; i >= 0; --i) {
+            if (workerProcess(i).isRunning()) {
+                workerProcess(i).stop(std::chrono::seconds(3));
+            }
         }
         std::cout << "Server stopped" << std::endl;
     }
     
     void makePrediction() {
-        if (!http_client_.healthCheck()) {
-            logger_.error("Server not available for prediction");
-            return;
-        }
-        
         // Запрашиваем путь к файлу
         std::cout << "Enter path to your data(.txt):" << std::endl;
         std::cout << "> ";
@@ -199,7 +641,8 @@ public:
         
         std::cout << "Choose the training base:" << std::endl;
         for (size_t i = 0; i < bases.size(); ++i) {
-            std::cout << (i + 1) << ". " << bases[i] << std::endl;
+            std::cout << (i + 1) << ". ";
+            printLearningBaseSummary(bases[i]);
         }
         
         std::cout << "Enter number: ";
@@ -245,99 +688,530 @@ public:
         
         std::cout << "Making prediction..." << std::endl;
         logger_.info("Starting prediction - File: " + file_path + ", Base: " + selected_base + ", Model: " + model_name);
+        TraceSpan trace_span("predict " + model_name + " / " + selected_base);
+        
+        std::string cache_key = predictionCacheKey(file_path, model_name, selected_base);
+        CachedPrediction cached;
+        if (prediction_cache_ && prediction_cache_->lookup(cache_key, cached)) {
+            std::cout << "Results saved to file! (cached)" << std::endl;
+            logger_.info("Prediction cache hit: " + cached.output_path + " (MSE " + std::to_string(cached.metrics.mse) +
+                         ", R2 " + std::to_string(cached.metrics.r2) + ")");
+            return;
+        }
+        
+        // Вход разбирается клиентом один раз - и для нативного движка, и для бинарного запроса
+        LearningBaseData input;
+        std::string input_error;
+        bool need_input = binary_predict_ || isNativeModel(model_name) ||
+                          (native_inference_ && fs::exists(nativeWeightsPath(selected_base, model_name)));
+        if (need_input && !loadPredictionInput(file_path, selected_base, input, input_error)) {
+            std::cerr << input_error << std::endl;
+            logger_.error("Prediction input rejected: " + input_error);
+            return; // файл не подходит к базе - на сервер его не отправляем
+        }
+        
+        if (isNativeModel(model_name)) {
+            // Эти модели есть только в клиенте, сервер их не считает
+            std::string error;
+            if (!makeNativeModelPrediction(file_path, model_name, selected_base, input, cached, error)) {
+                std::cerr << "Prediction failed: " << error << std::endl;
+                logger_.error("Native model prediction failed: " + error);
+                return;
+            }
+            std::cout << "Results saved to file!" << std::endl;
+            storePrediction(cache_key, cached);
+            return;
+        }
+        
+        if (native_inference_ && makeNativePrediction(file_path, model_name, selected_base, input, cached)) {
+            storePrediction(cache_key, cached);
+            return;
+        }
+        
+#ifdef RESSYS_EMBED_PYTHON
+        if (embeddedPythonRunning()) {
+            // Тот же JSON, что вернул бы сервер, но без HTTP; X/Y уходят в torch без копий
+            std::string result = binary_predict_
+                ? embedded_python_->predictWithBuffers(file_path, model_name, selected_base, input)
+                : embedded_python_->predictWithModel(file_path, model_name, selected_base);
+            handlePredictionResponse(result, cache_key);
+            return;
+        }
+#endif
+        
+        if (!http_client_.healthCheck()) {
+            logger_.error("Server not available for prediction");
+            return;
+        }
+        
+        if (shm_ring_ && makeShmPrediction(file_path, model_name, selected_base, input, cached)) {
+            storePrediction(cache_key, cached);
+            return;
+        }
+        
+        // Большой вход при нескольких воркерах делится на шарды и считается параллельно
+        std::vector<HttpClient*> workers = runningWorkers();
+        if (binary_predict_ && workers.size() > 1) {
+            ShardedPredictor sharded(workers, logger_);
+            sharded.setInlinePredictions(inline_predictions_);
+            if (sharded.shardCount(input.num_samples) > 1) {
+                std::string error;
+                cached.output_path = predictionOutputPath(output_dir_, file_path, model_name, selected_base);
+                if (!sharded.predict(input, file_path, model_name, selected_base, cached.output_path, cached.metrics,
+                                     error)) {
+                    std::cerr << "Prediction failed: " << error << std::endl;
+                    logger_.error("Sharded prediction failed: " + error);
+                    return;
+                }
+                std::cout << "Results saved to file!" << std::endl;
+                logger_.info("Prediction saved: " + cached.output_path + " (MSE " + std::to_string(cached.metrics.mse) +
+                             ", R2 " + std::to_string(cached.metrics.r2) + ")");
+                storePrediction(cache_key, cached);
+                return;
+            }
+        }
         
         // Отправляем запрос на сервер
-        std::string result = http_client_.predictWithModel(file_path, model_name, selected_base);
+        std::string result;
+        if (binary_predict_) {
+            std::string payload;
+            {
+                TraceSpan span("encode payload");
+                encodePredictionPayload(input, payload);
+            }
+            if (inline_predictions_) {
+                if (makeInlinePrediction(file_path, model_name, selected_base, input, payload, cached)) {
+                    storePrediction(cache_key, cached);
+                }
+                return;
+            }
+            result = http_client_.predictWithModelBinary(file_path, model_name, selected_base, payload);
+        } else {
+            result = http_client_.predictWithModel(file_path, model_name, selected_base);
+        }
+        handlePredictionResponse(result, cache_key);
+    }
+    
+    void handlePredictionResponse(const std::string& result, const std::string& cache_key) {
         std::cout << "Results saved to file!" << std::endl;
-        // result.output_path
         logger_.info("Prediction server response: " + result);
+        
+        Json::Value response;
+        Json::Reader reader;
+        if (reader.parse(result, response) && response.get("status", "").asString() == "success") {
+            CachedPrediction cached;
+            cached.output_path = response["output_path"].asString();
+            cached.metrics.mse = response["metrics"].get("mse", 0.0).asDouble();
+            cached.metrics.r2 = response["metrics"].get("r2", 0.0).asDouble();
+            cached.metrics.test_loss = response["metrics"].get("test_loss", 0.0).asDouble();
+            storePrediction(cache_key, cached);
+        }
     }
     
-    void saveResultToFile(const std::string& result) {
-        fs::path output_path(output_file_);
-        fs::create_directories(output_path.parent_path());
+    // Ключ кэша: вход, конфиг базы и веса всех реализаций модели (серверной, нативной и обученной в клиенте)
+    std::string predictionCacheKey(const std::string& file_path, const std::string& model_name,
+                                   const std::string& base_name) {
+        if (!prediction_cache_) {
+            return "";
+        }
+        std::string weights_stem = models_dir_ + "\\" + base_name + "_" + model_name;
+        return prediction_cache_->makeKey(file_path, getLearningBaseConfigPath(base_name),
+                                          {weights_stem + "_best.pth", weights_stem + ".rsw", weights_stem + ".rsm"},
+                                          model_name, base_name);
+    }
+    
+    void storePrediction(const std::string& cache_key, const CachedPrediction& prediction) {
+        if (prediction_cache_ && !cache_key.empty() && !prediction.output_path.empty()) {
+            prediction_cache_->store(cache_key, prediction);
+        }
+    }
+    
+    static bool readModelFileVersion(const std::string& path, ModelFileVersion& version, std::string& error) {
+        std::error_code ec;
+        version.write_time = fs::last_write_time(path, ec);
+        if (!ec) {
+            version.size = fs::file_size(path, ec);
+        }
+        if (ec) {
+            error = path + ": " + ec.message();
+            return false;
+        }
+        return true;
+    }
+    
+    // Сервер переписывает .rsw после каждого обучения (меню, задания, пакет), поэтому движок
+    // перезагружается, если файл изменился с момента загрузки
+    NmrInferenceEngine* getNativeEngine(const std::string& weights_path) {
+        ModelFileVersion version;
+        std::string error;
+        if (!readModelFileVersion(weights_path, version, error)) {
+            native_engines_.erase(weights_path);
+            logger_.warning("Native model not loaded: " + error);
+            return nullptr;
+        }
         
-        std::ofstream file(output_file_);
-        if (file.is_open()) {
-            file << "Prediction Result:\n";
-            file << "==================\n";
-            file << result << "\n";
-            file << "==================\n";
-            file.close();
+        auto it = native_engines_.find(weights_path);
+        if (it != native_engines_.end()) {
+            if (it->second.version == version) {
+                return it->second.engine.get();
+            }
+            logger_.info("Native model changed on disk, reloading: " + weights_path);
+            native_engines_.erase(it);
         }
+        
+        auto engine = std::make_unique<NmrInferenceEngine>();
+        if (!engine->load(weights_path)) {
+            logger_.warning("Native model not loaded: " + engine->lastError());
+            return nullptr;
+        }
+        logger_.info("Native model loaded: " + weights_path + " (max deviation from PyTorch " +
+                     std::to_string(engine->referenceError()) + ")");
+        
+        NmrInferenceEngine* result = engine.get();
+        native_engines_[weights_path] = NativeEngineEntry{std::move(engine), version};
+        return result;
     }
 
-    struct LearningBaseConfig {
-        std::string name;
-        int num_samples;
-        int num_targets_y;
-        std::vector<double> y_precision;
-        int num_features_x;
-        std::vector<int> x_lengths;
-    };
-
-    bool parseLearningBaseConfig(const std::string& input, LearningBaseConfig& config) {
-        std::vector<std::string> tokens;
-        std::istringstream iss(input);
-        std::string token;
+    std::string nativeWeightsPath(const std::string& base_name, const std::string& model_name) {
+        return models_dir_ + "\\" + base_name + "_" + model_name + ".rsw";
+    }
+    
+    // Разбор входного файла с проверкой по конфигу базы (до любого сетевого запроса)
+    bool loadPredictionInput(const std::string& file_path, const std::string& base_name, LearningBaseData& data,
+                             std::string& error) {
+        TraceSpan span("parse input");
+        LearningBaseConfig config;
+        if (!loadLearningBaseConfig(getLearningBaseConfigPath(base_name), config, error)) {
+            return false;
+        }
+        config.num_samples = 0; // во входном файле своё число записей
         
-        while (iss >> token) {
-            tokens.push_back(token);
+        LearningBaseParser parser;
+        if (!parser.parse(file_path, config, data)) {
+            error = "Input does not match base config: " + parser.lastError();
+            return false;
+        }
+        return true;
+    }
+
+    // Предсказание прямо в клиенте по экспортированным весам; false - нужен сервер
+    bool makeNativePrediction(const std::string& file_path, const std::string& model_name, const std::string& base_name,
+                              const LearningBaseData& data, CachedPrediction& result) {
+        std::string weights_path = nativeWeightsPath(base_name, model_name);
+        if (!fs::exists(weights_path)) {
+            logger_.debug("No native weights for " + base_name + "/" + model_name + ", using server");
+            return false;
         }
         
-        if (tokens.size() < 4) {
-            std::cerr << "Error: Not enough parameters" << std::endl;
+        NmrInferenceEngine* engine = getNativeEngine(weights_path);
+        if (!engine) {
             return false;
         }
         
-        try {
-            // Collect all tokens
-            config.name = tokens[0];
-            
-            config.num_samples = std::stoi(tokens[1]);
-            
-            config.num_targets_y = std::stoi(tokens[2]);
-            
-            if (tokens.size() < 3 + config.num_targets_y + 1) {
-                std::cerr << "Error: Not enough precision values for Y" << std::endl;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<float> predictions;
+        {
+            TraceSpan span("native inference");
+            if (!engine->predict(data, predictions)) {
+                logger_.error("Native prediction failed: " + engine->lastError());
                 return false;
             }
-            
-            config.y_precision.clear();
-            for (int i = 0; i < config.num_targets_y; ++i) {
-                config.y_precision.push_back(std::stod(tokens[3 + i]));
+        }
+        
+        std::string error;
+        if (!writeNativePrediction(file_path, model_name, base_name, data, predictions, start, result, error)) {
+            logger_.error(error);
+            return false;
+        }
+        std::cout << "Results saved to file!" << std::endl;
+        return true;
+    }
+    
+    // Метрики и файл результатов для предсказания, посчитанного в клиенте
+    bool writeNativePrediction(const std::string& file_path, const std::string& model_name, const std::string& base_name,
+                               const LearningBaseData& data, const std::vector<float>& predictions,
+                               std::chrono::steady_clock::time_point start, CachedPrediction& result,
+                               std::string& error) {
+        TraceSpan span("write output");
+        PredictionMetrics metrics = computePredictionMetrics(predictions.data(), data.y.data(),
+                                                             data.num_samples, data.num_targets_y);
+        std::string output_path = predictionOutputPath(output_dir_, file_path, model_name, base_name);
+        if (!writePredictionOutput(output_path, file_path, model_name, base_name, metrics, predictions.data(),
+                                   data.y.data(), data.num_samples, data.num_targets_y)) {
+            error = "Failed to write prediction output: " + output_path;
+            return false;
+        }
+        
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        result.output_path = output_path;
+        result.metrics = metrics;
+        logger_.info("Native prediction finished in " + std::to_string(elapsed_ms) + " ms: " + output_path +
+                     " (MSE " + std::to_string(metrics.mse) + ", R2 " + std::to_string(metrics.r2) + ")");
+        return true;
+    }
+    
+    bool isNativeModel(const std::string& model_name) {
+        return model_name == "linear_regression" || model_name == "svr";
+    }
+    
+    std::string nativeModelPath(const std::string& base_name, const std::string& model_name) {
+        return models_dir_ + "\\" + base_name + "_" + model_name + ".rsm";
+    }
+    
+    // .rsm может переобучить другая сессия или его заменят вручную: как и .rsw, модель
+    // перезагружается при изменении файла
+    NativeRegressor* getNativeModel(const std::string& model_path, std::string& error) {
+        ModelFileVersion version;
+        if (!readModelFileVersion(model_path, version, error)) {
+            native_models_.erase(model_path);
+            return nullptr;
+        }
+        
+        auto it = native_models_.find(model_path);
+        if (it != native_models_.end()) {
+            if (it->second.version == version) {
+                return it->second.model.get();
             }
-            
-            int current_index = 3 + config.num_targets_y;
-            if (tokens.size() <= current_index) {
-                std::cerr << "Error: Missing number of features X" << std::endl;
-                return false;
+            logger_.info("Native model changed on disk, reloading: " + model_path);
+            native_models_.erase(it);
+        }
+        
+        auto model = std::make_unique<NativeRegressor>();
+        if (!model->load(model_path)) {
+            error = model->lastError();
+            return nullptr;
+        }
+        NativeRegressor* result = model.get();
+        native_models_[model_path] = NativeModelEntry{std::move(model), version};
+        return result;
+    }
+    
+    // Обучение linear_regression (ridge) или svr прямо в клиенте по .rslb и train-части
+    // разбиения; качество меряется на test-части, модель сохраняется в .rsm
+    bool trainNativeModel(const std::string& base_name, const std::string& model_name, PredictionMetrics& metrics,
+                          std::string& message) {
+        TraceSpan trace_span("train " + model_name + " / " + base_name);
+        LearningBaseConfig config;
+        if (!loadLearningBaseConfig(getLearningBaseConfigPath(base_name), config, message)) {
+            return false;
+        }
+        LearningBaseBinary base;
+        if (!base.open(getLearningBaseBinaryPath(base_name))) {
+            message = "Binary learning base is not available, upload the base again: " + base.lastError();
+            return false;
+        }
+        
+        // Та же перестановка, что в .rssplit: она определяется только seed и числом записей
+        LearningBaseSplit split;
+        if (!makeLearningBaseSplit(static_cast<uint64_t>(base.numSamples()), split_seed_, train_percent_ / 100.0, 0,
+                                   split, message)) {
+            return false;
+        }
+        auto train_end = split.permutation.begin() + static_cast<std::ptrdiff_t>(split.train_count);
+        std::vector<uint64_t> train(split.permutation.begin(), train_end);
+        std::vector<uint64_t> test(train_end, split.permutation.end());
+        
+        NativeRegressor model;
+        NativeTrainingReport report;
+        bool trained = model_name == "svr" ? model.trainSvr(base, config, train, svr_options_, &report)
+                                           : model.trainRidge(base, config, train, ridge_options_, &report);
+        if (!trained) {
+            message = model.lastError();
+            return false;
+        }
+        if (!report.converged) {
+            logger_.warning("SVR solver stopped at the iteration limit, consider other svr_c / svr_epsilon");
+        }
+        
+        metrics = PredictionMetrics();
+        if (!test.empty()) {
+            std::vector<float> predictions, targets;
+            model.predict(base, test, predictions);
+            const int num_targets = base.config().num_targets_y;
+            for (uint64_t sample : test) {
+                const float* y = base.sampleY(static_cast<int>(sample));
+                targets.insert(targets.end(), y, y + num_targets);
             }
-            
-            config.num_features_x = std::stoi(tokens[current_index]);
-            current_index++;
-            
-            if (tokens.size() < current_index + config.num_features_x) {
-                std::cerr << "Error: Not enough length values for X" << std::endl;
+            metrics = computePredictionMetrics(predictions.data(), targets.data(), test.size(), num_targets);
+        }
+        
+        std::string model_path = nativeModelPath(base_name, model_name);
+        if (!model.save(model_path)) {
+            message = model.lastError();
+            return false;
+        }
+        native_models_.erase(model_path); // следующее предсказание загрузит новую модель
+        
+        std::ostringstream text;
+        text << model_name << " trained on " << report.train_samples << " records in "
+             << static_cast<long long>(report.elapsed_ms) << " ms";
+        if (model.isKernel()) {
+            text << ", " << report.support_vectors << " support vectors";
+        }
+        text << "; test MSE " << metrics.mse << ", R2 " << metrics.r2;
+        message = text.str();
+        logger_.info("Native model saved: " + model_path + " (" + message + ")");
+        return true;
+    }
+    
+    bool makeNativeModelPrediction(const std::string& file_path, const std::string& model_name,
+                                   const std::string& base_name, const LearningBaseData& data,
+                                   CachedPrediction& result, std::string& error) {
+        std::string model_path = nativeModelPath(base_name, model_name);
+        if (!fs::exists(model_path)) {
+            error = "Model " + model_name + " is not trained for " + base_name + " yet";
+            return false;
+        }
+        NativeRegressor* model = getNativeModel(model_path, error);
+        if (!model) {
+            return false;
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        std::vector<float> predictions;
+        {
+            TraceSpan span("native inference");
+            if (!model->predict(data, predictions)) {
+                error = model->lastError();
                 return false;
             }
-            
-            config.x_lengths.clear();
-            for (int i = 0; i < config.num_features_x; ++i) {
-                config.x_lengths.push_back(std::stoi(tokens[current_index + i]));
+        }
+        return writeNativePrediction(file_path, model_name, base_name, data, predictions, start, result, error);
+    }
+
+    // Предсказание через слот общей памяти: по HTTP уходит только описание слота,
+    // сервер пишет предсказания обратно в слот; false - откат на /predict/binary
+    bool makeShmPrediction(const std::string& file_path, const std::string& model_name, const std::string& base_name,
+                           const LearningBaseData& data, CachedPrediction& result) {
+        size_t num_samples = static_cast<size_t>(data.num_samples);
+        size_t request_size = predictionPayloadSize(data, num_samples);
+        size_t reply_count = num_samples * data.num_targets_y;
+        if (!shm_ring_->fits(request_size, reply_count)) {
+            logger_.debug("Input does not fit a shared memory slot (" + std::to_string(request_size >> 20) +
+                          " MB), using binary request");
+            return false;
+        }
+        
+        SharedTensorRing::Slot slot;
+        if (!shm_ring_->acquire(slot)) {
+            return false;
+        }
+        auto start = std::chrono::steady_clock::now();
+        {
+            TraceSpan span("encode payload");
+            writePredictionPayload(data, 0, num_samples, slot.data);
+        }
+        ShmSlotRequest request = shm_ring_->layout(slot, request_size, reply_count);
+        HttpResponse http_response = http_client_.call(
+            "POST", "/predict/shm", shmPredictRequestJson(shm_ring_->name(), request, file_path, model_name, base_name));
+        
+        // Слот возвращается в кольцо только после окончательного ответа на единственную попытку: после
+        // таймаута, обрыва, повтора или дубля сервер может ещё писать ответ в слот поверх следующего запроса
+        const bool definitive = http_response.ok && http_response.attempts == 1 && !http_response.hedged;
+        auto returnSlot = [&]() {
+            if (definitive) {
+                shm_ring_->release(slot);
+            } else {
+                shm_ring_->retire(slot);
             }
-            
-            if (tokens.size() != current_index + config.num_features_x) {
-                std::cerr << "Error: Too many parameters provided" << std::endl;
+        };
+        
+        Json::Value response;
+        Json::Reader reader;
+        if (!http_response.ok || !reader.parse(http_response.body, response) ||
+            response.get("status", "").asString() != "success") {
+            returnSlot();
+            logger_.warning("Shared memory prediction failed, using binary request: " +
+                            (http_response.ok ? http_response.body : http_response.error));
+            return false;
+        }
+        
+        // Ответ копируется из слота один раз, после этого слот можно отдавать следующему запросу
+        std::vector<float> predictions(reply_count);
+        std::memcpy(predictions.data(), slot.data + (request.reply_offset - request.request_offset),
+                    reply_count * sizeof(float));
+        returnSlot();
+        
+        PredictionMetrics metrics = computePredictionMetrics(predictions.data(), data.y.data(),
+                                                             num_samples, data.num_targets_y);
+        metrics.test_loss = response["metrics"].get("test_loss", metrics.test_loss).asDouble();
+        std::string output_path = predictionOutputPath(output_dir_, file_path, model_name, base_name);
+        {
+            TraceSpan span("write output");
+            if (!writePredictionOutput(output_path, file_path, model_name, base_name, metrics, predictions.data(),
+                                       data.y.data(), num_samples, data.num_targets_y)) {
+                logger_.error("Failed to write prediction output: " + output_path);
                 return false;
             }
-            
-            return true;
-            
-        } catch (const std::exception& e) {
-            std::cerr << "Error parsing parameters: " << e.what() << std::endl;
+        }
+        
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        result.output_path = output_path;
+        result.metrics = metrics;
+        std::cout << "Results saved to file!" << std::endl;
+        logger_.info("Shared memory prediction finished in " + std::to_string(elapsed_ms) + " ms: " + output_path +
+                     " (MSE " + std::to_string(metrics.mse) + ", R2 " + std::to_string(metrics.r2) + ")");
+        return true;
+    }
+
+    // Предсказания приходят в ответе /predict/binary и разбираются по мере приёма сразу в
+    // float-буфер; файл результатов, как и при shm, пишет клиент
+    bool makeInlinePrediction(const std::string& file_path, const std::string& model_name, const std::string& base_name,
+                              const LearningBaseData& data, const std::string& payload, CachedPrediction& result) {
+        size_t num_samples = static_cast<size_t>(data.num_samples);
+        auto start = std::chrono::steady_clock::now();
+        PredictionReply reply;
+        std::string error;
+        if (!http_client_.predictWithModelBinaryInline(file_path, model_name, base_name, payload,
+                                                       num_samples * data.num_targets_y, reply, error)) {
+            std::cerr << "Prediction failed: " << error << std::endl;
+            logger_.error("Prediction failed: " + error);
             return false;
         }
+        
+        if (reply.predictions.empty()) {
+            // Сервер без inline уже записал файл сам
+            result.output_path = reply.output_path;
+            result.metrics = reply.metrics;
+        } else {
+            PredictionMetrics metrics = computePredictionMetrics(reply.predictions.data(), data.y.data(),
+                                                                 num_samples, data.num_targets_y);
+            metrics.test_loss = reply.metrics.test_loss;
+            std::string output_path = predictionOutputPath(output_dir_, file_path, model_name, base_name);
+            {
+                TraceSpan span("write output");
+                if (!writePredictionOutput(output_path, file_path, model_name, base_name, metrics,
+                                           reply.predictions.data(), data.y.data(), num_samples, data.num_targets_y)) {
+                    logger_.error("Failed to write prediction output: " + output_path);
+                    return false;
+                }
+            }
+            result.output_path = output_path;
+            result.metrics = metrics;
+        }
+        
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "Results saved to file!" << std::endl;
+        logger_.info("Prediction finished in " + std::to_string(elapsed_ms) + " ms: " + result.output_path +
+                     " (MSE " + std::to_string(result.metrics.mse) + ", R2 " + std::to_string(result.metrics.r2) + ")");
+        return true;
+    }
+
+    void saveResultToFile(const std::string& result) {
+        fs::path output_path(output_file_);
+        fs::create_directories(output_path.parent_path());
+        
+        std::ofstream file(output_file_);
+        if (file.is_open()) {
+            file << "Prediction Result:\n";
+            file << "==================\n";
+            file << result << "\n";
+            file << "==================\n";
+            file.close();
+        }
     }
 
     bool copyLearningBaseFile(const std::string& source_path, const std::string& base_name) {
@@ -355,39 +1229,79 @@ public:
         }
     }
 
+    // Потоковая конвертация сохранённой копии базы в .rslb со сверкой по конфигу: память
+    // ограничена размером куска, поэтому базы больше RAM загружаются так же, как маленькие.
+    // Статистика каналов из того же прохода попадает в config и сохраняется в Configs
+    bool convertLearningBase(LearningBaseConfig& config) {
+        std::string base_path = getLearningBasePath(config.name);
+        std::string binary_path = getLearningBaseBinaryPath(config.name);
+        LearningBaseStreamConverter converter;
+        LearningBaseStreamStats stats;
+        
+        if (!converter.convert(base_path, config, binary_path, &stats)) {
+            std::cerr << "Learning base does not match config: " << converter.lastError() << std::endl;
+            logger_.error("Learning base conversion failed for " + config.name + ": " + converter.lastError());
+            return false;
+        }
+        
+        logger_.info("Learning base " + config.name + " converted: " + std::to_string(stats.num_samples) +
+                     " records, " + std::to_string(stats.bytes_read >> 20) + " MB in " +
+                     std::to_string(static_cast<long long>(stats.elapsed_ms)) + " ms (" +
+                     std::to_string(converter.numThreads()) + " threads, buffers " +
+                     std::to_string(stats.peak_buffer_bytes >> 20) + " MB)");
+        logger_.info("Binary learning base saved: " + binary_path);
+        stats.values.exportTo(config);
+        return true;
+    }
+
+    // Индексы train/test и фолдов для .rslb: пересоздаются, только если сделаны с другими настройками.
+    // Без них сервер разбивает базу сам, поэтому ошибка не фатальна
+    void ensureLearningBaseSplit(const std::string& base_name) {
+        if (!fs::exists(getLearningBaseBinaryPath(base_name))) {
+            return;
+        }
+        LearningBaseConfig config;
+        std::string error;
+        if (!loadLearningBaseConfig(getLearningBaseConfigPath(base_name), config, error)) {
+            logger_.warning("Learning base split skipped: " + error);
+            return;
+        }
+        
+        LearningBaseSplit split;
+        std::string split_path = getLearningBaseSplitPath(base_name);
+        uint64_t num_samples = static_cast<uint64_t>(config.num_samples);
+        if (!makeLearningBaseSplit(num_samples, split_seed_, train_percent_ / 100.0, split_folds_, split, error)) {
+            logger_.warning("Learning base split skipped for " + base_name + ": " + error);
+            return;
+        }
+        
+        LearningBaseSplit existing;
+        std::string read_error;
+        if (readLearningBaseSplitHeader(split_path, existing, read_error) && existing.num_samples == split.num_samples &&
+            existing.seed == split.seed && existing.train_count == split.train_count &&
+            existing.fold_bounds == split.fold_bounds) {
+            return;
+        }
+        
+        if (!writeLearningBaseSplit(split_path, split, error)) {
+            logger_.warning("Failed to write learning base split " + split_path + ": " + error);
+            return;
+        }
+        logger_.info("Learning base split saved: " + split_path + " (seed " + std::to_string(split_seed_) + ", train " +
+                     std::to_string(split.train_count) + "/" + std::to_string(num_samples) + ", folds " +
+                     std::to_string(split_folds_) + ")");
+    }
+
     bool saveLearningBaseConfig(const LearningBaseConfig& config) {
         try {
             std::string config_dir = learning_base_dir_ + "\\Configs";
             fs::create_directories(config_dir);
             
-            std::string config_path = config_dir + "\\" + config.name + ".txt";
-            std::ofstream file(config_path);
-            
-            if (!file.is_open()) {
+            std::string error;
+            if (!writeLearningBaseConfig(config_dir + "\\" + config.name + ".txt", config, error)) {
+                std::cerr << "Error saving config: " << error << std::endl;
                 return false;
             }
-            
-            file << "name=" << config.name << "\n";
-            file << "num_samples=" << config.num_samples << "\n";
-            file << "num_targets_y=" << config.num_targets_y << "\n";
-            
-            file << "y_precision=";
-            for (size_t i = 0; i < config.y_precision.size(); ++i) {
-                file << config.y_precision[i];
-                if (i < config.y_precision.size() - 1) file << ",";
-            }
-            file << "\n";
-            
-            file << "num_features_x=" << config.num_features_x << "\n";
-            
-            file << "x_lengths=";
-            for (size_t i = 0; i < config.x_lengths.size(); ++i) {
-                file << config.x_lengths[i];
-                if (i < config.x_lengths.size() - 1) file << ",";
-            }
-            file << "\n";
-            
-            file.close();
             return true;
             
         } catch (const std::exception& e) {
@@ -407,7 +1321,9 @@ public:
         std::string config_input;
         std::getline(std::cin, config_input);
         
-        if (!parseLearningBaseConfig(config_input, config)) {
+        std::string parse_error;
+        if (!parseLearningBaseConfig(config_input, config, parse_error)) {
+            std::cerr << "Error: " << parse_error << std::endl;
             std::cerr << "Invalid configuration format!" << std::endl;
             logger_.error("Failed to parse learning base config: " + config_input);
             return;
@@ -432,10 +1348,18 @@ public:
             return;
         }
         
+        // Старая бинарная копия не должна пережить неудачную загрузку новой базы с тем же именем
+        fs::remove(getLearningBaseBinaryPath(config.name));
+        if (!convertLearningBase(config)) {
+            fs::remove(getLearningBasePath(config.name));
+            return;
+        }
+        
         if (!saveLearningBaseConfig(config)) {
             logger_.error("Failed to save learning base config for: " + config.name);
             return;
         }
+        ensureLearningBaseSplit(config.name);
         
         std::cout << "Learning base " << config.name << " saved successfully!" << std::endl;
         logger_.info("Learning base uploaded successfully: " + config.name);
@@ -452,7 +1376,8 @@ public:
         
         std::cout << "Choose the learning base:" << std::endl;
         for (size_t i = 0; i < bases.size(); ++i) {
-            std::cout << (i + 1) << ". " << bases[i] << std::endl;
+            std::cout << (i + 1) << ". ";
+            printLearningBaseSummary(bases[i]);
         }
         
         std::cout << "Enter number: ";
@@ -480,6 +1405,7 @@ public:
             logger_.error("Selected learning base files not found: " + selected_base);
             return;
         }
+        ensureLearningBaseSplit(selected_base);
         
         std::cout << "Choose model:" << std::endl;
         std::cout << "1. SVR" << std::endl;
@@ -512,6 +1438,36 @@ public:
             return;
         }
         
+        if (isNativeModel(model_name)) {
+            // Решатели в клиенте укладываются в секунды - обучаем сразу, без сервера и фоновых заданий
+            std::cout << "Starting learning process..." << std::endl;
+            logger_.info("Starting native training - Base: " + selected_base + ", Model: " + model_name);
+            PredictionMetrics metrics;
+            std::string message;
+            if (!trainNativeModel(selected_base, model_name, metrics, message)) {
+                std::cerr << "Training failed: " << message << std::endl;
+                logger_.error("Native training failed: " + message);
+                return;
+            }
+            std::cout << message << std::endl;
+            return;
+        }
+        
+#ifdef RESSYS_EMBED_PYTHON
+        if (embeddedPythonRunning()) {
+            std::cout << "Starting learning process..." << std::endl;
+            logger_.info("Starting embedded training - Base: " + selected_base + ", Model: " + model_name);
+            embedded_python_->trainModelAsync(selected_base, base_path, config_path, model_name,
+                [this, selected_base, model_name](const std::string& result) {
+                    std::cout << "\n[Training " << selected_base << " / " << model_name << " finished] " << result
+                              << std::endl;
+                    logger_.info("Embedded training result: " + result);
+                });
+            std::cout << "Training started in background, the result will be printed here." << std::endl;
+            return;
+        }
+#endif
+        
         if (!http_client_.healthCheck()) {
             // std::cout << "Server is not available. Please start the server first." << std::endl;
             logger_.error("Server not available for training");
@@ -521,12 +1477,209 @@ public:
         std::cout << "Starting learning process..." << std::endl;
         logger_.info("Starting training - Base: " + selected_base + ", Model: " + model_name);
         
-        std::string response = http_client_.trainModel(selected_base, base_path, config_path, model_name);
+        // Обучение идёт на сервере в фоне, меню сразу свободно; прогресс - в "Training jobs"
+        std::string job_id, error;
+        if (!training_jobs_.submit(selected_base, base_path, config_path, model_name, job_id, error)) {
+            std::cerr << "Training not started: " << error << std::endl;
+            logger_.error("Training job rejected: " + error);
+            return;
+        }
+        std::cout << "Training job " << job_id << " started. Track it in \"Training jobs\"." << std::endl;
+    }
+    
+    void showTrainingJobs() {
+        auto jobs = training_jobs_.snapshot();
+        if (jobs.empty()) {
+            std::cout << "No training jobs in this session." << std::endl;
+            return;
+        }
+        
+        std::cout << "\n" << std::left << std::setw(3) << "#" << std::setw(13) << "Job" << std::setw(29) << "Base / Model"
+                  << std::setw(14) << "State" << std::setw(10) << "Epoch" << std::setw(12) << "Train loss"
+                  << std::setw(12) << "Test loss" << "R2" << std::endl;
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            const auto& job = jobs[i];
+            std::string name = job.base_name + " / " + job.model_type;
+            std::string epoch = job.epochs > 0 ? std::to_string(job.epoch) + "/" + std::to_string(job.epochs) : "-";
+            std::cout << std::left << std::setw(3) << (i + 1) << std::setw(13) << job.id << std::setw(29)
+                      << name.substr(0, 28) << std::setw(14) << job.state << std::setw(10) << epoch << std::fixed
+                      << std::setprecision(5) << std::setw(12) << job.train_loss << std::setw(12) << job.test_loss
+                      << std::setprecision(4) << job.r2 << std::defaultfloat << std::right << std::endl;
+            if (job.finished() && !job.message.empty()) {
+                std::cout << "   " << job.message << std::endl;
+            }
+        }
+        
+        if (training_jobs_.activeCount() == 0) {
+            return;
+        }
+        std::cout << "Enter job number to cancel (empty - back): ";
+        std::string choice;
+        std::getline(std::cin, choice);
+        if (choice.empty()) {
+            return;
+        }
+        
+        size_t index = 0;
+        try {
+            index = std::stoul(choice);
+        } catch (...) {
+            std::cout << "Invalid number!" << std::endl;
+            return;
+        }
+        if (index < 1 || index > jobs.size()) {
+            std::cout << "Invalid choice!" << std::endl;
+            return;
+        }
+        
+        std::string error;
+        if (training_jobs_.cancel(jobs[index - 1].id, error)) {
+            std::cout << "Cancellation requested for job " << jobs[index - 1].id << std::endl;
+        } else {
+            std::cout << "Cannot cancel: " << error << std::endl;
+        }
+    }
+    
+    // Файл трассировки переписывается после каждого действия меню - его можно открыть, не закрывая сессию
+    void flushTrace() {
+        std::string error;
+        if (!TraceRecorder::instance().flush(error)) {
+            logger_.warning("Session trace not written: " + error);
+        }
+    }
+    
+    // p50/p95/p99 по каждому endpoint из HttpMetrics (все HTTP-запросы сессии, включая воркеры)
+    void showMetrics() {
+        auto endpoints = HttpMetrics::instance().endpoints();
+        if (endpoints.empty()) {
+            std::cout << "No HTTP requests in this session." << std::endl;
+            return;
+        }
         
-        logger_.info("Training server response: " + response);
-        std::cout << "Operation finished!" << std::endl;
+        auto ms = [](const LatencyHistogram& histogram, double q) { return histogram.quantileMicros(q) / 1000.0; };
+        std::cout << "\n" << std::left << std::setw(28) << "Endpoint" << std::setw(17) << "Server" << std::setw(10)
+                  << "Requests" << std::setw(8) << "Errors" << std::setw(26) << "Total p50/p95/p99, ms"
+                  << std::setw(20) << "TTFB p50/p99, ms" << std::setw(17) << "Connect p99, ms" << "Sent / received"
+                  << std::endl;
+        for (const auto* entry : endpoints) {
+            const auto& total = entry->phases[HttpEndpointMetrics::kTotal];
+            const auto& ttfb = entry->phases[HttpEndpointMetrics::kTtfb];
+            const auto& connect = entry->phases[HttpEndpointMetrics::kConnect];
+            std::ostringstream total_text, ttfb_text, bytes_text;
+            total_text << std::fixed << std::setprecision(1) << ms(total, 0.5) << " / " << ms(total, 0.95) << " / "
+                       << ms(total, 0.99);
+            ttfb_text << std::fixed << std::setprecision(1) << ms(ttfb, 0.5) << " / " << ms(ttfb, 0.99);
+            bytes_text << (entry->bytes_sent.load() >> 10) << " KB / " << (entry->bytes_received.load() >> 10) << " KB";
+            std::cout << std::left << std::setw(28) << entry->endpoint.substr(0, 27) << std::setw(17)
+                      << entry->server.substr(0, 16) << std::setw(10) << entry->requests() << std::setw(8)
+                      << entry->errors() << std::setw(26) << total_text.str() << std::setw(20) << ttfb_text.str()
+                      << std::fixed << std::setprecision(2) << std::setw(17) << ms(connect, 0.99) << std::defaultfloat
+                      << bytes_text.str() << std::right << std::endl;
+        }
+        if (metrics_exporter_) {
+            std::cout << "Prometheus file: " << metrics_exporter_->path() << std::endl;
+        }
     }
     
+    bool isKnownModel(const std::string& model_name) {
+        return model_name == "svr" || model_name == "convolutional" || model_name == "linear_regression";
+    }
+
+    // Пакетный режим: задания из JSONL без интерактивного меню
+    int runBatch(const std::string& jobs_path, const std::string& results_path) {
+        logger_.info("Batch mode: jobs " + jobs_path + ", results " + results_path);
+        
+        if (!http_client_.healthCheck()) {
+            startServerProcess(); // пакетный режим всегда через сервер (асинхронные запросы)
+            if (!serverRunning()) {
+                std::cerr << "Server is not available, batch aborted" << std::endl;
+                return 1;
+            }
+        }
+        
+        auto bases = findLearningBases();
+        BatchRunner runner(http_client_, logger_, config_.getInt("server", "max_concurrency", 4));
+        runner.setJobValidator([this, bases](const BatchJob& job) -> std::string {
+            if (!isKnownModel(job.model_name)) {
+                return "Unknown model: " + job.model_name;
+            }
+            if (std::find(bases.begin(), bases.end(), job.base_name) == bases.end()) {
+                return "Learning base not found: " + job.base_name;
+            }
+            if (job.type == "predict" && !fs::exists(job.file_path)) {
+                return "File not found: " + job.file_path;
+            }
+            return "";
+        });
+        runner.setBasePathResolver([this](const std::string& base_name, std::string& base_path, std::string& config_path) {
+            base_path = getLearningBasePath(base_name);
+            config_path = getLearningBaseConfigPath(base_name);
+            ensureLearningBaseSplit(base_name);
+        });
+        runner.setPredictionCache(prediction_cache_.get(), [this](const BatchJob& job) {
+            return predictionCacheKey(job.file_path, job.model_name, job.base_name);
+        });
+        runner.setWorkers(runningWorkers());
+        runner.setLocalRunner([this](const BatchJob& job, Json::Value& result) {
+            if (!isNativeModel(job.model_name)) {
+                return false;
+            }
+            PredictionMetrics metrics;
+            std::string message;
+            bool ok;
+            if (job.type == "train") {
+                ensureLearningBaseSplit(job.base_name);
+                ok = trainNativeModel(job.base_name, job.model_name, metrics, message);
+                if (ok) {
+                    result["weights_path"] = nativeModelPath(job.base_name, job.model_name);
+                }
+            } else {
+                LearningBaseData data;
+                CachedPrediction prediction;
+                ok = loadPredictionInput(job.file_path, job.base_name, data, message) &&
+                     makeNativeModelPrediction(job.file_path, job.model_name, job.base_name, data, prediction, message);
+                if (ok) {
+                    metrics = prediction.metrics;
+                    result["output_path"] = prediction.output_path;
+                    storePrediction(predictionCacheKey(job.file_path, job.model_name, job.base_name), prediction);
+                }
+            }
+            result["status"] = ok ? "success" : "error";
+            if (!message.empty()) {
+                result["message"] = message;
+            }
+            if (ok) {
+                result["metrics"]["mse"] = metrics.mse;
+                result["metrics"]["r2"] = metrics.r2;
+                result["metrics"]["test_loss"] = metrics.test_loss;
+            }
+            return true;
+        });
+        if (binary_predict_) {
+            runner.setPayloadEncoder([this](const BatchJob& job, std::string& payload, std::string& error) {
+                LearningBaseData data;
+                if (!loadPredictionInput(job.file_path, job.base_name, data, error)) {
+                    return false;
+                }
+                encodePredictionPayload(data, payload);
+                return true;
+            });
+        }
+        
+        BatchSummary summary;
+        bool ok = runner.run(jobs_path, results_path, summary);
+        if (ok) {
+            std::cout << "Batch finished: " << summary.succeeded << " succeeded, " << summary.failed << " failed, "
+                      << summary.rejected << " rejected, " << summary.cached << " from cache ("
+                      << summary.elapsed_ms / 1000.0 << " s)" << std::endl;
+            std::cout << "Results: " << results_path << std::endl;
+        }
+        
+        stopServer();
+        flushTrace();
+        return ok && summary.failed == 0 && summary.rejected == 0 ? 0 : 1;
+    }
+
     void showMenu() {
         std::cout << "\n=== ML Application ===" << std::endl;
         std::cout << "1. Start server" << std::endl;
@@ -535,7 +1688,9 @@ public:
         std::cout << "4. Make prediction" << std::endl;
         std::cout << "5. Check server health" << std::endl;
         std::cout << "6. Stop server" << std::endl;
-        std::cout << "7. Exit" << std::endl;
+        std::cout << "7. Training jobs" << std::endl;
+        std::cout << "8. Show metrics" << std::endl;
+        std::cout << "9. Exit" << std::endl;
         std::cout << "Choose option: ";
     }
     
@@ -544,6 +1699,7 @@ public:
         std::cout << "ML Desktop Application v1.4" << std::endl;
         
         while (true) {
+            flushTrace();
             showMenu();
             
             std::string choice;
@@ -559,6 +1715,13 @@ public:
             } else if (choice == "4") {
                 makePrediction();
             } else if (choice == "5") {
+#ifdef RESSYS_EMBED_PYTHON
+                if (embedded_python_) {
+                    std::cout << (embeddedPythonRunning() ? "✓ Embedded Python is running!" :
+                                                            "✗ Embedded Python is not started!") << std::endl;
+                    continue;
+                }
+#endif
                 if (http_client_.healthCheck()) {
                     std::cout << "✓ Server is healthy!" << std::endl;
                     logger_.info("Server health check: healthy");
@@ -569,6 +1732,26 @@ public:
             } else if (choice == "6") {
                 stopServerSoft();
             } else if (choice == "7") {
+                showTrainingJobs();
+            } else if (choice == "8") {
+                showMetrics();
+            } else if (choice == "9") {
+                size_t active = training_jobs_.activeCount();
+#ifdef RESSYS_EMBED_PYTHON
+                if (embedded_python_) {
+                    active += embedded_python_->activeTrainings();
+                }
+#endif
+                if (active > 0) {
+                    std::cout << active << " training job(s) still running, they "
+                              << (daemon_attached_ ? "continue on the server daemon" : "stop with the server")
+                              << ". Exit? y/n: ";
+                    std::string confirm;
+                    std::getline(std::cin, confirm);
+                    if (confirm != "y" && confirm != "Y") {
+                        continue;
+                    }
+                }
                 break;
             } else {
                 std::cout << "Invalid option!" << std::endl;
@@ -576,14 +1759,34 @@ public:
         }
         
         stopServer();
+        flushTrace();
+        if (prediction_cache_) {
+            logger_.info("Prediction cache: " + std::to_string(prediction_cache_->hits()) + " hits, " +
+                         std::to_string(prediction_cache_->misses()) + " misses, " +
+                         std::to_string(prediction_cache_->entries()) + " entries");
+        }
         std::cout << "Application closed" << std::endl;
         logger_.info("Application session ended");
     }
 };
 
-int main() {
+int main(int argc, char* argv[]) {
     SetConsoleOutputCP(CP_UTF8);
     MLApplication app;
+    
+    // ResSysML --batch jobs.jsonl [--out results.jsonl]
+    if (argc >= 3 && std::string(argv[1]) == "--batch") {
+        std::string jobs_path = argv[2];
+        std::string results_path;
+        if (argc >= 5 && std::string(argv[3]) == "--out") {
+            results_path = argv[4];
+        } else {
+            fs::path jobs(jobs_path);
+            results_path = (jobs.parent_path() / (jobs.stem().string() + "_results.jsonl")).string();
+        }
+        return app.runBatch(jobs_path, results_path);
+    }
+    
     app.run();
     return 0;
 }
\ No newline at end of file
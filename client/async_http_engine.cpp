@@ -0,0 +1,235 @@
+#include "async_http_engine.h"
+#include "curl_handle_pool.h"
+#include "http_metrics.h"
+#include "trace_recorder.h"
+#include <algorithm>
+#include <vector>
+
+AsyncHttpEngine::AsyncHttpEngine(size_t max_concurrency)
+    : max_concurrency_(max_concurrency > 0 ? max_concurrency : 1) {
+    CurlHandlePool::instance(); // curl_global_init раньше curl_multi_init
+    multi_ = curl_multi_init();
+    thread_ = std::thread(&AsyncHttpEngine::loop, this);
+}
+
+AsyncHttpEngine::~AsyncHttpEngine() {
+    stop_ = true;
+    curl_multi_wakeup(multi_);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    curl_multi_cleanup(multi_);
+}
+
+void AsyncHttpEngine::submit(HttpRequest request, Callback callback) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->request = std::move(request);
+    transfer->callback = std::move(callback);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(std::move(transfer));
+    }
+    curl_multi_wakeup(multi_);
+}
+
+std::future<HttpResponse> AsyncHttpEngine::submit(HttpRequest request) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    std::future<HttpResponse> future = promise->get_future();
+    submit(std::move(request), [promise](HttpResponse&& response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+void AsyncHttpEngine::setMaxConcurrency(size_t max_concurrency) {
+    max_concurrency_ = max_concurrency > 0 ? max_concurrency : 1;
+    curl_multi_wakeup(multi_);
+}
+
+size_t AsyncHttpEngine::receiveBody(void* contents, size_t size, size_t nmemb, void* user) {
+    size_t total = size * nmemb;
+    Transfer* transfer = static_cast<Transfer*>(user);
+    if (transfer->request.on_data) {
+        // Возврат меньшего числа байт curl считает ошибкой записи и прерывает запрос
+        return transfer->request.on_data(static_cast<const char*>(contents), total) ? total : 0;
+    }
+    if (transfer->request.decoder) {
+        return transfer->request.decoder->feed(static_cast<const char*>(contents), total) ? total : 0;
+    }
+    transfer->response.append(static_cast<const char*>(contents), total);
+    return total;
+}
+
+int AsyncHttpEngine::abortIfCancelled(void* user, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    return static_cast<Transfer*>(user)->request.cancelled->load() ? 1 : 0;
+}
+
+size_t AsyncHttpEngine::queued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+void AsyncHttpEngine::startTransfer(std::unique_ptr<Transfer> transfer) {
+    if (transfer->request.cancelled && transfer->request.cancelled->load()) {
+        HttpResponse response;
+        response.result = CURLE_ABORTED_BY_CALLBACK;
+        response.error = "Request cancelled";
+        response.attempts = 0; // так и не ушёл
+        transfer->callback(std::move(response));
+        return;
+    }
+    CURL* easy = CurlHandlePool::instance().acquire();
+    if (!easy) {
+        HttpResponse response;
+        response.error = "curl_easy_init failed";
+        transfer->callback(std::move(response));
+        return;
+    }
+
+    const HttpRequest& request = transfer->request;
+    curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, receiveBody);
+    curl_easy_setopt(easy, CURLOPT_WRITEDATA, transfer.get());
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, transfer.get());
+    curl_easy_setopt(easy, CURLOPT_TIMEOUT_MS, request.timeout_ms);
+    if (!request.unix_socket_path.empty()) {
+        curl_easy_setopt(easy, CURLOPT_UNIX_SOCKET_PATH, request.unix_socket_path.c_str());
+    }
+    if (!request.trace_id.empty()) {
+        transfer->traced_headers = TraceRecorder::withTraceHeader(request.headers, request.trace_id);
+        curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->traced_headers);
+        curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, TraceRecorder::receiveHeader);
+        curl_easy_setopt(easy, CURLOPT_HEADERDATA, &transfer->trace_spans);
+    } else if (request.headers) {
+        curl_easy_setopt(easy, CURLOPT_HTTPHEADER, request.headers);
+    }
+    if (request.cancelled) {
+        // Проверка раз в вызов прогресса curl (не реже раза в секунду)
+        curl_easy_setopt(easy, CURLOPT_NOPROGRESS, 0L);
+        curl_easy_setopt(easy, CURLOPT_XFERINFOFUNCTION, abortIfCancelled);
+        curl_easy_setopt(easy, CURLOPT_XFERINFODATA, transfer.get());
+    }
+    if (request.method == "POST") {
+        const std::string& body = request.shared_body ? *request.shared_body : request.body;
+        curl_easy_setopt(easy, CURLOPT_POST, 1L);
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDS, body.data());
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(body.size()));
+    } else if (request.method != "GET") {
+        curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, request.method.c_str());
+    }
+
+    transfer->easy = easy;
+    transfer->start = std::chrono::steady_clock::now();
+    curl_multi_add_handle(multi_, easy);
+    active_[easy] = std::move(transfer);
+    ++in_flight_;
+}
+
+void AsyncHttpEngine::finishTransfer(CURL* easy, CURLcode result) {
+    auto it = active_.find(easy);
+    if (it == active_.end()) {
+        return;
+    }
+    std::unique_ptr<Transfer> transfer = std::move(it->second);
+    active_.erase(it);
+
+    curl_multi_remove_handle(multi_, easy);
+
+    HttpResponse response;
+    response.ok = result == CURLE_OK;
+    response.result = result;
+    if (!response.ok) {
+        response.error = curl_easy_strerror(result);
+    }
+    curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &response.status);
+    if (result != CURLE_ABORTED_BY_CALLBACK) { // снятый проигравший дубль - не ошибка сервера
+        HttpMetrics::instance().recordTransfer(easy, transfer->request.url, result);
+    }
+    if (!transfer->request.trace_id.empty()) {
+        TraceRecorder::instance().recordTransfer(easy, transfer->request.url, transfer->request.method.c_str(),
+                                                 transfer->request.trace_id, transfer->trace_spans);
+    }
+    response.body = std::move(transfer->response);
+    if (transfer->request.decoder) {
+        if (response.ok) {
+            transfer->request.decoder->finish();
+        }
+        response.decoded = std::move(transfer->request.decoder);
+    }
+    response.elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - transfer->start).count();
+
+    CurlHandlePool::instance().release(easy);
+    --in_flight_;
+
+    transfer->callback(std::move(response));
+}
+
+void AsyncHttpEngine::loop() {
+    while (!stop_) {
+        // Докладываем запросы из очереди, пока не упрёмся в лимит; отложенные ждут своего
+        // времени, снятые уходят сразу. До ближайшего отложенного - не дольше секунды ожидания
+        std::vector<std::unique_ptr<Transfer>> to_start;
+        auto now = std::chrono::steady_clock::now();
+        auto wake_at = now + std::chrono::seconds(1);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto it = pending_.begin(); it != pending_.end();) {
+                const HttpRequest& request = (*it)->request;
+                bool cancelled = request.cancelled && request.cancelled->load();
+                if (!cancelled && active_.size() + to_start.size() >= max_concurrency_) {
+                    ++it;
+                    continue;
+                }
+                if (!cancelled && request.not_before > now) {
+                    wake_at = std::min(wake_at, request.not_before);
+                    ++it;
+                    continue;
+                }
+                to_start.push_back(std::move(*it));
+                it = pending_.erase(it);
+            }
+        }
+        for (auto& transfer : to_start) {
+            startTransfer(std::move(transfer));
+        }
+
+        int running = 0;
+        curl_multi_perform(multi_, &running);
+
+        int messages = 0;
+        bool finished = false;
+        while (CURLMsg* msg = curl_multi_info_read(multi_, &messages)) {
+            if (msg->msg == CURLMSG_DONE) {
+                finishTransfer(msg->easy_handle, msg->data.result);
+                finished = true;
+            }
+        }
+
+        // Освободилось место - сразу берём следующие запросы из очереди
+        if (!finished) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(wake_at - std::chrono::steady_clock::now());
+            curl_multi_poll(multi_, nullptr, 0, static_cast<int>(std::max<long long>(1, wait.count())), nullptr);
+        }
+    }
+
+    // Завершаем всё, что осталось, чтобы никто не ждал future вечно
+    HttpResponse cancelled;
+    cancelled.error = "Request cancelled: engine stopped";
+    for (auto& entry : active_) {
+        curl_multi_remove_handle(multi_, entry.first);
+        CurlHandlePool::instance().release(entry.first);
+        entry.second->callback(HttpResponse(cancelled));
+    }
+    active_.clear();
+    in_flight_ = 0;
+
+    std::deque<std::unique_ptr<Transfer>> pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending.swap(pending_);
+    }
+    for (auto& transfer : pending) {
+        transfer->callback(HttpResponse(cancelled));
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef ASYNC_HTTP_ENGINE_H
+#define ASYNC_HTTP_ENGINE_H
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <curl/curl.h>
+
+// Разбор тела по мере приёма вместо накопления в HttpResponse::body (см. JsonStreamParser).
+// Свой экземпляр на каждую попытку: повтор или дубль начинают разбор заново
+class HttpBodyDecoder {
+public:
+    virtual ~HttpBodyDecoder() = default;
+    virtual bool feed(const char* data, size_t size) = 0; // false - прервать запрос (CURLE_WRITE_ERROR)
+    virtual void finish() = 0;                            // тело пришло целиком
+};
+
+using HttpDecoderFactory = std::function<std::shared_ptr<HttpBodyDecoder>()>;
+
+struct HttpResponse {
+    bool ok = false;        // транспорт отработал (CURLE_OK), HTTP-код смотреть отдельно
+    CURLcode result = CURLE_OK;
+    long status = 0;
+    std::string body;
+    std::string error;
+    double elapsed_ms = 0.0;
+    int attempts = 1;           // попыток с повторами (RequestPolicy), считая дубль
+    bool hedged = false;        // ответ дал дубль на другом воркере
+    long budget_left_ms = -1;   // остаток срока вызова к моменту ответа; -1 - срока нет
+    std::shared_ptr<HttpBodyDecoder> decoded; // декодер, которому ушло тело (body тогда пустое)
+};
+
+// Потоковый приём тела: вызывается на каждый пришедший кусок (из потока цикла); false - прервать запрос
+using HttpDataCallback = std::function<bool(const char* data, size_t size)>;
+
+struct HttpRequest {
+    std::string url;
+    std::string method = "GET";
+    std::string body;
+    std::shared_ptr<const std::string> shared_body; // задан - тело отсюда: повторы и дубль без копий
+    const curl_slist* headers = nullptr; // не владеет, должен жить до завершения запроса
+    long timeout_ms = 0;
+    std::string unix_socket_path; // не пусто - соединение через Unix domain socket вместо TCP
+    HttpDataCallback on_data;     // задан - тело не копится в HttpResponse::body, а отдаётся по кускам
+    std::shared_ptr<HttpBodyDecoder> decoder; // то же через декодер, он же уходит в HttpResponse::decoded
+    std::string trace_id;         // не пусто - заголовок X-Trace-Id и запись в TraceRecorder
+    std::chrono::steady_clock::time_point not_before{}; // отложенный старт: пауза перед повтором, дубль
+    std::shared_ptr<std::atomic<bool>> cancelled;     // выставлен - запрос снимается (CURLE_ABORTED_BY_CALLBACK)
+};
+
+// Неблокирующие HTTP-запросы: один поток с циклом curl_multi обслуживает
+// все запросы, одновременно в работе не больше max_concurrency, остальные
+// ждут в очереди. Колбэки вызываются из потока цикла и должны быть короткими.
+class AsyncHttpEngine {
+public:
+    using Callback = std::function<void(HttpResponse&&)>;
+
+    explicit AsyncHttpEngine(size_t max_concurrency = 4);
+    ~AsyncHttpEngine();
+
+    AsyncHttpEngine(const AsyncHttpEngine&) = delete;
+    AsyncHttpEngine& operator=(const AsyncHttpEngine&) = delete;
+
+    void submit(HttpRequest request, Callback callback);
+    std::future<HttpResponse> submit(HttpRequest request);
+
+    void setMaxConcurrency(size_t max_concurrency);
+    size_t maxConcurrency() const { return max_concurrency_.load(); }
+    size_t inFlight() const { return in_flight_.load(); }
+    size_t queued() const;
+
+private:
+    struct Transfer {
+        CURL* easy = nullptr;
+        HttpRequest request;
+        Callback callback;
+        std::string response;
+        std::chrono::steady_clock::time_point start;
+        curl_slist* traced_headers = nullptr; // request.headers + X-Trace-Id
+        std::string trace_spans;              // X-Trace-Spans ответа
+
+        ~Transfer() { curl_slist_free_all(traced_headers); }
+    };
+
+    static size_t receiveBody(void* contents, size_t size, size_t nmemb, void* user);
+    static int abortIfCancelled(void* user, curl_off_t, curl_off_t, curl_off_t, curl_off_t);
+    void loop();
+    void startTransfer(std::unique_ptr<Transfer> transfer);
+    void finishTransfer(CURL* easy, CURLcode result);
+
+    CURLM* multi_ = nullptr;
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+    std::atomic<size_t> max_concurrency_;
+    std::atomic<size_t> in_flight_{0};
+
+    mutable std::mutex mutex_;
+    std::deque<std::unique_ptr<Transfer>> pending_;
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> active_; // только из потока цикла
+};
+
+#endif // ASYNC_HTTP_ENGINE_H
@@ -0,0 +1,307 @@
+#include "batch_runner.h"
+#include "trace_recorder.h"
+#include <chrono>
+#include <memory>
+#include <sstream>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string toJsonLine(const Json::Value& value) {
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    return Json::writeString(writer, value);
+}
+
+Json::Value metricsToJson(const PredictionMetrics& metrics) {
+    Json::Value value;
+    value["mse"] = metrics.mse;
+    value["r2"] = metrics.r2;
+    value["test_loss"] = metrics.test_loss;
+    return value;
+}
+
+} // namespace
+
+BatchRunner::BatchRunner(HttpClient& client, Logger& logger, size_t max_in_flight)
+    : client_(client), logger_(logger), max_in_flight_(max_in_flight > 0 ? max_in_flight : 1) {}
+
+bool BatchRunner::parseJob(const std::string& text, BatchJob& job, std::string& error) {
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    Json::Value value;
+
+    if (!reader->parse(text.data(), text.data() + text.size(), &value, &error)) {
+        return false;
+    }
+    if (!value.isObject()) {
+        error = "Job must be a JSON object";
+        return false;
+    }
+
+    job.id = value.get("id", "").asString();
+    job.type = value.get("type", "predict").asString();
+    job.file_path = value.get("file_path", "").asString();
+    job.base_name = value.get("base_name", "").asString();
+    job.model_name = value.get("model_name", "").asString();
+
+    if (job.type != "predict" && job.type != "train") {
+        error = "Unknown job type: " + job.type;
+        return false;
+    }
+    if (job.base_name.empty() || job.model_name.empty() || (job.type == "predict" && job.file_path.empty())) {
+        error = "Missing required fields";
+        return false;
+    }
+    return true;
+}
+
+void BatchRunner::writeResult(const BatchJob& job, Json::Value result) {
+    result["line"] = static_cast<Json::UInt64>(job.line);
+    if (!job.id.empty()) {
+        result["id"] = job.id;
+    }
+    if (!job.type.empty()) {
+        result["type"] = job.type;
+    }
+    if (!job.file_path.empty()) {
+        result["file_path"] = job.file_path;
+    }
+    if (!job.base_name.empty()) {
+        result["base_name"] = job.base_name;
+    }
+    if (!job.model_name.empty()) {
+        result["model_name"] = job.model_name;
+    }
+
+    std::string line = toJsonLine(result);
+    std::lock_guard<std::mutex> lock(mutex_);
+    results_ << line << "\n";
+    results_.flush(); // результаты видны сразу, даже если прогон прервут
+}
+
+bool BatchRunner::tryCached(const BatchJob& job, std::string& cache_key) {
+    if (!cache_ || job.type != "predict") {
+        return false;
+    }
+    cache_key = cache_key_resolver_ ? cache_key_resolver_(job) : "";
+
+    auto started_at = Clock::now();
+    CachedPrediction cached;
+    if (!cache_->lookup(cache_key, cached)) {
+        return false;
+    }
+
+    Json::Value result;
+    result["latency_ms"] = std::chrono::duration<double, std::milli>(Clock::now() - started_at).count();
+    result["status"] = "success";
+    result["cached"] = true;
+    result["output_path"] = cached.output_path;
+    result["metrics"] = metricsToJson(cached.metrics);
+    writeResult(job, result);
+    return true;
+}
+
+HttpClient& BatchRunner::predictClient() {
+    if (workers_.empty()) {
+        return client_;
+    }
+    return *workers_[next_worker_++ % workers_.size()];
+}
+
+void BatchRunner::submit(const BatchJob& job, const std::string& cache_key, std::string payload) {
+    auto submitted_at = Clock::now();
+    std::string trace_id = TraceRecorder::currentTraceId();
+    auto callback = [this, job, cache_key, submitted_at, trace_id](HttpResponse&& response) {
+        Json::Value result;
+        result["latency_ms"] = std::chrono::duration<double, std::milli>(Clock::now() - submitted_at).count();
+        result["http_status"] = static_cast<Json::Int>(response.status);
+        result["attempts"] = response.attempts;
+        if (response.hedged) {
+            result["hedged"] = true;
+        }
+        if (response.budget_left_ms >= 0) {
+            result["budget_left_ms"] = static_cast<Json::Int64>(response.budget_left_ms);
+        }
+        if (!trace_id.empty()) {
+            result["trace_id"] = trace_id; // поиск задания в трассировке сессии
+        }
+
+        bool success = false;
+        if (!response.ok) {
+            result["status"] = "error";
+            result["message"] = response.error;
+        } else {
+            Json::Value body;
+            Json::CharReaderBuilder builder;
+            std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+            std::string error;
+            if (reader->parse(response.body.data(), response.body.data() + response.body.size(), &body, &error) &&
+                body.isObject()) {
+                std::string status = body.get("status", "error").asString();
+                success = status == "success";
+                result["status"] = status;
+                for (const char* key : {"message", "output_path", "metrics", "weights_path", "best_loss", "accuracy"}) {
+                    if (body.isMember(key)) {
+                        result[key] = body[key];
+                    }
+                }
+                if (success && cache_ && !cache_key.empty() && body["output_path"].isString()) {
+                    CachedPrediction prediction;
+                    prediction.output_path = body["output_path"].asString();
+                    prediction.metrics.mse = body["metrics"].get("mse", 0.0).asDouble();
+                    prediction.metrics.r2 = body["metrics"].get("r2", 0.0).asDouble();
+                    prediction.metrics.test_loss = body["metrics"].get("test_loss", 0.0).asDouble();
+                    cache_->store(cache_key, prediction);
+                }
+            } else {
+                result["status"] = "error";
+                result["message"] = "Invalid server response: " + error;
+            }
+        }
+
+        writeResult(job, result);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (success) {
+                ++summary_->succeeded;
+            } else {
+                ++summary_->failed;
+            }
+            --in_flight_;
+            // Под замком: увидев in_flight_ == 0, run() возвращается и раннер уничтожается,
+            // после снятия замка к его полям обращаться нельзя
+            slot_freed_.notify_all();
+        }
+    };
+
+    if (job.type == "train") {
+        std::string base_path, config_path;
+        if (resolver_) {
+            resolver_(job.base_name, base_path, config_path);
+        }
+        // Обучение идёт долго, общий timeout_ms клиента к нему не применяем
+        client_.postAsync("/train", HttpClient::trainRequestJson(job.base_name, base_path, config_path, job.model_name),
+                          std::move(callback), 0);
+    } else if (!payload.empty()) {
+        predictClient().predictWithModelBinaryAsync(job.file_path, job.model_name, job.base_name, std::move(payload),
+                                            std::move(callback));
+    } else {
+        predictClient().postAsync("/predict", HttpClient::predictRequestJson(job.file_path, job.model_name, job.base_name),
+                          std::move(callback));
+    }
+}
+
+bool BatchRunner::run(const std::string& jobs_path, const std::string& results_path, BatchSummary& summary) {
+    std::ifstream jobs(jobs_path);
+    if (!jobs.is_open()) {
+        logger_.error("Cannot open batch jobs file: " + jobs_path);
+        return false;
+    }
+
+    results_.open(results_path, std::ios::out | std::ios::trunc);
+    if (!results_.is_open()) {
+        logger_.error("Cannot create batch results file: " + results_path);
+        return false;
+    }
+
+    summary = BatchSummary();
+    summary_ = &summary;
+    in_flight_ = 0;
+    auto start = Clock::now();
+
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(jobs, line)) {
+        ++line_number;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+
+        BatchJob job;
+        job.line = line_number;
+        std::string error;
+        if (!parseJob(line, job, error) || (validator_ && !(error = validator_(job)).empty())) {
+            Json::Value result;
+            result["status"] = "rejected";
+            result["message"] = error;
+            writeResult(job, result);
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++summary.rejected;
+            continue;
+        }
+
+        // Один trace на задание: локальный расчёт, разбор входа, ожидание слота и HTTP-запрос
+        TraceSpan job_span("batch job " + job.id);
+        
+        std::string cache_key;
+        if (tryCached(job, cache_key)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++summary.submitted;
+            ++summary.succeeded;
+            ++summary.cached;
+            continue;
+        }
+
+        // Нативные модели считаются в клиенте, в этом же потоке (секунды, а не эпохи)
+        Json::Value local_result;
+        auto local_started_at = Clock::now();
+        if (local_runner_ && local_runner_(job, local_result)) {
+            local_result["latency_ms"] =
+                std::chrono::duration<double, std::milli>(Clock::now() - local_started_at).count();
+            local_result["local"] = true;
+            if (!TraceRecorder::currentTraceId().empty()) {
+                local_result["trace_id"] = TraceRecorder::currentTraceId();
+            }
+            bool success = local_result.get("status", "error").asString() == "success";
+            writeResult(job, local_result);
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++summary.submitted;
+            if (success) {
+                ++summary.succeeded;
+            } else {
+                ++summary.failed;
+            }
+            continue;
+        }
+
+        // Вход разбирается и проверяется здесь: несовместимый файл не доходит до сервера
+        std::string payload;
+        if (job.type == "predict" && payload_encoder_ && !payload_encoder_(job, payload, error)) {
+            Json::Value result;
+            result["status"] = "rejected";
+            result["message"] = error;
+            writeResult(job, result);
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++summary.rejected;
+            continue;
+        }
+
+        // Ждём свободный слот: файл заданий читается не быстрее, чем сервер их разбирает
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            slot_freed_.wait(lock, [this]() { return in_flight_ < max_in_flight_; });
+            ++in_flight_;
+            ++summary.submitted;
+        }
+        submit(job, cache_key, std::move(payload));
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        slot_freed_.wait(lock, [this]() { return in_flight_ == 0; });
+    }
+
+    summary.elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    results_.close();
+    summary_ = nullptr;
+
+    std::ostringstream message;
+    message << "Batch finished: " << summary.submitted << " submitted, " << summary.succeeded << " succeeded, "
+            << summary.failed << " failed, " << summary.rejected << " rejected, " << summary.cached
+            << " from cache in " << summary.elapsed_ms << " ms";
+    logger_.info(message.str());
+    return true;
+}
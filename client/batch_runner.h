@@ -0,0 +1,95 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <json/json.h>
+#include "http_client.h"
+#include "logger.h"
+#include "prediction_cache.h"
+
+// Задание пакетного режима - одна строка JSONL:
+//   {"id": "job-1", "type": "predict", "file_path": "...", "base_name": "...", "model_name": "convolutional"}
+//   {"id": "job-2", "type": "train", "base_name": "...", "model_name": "svr"}
+struct BatchJob {
+    size_t line = 0;
+    std::string id;
+    std::string type;
+    std::string file_path;
+    std::string base_name;
+    std::string model_name;
+};
+
+struct BatchSummary {
+    size_t submitted = 0;
+    size_t succeeded = 0;
+    size_t failed = 0;
+    size_t rejected = 0;  // не прошли проверку и на сервер не отправлялись
+    size_t cached = 0;    // взяты из кэша предсказаний (входят в succeeded)
+    double elapsed_ms = 0.0;
+};
+
+// Потоковый прогон заданий из JSONL: файл читается построчно, задания уходят
+// на сервер асинхронно (не больше max_in_flight одновременно), результат
+// каждого задания сразу дописывается строкой в results JSONL.
+class BatchRunner {
+public:
+    // Проверка задания до отправки; возвращает текст ошибки или пустую строку
+    using JobValidator = std::function<std::string(const BatchJob&)>;
+    // Пути к базе и её конфигу по имени (для train)
+    using BasePathResolver = std::function<void(const std::string& base_name, std::string& base_path,
+                                                std::string& config_path)>;
+    // Ключ кэша предсказаний для задания predict (пустая строка - без кэша)
+    using CacheKeyResolver = std::function<std::string(const BatchJob&)>;
+    // Бинарное тело для /predict/binary; false - вход не подходит к базе (задание отклоняется)
+    using PayloadEncoder = std::function<bool(const BatchJob&, std::string& payload, std::string& error)>;
+    // Задания, которые клиент выполняет сам (нативные модели): true - result заполнен, на сервер не идёт
+    using LocalRunner = std::function<bool(const BatchJob&, Json::Value& result)>;
+
+    BatchRunner(HttpClient& client, Logger& logger, size_t max_in_flight);
+
+    void setJobValidator(JobValidator validator) { validator_ = std::move(validator); }
+    void setBasePathResolver(BasePathResolver resolver) { resolver_ = std::move(resolver); }
+    void setPredictionCache(PredictionCache* cache, CacheKeyResolver key_resolver) {
+        cache_ = cache;
+        cache_key_resolver_ = std::move(key_resolver);
+    }
+    void setPayloadEncoder(PayloadEncoder encoder) { payload_encoder_ = std::move(encoder); }
+    void setLocalRunner(LocalRunner runner) { local_runner_ = std::move(runner); }
+    // Процессы-воркеры сервера: задания predict раздаются по кругу, train всегда идут на основной клиент
+    void setWorkers(std::vector<HttpClient*> workers) { workers_ = std::move(workers); }
+
+    bool run(const std::string& jobs_path, const std::string& results_path, BatchSummary& summary);
+
+private:
+    HttpClient& client_;
+    Logger& logger_;
+    size_t max_in_flight_;
+    JobValidator validator_;
+    BasePathResolver resolver_;
+    PredictionCache* cache_ = nullptr;
+    CacheKeyResolver cache_key_resolver_;
+    PayloadEncoder payload_encoder_;
+    LocalRunner local_runner_;
+    std::vector<HttpClient*> workers_;
+    size_t next_worker_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable slot_freed_;
+    size_t in_flight_ = 0;
+    std::ofstream results_;
+    BatchSummary* summary_ = nullptr;
+
+    bool parseJob(const std::string& text, BatchJob& job, std::string& error);
+    HttpClient& predictClient();
+    bool tryCached(const BatchJob& job, std::string& cache_key);
+    void submit(const BatchJob& job, const std::string& cache_key, std::string payload);
+    void writeResult(const BatchJob& job, Json::Value result);
+};
+
+#endif // BATCH_RUNNER_H
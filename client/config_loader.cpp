@@ -66,6 +66,27 @@ int ConfigLoader::getInt(const std::string& section, const std::string& key, int
     return default_value;
 }
 
+double ConfigLoader::getDouble(const std::string& section, const std::string& key, double default_value) {
+    std::string value = getString(section, key);
+    if (!value.empty()) {
+        try {
+            return std::stod(value);
+        } catch (...) {
+            return default_value;
+        }
+    }
+    return default_value;
+}
+
+std::vector<std::string> ConfigLoader::sections(const std::string& prefix) const {
+    std::vector<std::string> names;
+    for (auto it = config_.lower_bound(prefix); it != config_.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+         ++it) {
+        names.push_back(it->first);
+    }
+    return names;
+}
+
 std::string ConfigLoader::getAppDataPath(const std::string& app_name) {
     char app_data_path[MAX_PATH];
     if (SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_APPDATA, NULL, 0, app_data_path))) {
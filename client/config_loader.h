@@ -3,6 +3,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 class ConfigLoader {
 public:
@@ -14,6 +15,9 @@ public:
     std::string getString(const std::string& section, const std::string& key, 
                          const std::string& default_value = "");
     int getInt(const std::string& section, const std::string& key, int default_value = 0);
+    double getDouble(const std::string& section, const std::string& key, double default_value = 0.0);
+    // Имена секций, начинающихся с prefix (например, "request " -> "request /predict", ...)
+    std::vector<std::string> sections(const std::string& prefix) const;
     
 private:
     std::string filename_;
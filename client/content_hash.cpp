@@ -0,0 +1,143 @@
+#include "content_hash.h"
+#include "mapped_file.h"
+#include <cstring>
+
+namespace {
+
+const uint64_t kPrime1 = 11400714785074694791ULL;
+const uint64_t kPrime2 = 14029467366897019727ULL;
+const uint64_t kPrime3 = 1609587929392839161ULL;
+const uint64_t kPrime4 = 9650029242287828579ULL;
+const uint64_t kPrime5 = 2870177450012600261ULL;
+
+inline uint64_t rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t read64(const unsigned char* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value)); // little-endian, как и все наши платформы
+    return value;
+}
+
+inline uint32_t read32(const unsigned char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint64_t round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t value) {
+    acc ^= round(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+} // namespace
+
+Xxh64::Xxh64(uint64_t seed) : seed_(seed) {
+    acc_[0] = seed + kPrime1 + kPrime2;
+    acc_[1] = seed + kPrime2;
+    acc_[2] = seed;
+    acc_[3] = seed - kPrime1;
+}
+
+void Xxh64::update(const void* data, size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + size;
+    total_ += size;
+
+    if (buffered_ + size < sizeof(buffer_)) {
+        if (size > 0) {
+            std::memcpy(buffer_ + buffered_, p, size);
+        }
+        buffered_ += size;
+        return;
+    }
+
+    if (buffered_ > 0) {
+        size_t fill = sizeof(buffer_) - buffered_;
+        std::memcpy(buffer_ + buffered_, p, fill);
+        p += fill;
+        for (int lane = 0; lane < 4; ++lane) {
+            acc_[lane] = round(acc_[lane], read64(buffer_ + lane * 8));
+        }
+        buffered_ = 0;
+    }
+
+    while (end - p >= 32) {
+        acc_[0] = round(acc_[0], read64(p));
+        acc_[1] = round(acc_[1], read64(p + 8));
+        acc_[2] = round(acc_[2], read64(p + 16));
+        acc_[3] = round(acc_[3], read64(p + 24));
+        p += 32;
+    }
+
+    buffered_ = static_cast<size_t>(end - p);
+    if (buffered_ > 0) {
+        std::memcpy(buffer_, p, buffered_);
+    }
+}
+
+uint64_t Xxh64::digest() const {
+    uint64_t hash;
+    if (total_ >= 32) {
+        hash = rotl(acc_[0], 1) + rotl(acc_[1], 7) + rotl(acc_[2], 12) + rotl(acc_[3], 18);
+        for (int lane = 0; lane < 4; ++lane) {
+            hash = mergeRound(hash, acc_[lane]);
+        }
+    } else {
+        hash = seed_ + kPrime5;
+    }
+    hash += total_;
+
+    const unsigned char* p = buffer_;
+    const unsigned char* end = buffer_ + buffered_;
+    while (end - p >= 8) {
+        hash ^= round(0, read64(p));
+        hash = rotl(hash, 27) * kPrime1 + kPrime4;
+        p += 8;
+    }
+    if (end - p >= 4) {
+        hash ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+        hash = rotl(hash, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    while (p < end) {
+        hash ^= static_cast<uint64_t>(*p) * kPrime5;
+        hash = rotl(hash, 11) * kPrime1;
+        ++p;
+    }
+
+    hash ^= hash >> 33;
+    hash *= kPrime2;
+    hash ^= hash >> 29;
+    hash *= kPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+bool hashFileContents(const std::string& path, uint64_t& hash) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    Xxh64 hasher;
+    hasher.update(file.data(), file.size());
+    hash = hasher.digest();
+    return true;
+}
+
+std::string hashToHex(uint64_t hash) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        hex[i] = digits[hash & 0xF];
+        hash >>= 4;
+    }
+    return hex;
+}
@@ -0,0 +1,31 @@
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Потоковый XXH64 (совместим с эталонной реализацией xxHash): несколько ГБ/с,
+// для ключей кэша и проверки содержимого, не для криптографии
+class Xxh64 {
+public:
+    explicit Xxh64(uint64_t seed = 0);
+
+    void update(const void* data, size_t size);
+    void update(const std::string& text) { update(text.data(), text.size()); }
+    uint64_t digest() const;
+
+private:
+    uint64_t acc_[4];
+    uint64_t seed_;
+    uint64_t total_ = 0;
+    unsigned char buffer_[32];
+    size_t buffered_ = 0;
+};
+
+// Хэш содержимого файла (через отображение в память); false - файл не открылся
+bool hashFileContents(const std::string& path, uint64_t& hash);
+
+std::string hashToHex(uint64_t hash);
+
+#endif // CONTENT_HASH_H
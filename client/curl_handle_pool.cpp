@@ -0,0 +1,119 @@
+#include "curl_handle_pool.h"
+
+namespace {
+
+// Больше хэндлов в простое не держим - лишние просто освобождаются
+const size_t kMaxIdleHandles = 16;
+
+// curl_global_init/cleanup ровно один раз на процесс
+struct CurlGlobal {
+    CurlGlobal() { curl_global_init(CURL_GLOBAL_DEFAULT); }
+    ~CurlGlobal() { curl_global_cleanup(); }
+};
+
+CurlGlobal& curlGlobal() {
+    static CurlGlobal global;
+    return global;
+}
+
+// Хэндл, который поток вернул последним: следующий запрос этого потока берёт его вместе с
+// его keep-alive соединениями. При выходе потока хэндл уходит в общий список
+struct ThreadHandle {
+    CURL* handle = nullptr;
+    ~ThreadHandle() {
+        if (handle) {
+            CurlHandlePool::instance().release(handle);
+        }
+    }
+};
+
+thread_local ThreadHandle t_handle;
+
+} // namespace
+
+CurlHandlePool& CurlHandlePool::instance() {
+    // CurlGlobal создаётся раньше пула, значит и разрушается позже него
+    curlGlobal();
+    static CurlHandlePool pool;
+    return pool;
+}
+
+CurlHandlePool::CurlHandlePool() {
+    share_ = curl_share_init();
+    if (share_) {
+        curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, lockShare);
+        curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, unlockShare);
+        curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+        // Только DNS и TLS-сессии: общий кэш соединений libcurl не поддерживает при одновременной
+        // работе из нескольких потоков (синхронные вызовы, циклы curl_multi, потоки шардов).
+        // Keep-alive держат сами хэндлы пула и кэши соединений каждого multi
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+}
+
+CurlHandlePool::~CurlHandlePool() {
+    for (CURL* handle : idle_) {
+        curl_easy_cleanup(handle);
+    }
+    idle_.clear();
+    if (share_) {
+        curl_share_cleanup(share_);
+    }
+}
+
+void CurlHandlePool::lockShare(CURL*, curl_lock_data data, curl_lock_access, void* user) {
+    static_cast<CurlHandlePool*>(user)->share_locks_[data].lock();
+}
+
+void CurlHandlePool::unlockShare(CURL*, curl_lock_data data, void* user) {
+    static_cast<CurlHandlePool*>(user)->share_locks_[data].unlock();
+}
+
+CURL* CurlHandlePool::acquire() {
+    CURL* handle = t_handle.handle;
+    t_handle.handle = nullptr;
+    if (!handle) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idle_.empty()) {
+            handle = idle_.back();
+            idle_.pop_back();
+        }
+    }
+
+    if (handle) {
+        curl_easy_reset(handle);
+    } else {
+        handle = curl_easy_init();
+        if (!handle) {
+            return nullptr;
+        }
+    }
+
+    if (share_) {
+        curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+    }
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    return handle;
+}
+
+void CurlHandlePool::releaseToThread(CURL* handle) {
+    if (!t_handle.handle) {
+        t_handle.handle = handle;
+        return;
+    }
+    release(handle);
+}
+
+void CurlHandlePool::release(CURL* handle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (idle_.size() < kMaxIdleHandles) {
+            idle_.push_back(handle);
+            return;
+        }
+    }
+    curl_easy_cleanup(handle);
+}
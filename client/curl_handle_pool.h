@@ -0,0 +1,61 @@
+#ifndef CURL_HANDLE_POOL_H
+#define CURL_HANDLE_POOL_H
+
+#include <curl/curl.h>
+#include <mutex>
+#include <vector>
+
+// Пул easy-хэндлов libcurl на весь процесс. Keep-alive соединения живут в самих
+// хэндлах: поток получает обратно свой последний хэндл, остальные берут из общего
+// списка. Через CURLSH делятся только DNS и TLS-сессии (кэш соединений libcurl
+// между одновременно работающими потоками делить нельзя). curl_global_init
+// вызывается один раз.
+class CurlHandlePool {
+public:
+    static CurlHandlePool& instance();
+
+    // Хэндл сброшен (curl_easy_reset) и подключён к общему кэшу DNS и TLS-сессий
+    CURL* acquire();
+    void release(CURL* handle);
+    // Для синхронных вызовов: хэндл остаётся за текущим потоком
+    void releaseToThread(CURL* handle);
+
+    CURLSH* share() const { return share_; }
+
+    CurlHandlePool(const CurlHandlePool&) = delete;
+    CurlHandlePool& operator=(const CurlHandlePool&) = delete;
+
+private:
+    CurlHandlePool();
+    ~CurlHandlePool();
+
+    static void lockShare(CURL* handle, curl_lock_data data, curl_lock_access access, void* user);
+    static void unlockShare(CURL* handle, curl_lock_data data, void* user);
+
+    std::mutex mutex_;
+    std::vector<CURL*> idle_;
+    CURLSH* share_ = nullptr;
+    std::mutex share_locks_[CURL_LOCK_DATA_LAST];
+};
+
+// RAII-обёртка: берёт хэндл из пула и возвращает его в деструкторе
+class PooledCurlHandle {
+public:
+    PooledCurlHandle() : handle_(CurlHandlePool::instance().acquire()) {}
+    ~PooledCurlHandle() {
+        if (handle_) {
+            CurlHandlePool::instance().releaseToThread(handle_);
+        }
+    }
+
+    PooledCurlHandle(const PooledCurlHandle&) = delete;
+    PooledCurlHandle& operator=(const PooledCurlHandle&) = delete;
+
+    CURL* get() const { return handle_; }
+    explicit operator bool() const { return handle_ != nullptr; }
+
+private:
+    CURL* handle_;
+};
+
+#endif // CURL_HANDLE_POOL_H
@@ -0,0 +1,325 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "embedded_python.h"
+#include <chrono>
+#include <filesystem>
+#include <json/json.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// GIL на время вызова - из любого потока, в том числе из потоков обучения
+class GilLock {
+public:
+    GilLock() : state_(PyGILState_Ensure()) {}
+    ~GilLock() { PyGILState_Release(state_); }
+
+    GilLock(const GilLock&) = delete;
+    GilLock& operator=(const GilLock&) = delete;
+
+private:
+    PyGILState_STATE state_;
+};
+
+const char kStopFlagCapsule[] = "ressys.stop_flag";
+
+PyObject* shouldStop(PyObject* self, PyObject*) {
+    auto* flag = static_cast<std::atomic<bool>*>(PyCapsule_GetPointer(self, kStopFlagCapsule));
+    return PyBool_FromLong(flag != nullptr && flag->load());
+}
+
+PyMethodDef kShouldStopDef = {"should_stop", shouldStop, METH_NOARGS, nullptr};
+
+// memoryview только для чтения поверх памяти C++, без копии
+PyObject* floatView(const float* data, size_t count) {
+    static char empty = 0;
+    char* memory = count > 0 ? reinterpret_cast<char*>(const_cast<float*>(data)) : &empty;
+    return PyMemoryView_FromMemory(memory, static_cast<Py_ssize_t>(count * sizeof(float)), PyBUF_READ);
+}
+
+std::string toString(PyObject* object) {
+    std::string text;
+    PyObject* str = object ? PyObject_Str(object) : nullptr;
+    if (str) {
+        const char* utf8 = PyUnicode_AsUTF8(str);
+        text = utf8 ? utf8 : "";
+        Py_DECREF(str);
+    }
+    PyErr_Clear();
+    return text;
+}
+
+double toDouble(PyObject* object) {
+    double value = object ? PyFloat_AsDouble(object) : 0.0;
+    if (PyErr_Occurred()) {
+        PyErr_Clear();
+        return 0.0;
+    }
+    return value;
+}
+
+// Текст текущего исключения Python (как str(e) в обработчиках main.py)
+std::string fetchError() {
+    PyObject* type = nullptr;
+    PyObject* value = nullptr;
+    PyObject* traceback = nullptr;
+    PyErr_Fetch(&type, &value, &traceback);
+    PyErr_NormalizeException(&type, &value, &traceback);
+    std::string message = toString(value ? value : type);
+    if (message.empty()) {
+        message = "Python call failed";
+    }
+    Py_XDECREF(type);
+    Py_XDECREF(value);
+    Py_XDECREF(traceback);
+    return message;
+}
+
+std::string writeJson(const Json::Value& value) {
+    Json::StreamWriterBuilder writer;
+    return Json::writeString(writer, value);
+}
+
+std::string errorJson(const std::string& message) {
+    Json::Value response;
+    response["status"] = "error";
+    response["message"] = message;
+    return writeJson(response);
+}
+
+} // namespace
+
+EmbeddedPython::EmbeddedPython(Logger& logger) : logger_(logger) {}
+
+EmbeddedPython::~EmbeddedPython() {
+    stop();
+}
+
+bool EmbeddedPython::start(const std::string& server_dir, const std::string& python_home) {
+    if (running_) {
+        return true;
+    }
+    if (finalized_) {
+        last_error_ = "Embedded Python cannot be restarted in the same process";
+        return false;
+    }
+    auto started_at = std::chrono::steady_clock::now();
+
+    PyConfig config;
+    PyConfig_InitPythonConfig(&config);
+    config.install_signal_handlers = 0; // Ctrl+C остаётся за консолью клиента
+    config.parse_argv = 0;
+    PyStatus status = PyStatus_Ok();
+    if (!python_home.empty()) {
+        status = PyConfig_SetBytesString(&config, &config.home, python_home.c_str());
+    }
+    if (!PyStatus_Exception(status)) {
+        status = Py_InitializeFromConfig(&config);
+    }
+    PyConfig_Clear(&config);
+    if (PyStatus_Exception(status)) {
+        last_error_ = std::string("Python initialization failed: ") + (status.err_msg ? status.err_msg : "unknown error");
+        return false;
+    }
+
+    // sys.path как у main.py: каталог сервера и его site-packages
+    PyObject* sys_path = PySys_GetObject("path");
+    PyObject* dir = PyUnicode_FromString(server_dir.c_str());
+    PyObject* site_packages = PyUnicode_FromString((fs::path(server_dir) / "site-packages").string().c_str());
+    if (sys_path && dir && site_packages) {
+        PyList_Insert(sys_path, 0, dir);
+        PyList_Append(sys_path, site_packages);
+    }
+    Py_XDECREF(dir);
+    Py_XDECREF(site_packages);
+
+    predict_module_ = PyImport_ImportModule("ml.predict");
+    train_module_ = predict_module_ ? PyImport_ImportModule("ml.train") : nullptr;
+    if (!predict_module_ || !train_module_) {
+        last_error_ = "Cannot import ml modules: " + fetchError();
+        Py_CLEAR(predict_module_);
+        Py_CLEAR(train_module_);
+        Py_FinalizeEx();
+        finalized_ = true;
+        return false;
+    }
+
+    PyObject* capsule = PyCapsule_New(&stop_requested_, kStopFlagCapsule, nullptr);
+    should_stop_ = PyCFunction_New(&kShouldStopDef, capsule);
+    Py_DECREF(capsule);
+
+    std::string version = Py_GetVersion();
+    main_thread_state_ = PyEval_SaveThread(); // дальше GIL берут только вызовы
+    running_ = true;
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started_at).count();
+    logger_.info("Embedded Python " + version.substr(0, version.find(' ')) + " started in " +
+                 std::to_string(elapsed_ms) + " ms");
+    return true;
+}
+
+void EmbeddedPython::stop() {
+    if (!running_) {
+        return;
+    }
+
+    // Обучения проверяют should_stop() перед каждым пакетом и выходят через TrainingCancelled
+    stop_requested_ = true;
+    std::vector<TrainThread> threads;
+    {
+        std::lock_guard<std::mutex> lock(threads_mutex_);
+        threads.swap(train_threads_);
+    }
+    for (auto& train_thread : threads) {
+        train_thread.thread.join();
+    }
+
+    PyEval_RestoreThread(main_thread_state_);
+    main_thread_state_ = nullptr;
+    Py_CLEAR(should_stop_);
+    Py_CLEAR(predict_module_);
+    Py_CLEAR(train_module_);
+    Py_FinalizeEx();
+    running_ = false;
+    finalized_ = true;
+    logger_.info("Embedded Python stopped");
+}
+
+std::string EmbeddedPython::predictWithModel(const std::string& file_path, const std::string& model_name,
+                                             const std::string& base_name) {
+    if (!running_) {
+        return errorJson("Embedded Python is not running");
+    }
+    GilLock gil;
+    PyObject* result = PyObject_CallMethod(predict_module_, "pred", "sss", file_path.c_str(), model_name.c_str(),
+                                           base_name.c_str());
+    return predictionJson(result, model_name, base_name);
+}
+
+std::string EmbeddedPython::predictWithBuffers(const std::string& file_path, const std::string& model_name,
+                                               const std::string& base_name, const LearningBaseData& data) {
+    if (!running_) {
+        return errorJson("Embedded Python is not running");
+    }
+    GilLock gil;
+    PyObject* x_buffers = PyList_New(static_cast<Py_ssize_t>(data.x.size()));
+    for (size_t c = 0; c < data.x.size(); ++c) {
+        PyList_SET_ITEM(x_buffers, static_cast<Py_ssize_t>(c), floatView(data.x[c].data(), data.x[c].size()));
+    }
+    PyObject* y_buffer = floatView(data.y.data(), data.y.size());
+
+    // pred_buffers не сохраняет тензоры после возврата, поэтому память data можно не копировать
+    PyObject* result = PyObject_CallMethod(predict_module_, "pred_buffers", "OOnsss", x_buffers, y_buffer,
+                                           static_cast<Py_ssize_t>(data.num_samples), file_path.c_str(),
+                                           model_name.c_str(), base_name.c_str());
+    Py_DECREF(x_buffers);
+    Py_DECREF(y_buffer);
+    return predictionJson(result, model_name, base_name);
+}
+
+std::string EmbeddedPython::predictionJson(PyObject* result, const std::string& model_name,
+                                           const std::string& base_name) {
+    if (!result) {
+        return errorJson(fetchError());
+    }
+
+    Json::Value response;
+    PyObject* metrics = nullptr;
+    if (PyTuple_Check(result) && PyTuple_Size(result) == 2) {
+        response["output_path"] = toString(PyTuple_GET_ITEM(result, 0));
+        metrics = PyTuple_GET_ITEM(result, 1);
+    }
+    if (!metrics || !PyDict_Check(metrics)) {
+        Py_DECREF(result);
+        return errorJson("Unexpected result from ml.predict");
+    }
+
+    response["status"] = "success";
+    for (const char* name : {"mse", "r2", "test_loss"}) {
+        response["metrics"][name] = toDouble(PyDict_GetItemString(metrics, name));
+    }
+    response["message"] = "Prediction completed using " + model_name + " model trained on " + base_name;
+    Py_DECREF(result);
+    return writeJson(response);
+}
+
+void EmbeddedPython::trainModelAsync(const std::string& base_name, const std::string& base_path,
+                                     const std::string& config_path, const std::string& model_type,
+                                     TrainCallback callback) {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    // Закончившие потоки убираем здесь, иначе за долгую сессию они копились бы до stop()
+    for (auto it = train_threads_.begin(); it != train_threads_.end();) {
+        if (it->finished->load()) {
+            it->thread.join();
+            it = train_threads_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    
+    ++active_trainings_;
+    auto finished = std::make_shared<std::atomic<bool>>(false);
+    std::thread thread([this, base_name, base_path, config_path, model_type, callback, finished]() {
+        std::string result = trainModel(base_name, base_path, config_path, model_type);
+        --active_trainings_;
+        if (callback) {
+            callback(result);
+        }
+        *finished = true;
+    });
+    train_threads_.push_back(TrainThread{std::move(thread), finished});
+}
+
+std::string EmbeddedPython::trainModel(const std::string& base_name, const std::string& base_path,
+                                       const std::string& config_path, const std::string& model_type) {
+    if (!running_) {
+        return errorJson("Embedded Python is not running");
+    }
+    GilLock gil;
+    PyObject* train = PyObject_GetAttrString(train_module_, "train");
+    PyObject* args = Py_BuildValue("(ssss)", base_name.c_str(), base_path.c_str(), config_path.c_str(),
+                                   model_type.c_str());
+    PyObject* kwargs = Py_BuildValue("{s:O}", "should_stop", should_stop_);
+    PyObject* result = train && args && kwargs ? PyObject_Call(train, args, kwargs) : nullptr;
+    Py_XDECREF(train);
+    Py_XDECREF(args);
+    Py_XDECREF(kwargs);
+    if (!result) {
+        return errorJson(fetchError());
+    }
+
+    // (best_test_loss, weights_path, best_r2) - как в ответе /train
+    Json::Value response;
+    if (!PyTuple_Check(result) || PyTuple_Size(result) != 3) {
+        Py_DECREF(result);
+        return errorJson("Unexpected result from ml.train");
+    }
+    response["status"] = "success";
+    response["message"] = "Training completed for " + base_name;
+    response["model_type"] = model_type;
+    response["best_loss"] = toDouble(PyTuple_GET_ITEM(result, 0));
+    response["weights_path"] = toString(PyTuple_GET_ITEM(result, 1));
+    response["accuracy"] = toDouble(PyTuple_GET_ITEM(result, 2));
+    Py_DECREF(result);
+    return writeJson(response);
+}
+
+bool EmbeddedPython::ping(const float* data, size_t count) {
+    if (!running_) {
+        return false;
+    }
+    GilLock gil;
+    PyObject* view = floatView(data, count);
+    PyObject* len = PyDict_GetItemString(PyEval_GetBuiltins(), "len");
+    PyObject* result = len ? PyObject_CallFunctionObjArgs(len, view, nullptr) : nullptr;
+    bool ok = result != nullptr;
+    Py_XDECREF(result);
+    Py_DECREF(view);
+    if (!ok) {
+        PyErr_Clear();
+    }
+    return ok;
+}
@@ -0,0 +1,79 @@
+#ifndef EMBEDDED_PYTHON_H
+#define EMBEDDED_PYTHON_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "learning_base_parser.h"
+#include "logger.h"
+
+struct _object;
+struct _ts;
+
+// CPython внутри процесса клиента (сборка с RESSYS_EMBED_PYTHON): ml.predict и
+// ml.train импортируются один раз при start(), вызовы идут напрямую без сервера,
+// /health и JSON по сети. Каналы X/Y передаются как memoryview поверх памяти
+// LearningBaseData (buffer protocol, без копий). Главный поток держит GIL только
+// внутри вызовов, поэтому обучение в фоне не блокирует консоль.
+// Ответы - тот же JSON, что вернули бы /predict и /train сервера.
+class EmbeddedPython {
+public:
+    using TrainCallback = std::function<void(const std::string& result_json)>;
+
+    explicit EmbeddedPython(Logger& logger);
+    ~EmbeddedPython();
+
+    EmbeddedPython(const EmbeddedPython&) = delete;
+    EmbeddedPython& operator=(const EmbeddedPython&) = delete;
+
+    // server_dir - каталог main.py (в sys.path), python_home - каталог python.exe (пусто - системный).
+    // Интерпретатор поднимается один раз за процесс: после stop() снова не запускается
+    bool start(const std::string& server_dir, const std::string& python_home);
+    // Отменяет фоновые обучения, дожидается их и завершает интерпретатор
+    void stop();
+
+    bool isRunning() const { return running_; }
+    const std::string& lastError() const { return last_error_; }
+
+    std::string predictWithModel(const std::string& file_path, const std::string& model_name,
+                                 const std::string& base_name);
+    // Данные уже разобраны клиентом; буферы data живут до конца вызова
+    std::string predictWithBuffers(const std::string& file_path, const std::string& model_name,
+                                   const std::string& base_name, const LearningBaseData& data);
+    // Обучение в отдельном потоке; callback вызывается из него же по окончании
+    void trainModelAsync(const std::string& base_name, const std::string& base_path, const std::string& config_path,
+                         const std::string& model_type, TrainCallback callback);
+    size_t activeTrainings() const { return active_trainings_.load(); }
+
+    // Пустой вызов (len(memoryview)) тем же путём - GIL, буфер, вызов; для замера накладных расходов
+    bool ping(const float* data, size_t count);
+
+private:
+    Logger& logger_;
+    bool running_ = false;
+    bool finalized_ = false;
+    std::string last_error_;
+    _ts* main_thread_state_ = nullptr;
+    _object* predict_module_ = nullptr;
+    _object* train_module_ = nullptr;
+    _object* should_stop_ = nullptr; // callable для train(should_stop=...)
+
+    std::atomic<bool> stop_requested_{false};
+    std::atomic<size_t> active_trainings_{0};
+    std::mutex threads_mutex_;
+    struct TrainThread {
+        std::thread thread;
+        std::shared_ptr<std::atomic<bool>> finished; // поток вот-вот выйдет, join не ждёт обучения
+    };
+    std::vector<TrainThread> train_threads_;
+
+    std::string trainModel(const std::string& base_name, const std::string& base_path,
+                           const std::string& config_path, const std::string& model_type);
+    std::string predictionJson(_object* result, const std::string& model_name, const std::string& base_name);
+};
+
+#endif // EMBEDDED_PYTHON_H
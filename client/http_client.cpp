@@ -1,21 +1,136 @@
 #include "http_client.h"
 #include "logger.h"
+#include "curl_handle_pool.h"
+#include "http_metrics.h"
+#include "trace_recorder.h"
+#include "json_stream.h"
 #include <curl/curl.h>
+#include <algorithm>
+#include <cctype>
+#include <thread>
 #include <iostream>
 #include <sstream>
 #include <json/json.h>
 
+namespace {
+
+// Percent-encoding для параметров запроса (RFC 3986, unreserved остаются как есть)
+std::string urlEncode(const std::string& value) {
+    static const char digits[] = "0123456789ABCDEF";
+    std::string encoded;
+    encoded.reserve(value.size() * 3);
+    for (unsigned char c : value) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            encoded += static_cast<char>(c);
+        } else {
+            encoded += '%';
+            encoded += digits[c >> 4];
+            encoded += digits[c & 0xF];
+        }
+    }
+    return encoded;
+}
+
+// {"status": "healthy", "model_loaded": true, ...}: два поля верхнего уровня без дерева jsoncpp
+class HealthDecoder : public HttpBodyDecoder, private JsonStreamParser::Handler {
+public:
+    HealthDecoder() : parser_(*this) {}
+    
+    bool feed(const char* data, size_t size) override {
+        parser_.feed(data, size);
+        return true;
+    }
+    void finish() override { complete_ = parser_.finish(); }
+    bool healthy() const { return complete_ && healthy_ && model_loaded_; }
+    
+private:
+    bool startObject() override { return ++depth_ > 0; }
+    bool endObject() override { return --depth_ >= 0; }
+    bool startArray() override { return ++depth_ > 1; }
+    bool endArray() override { return --depth_ >= 0; }
+    bool key(std::string_view name) override {
+        if (depth_ == 1) {
+            field_ = name;
+        }
+        return true;
+    }
+    bool string(std::string_view value) override {
+        if (depth_ == 1 && field_ == "status") {
+            healthy_ = value == "healthy";
+        }
+        return true;
+    }
+    bool boolean(bool value) override {
+        if (depth_ == 1 && field_ == "model_loaded") {
+            model_loaded_ = value;
+        }
+        return true;
+    }
+    
+    JsonStreamParser parser_;
+    int depth_ = 0;
+    std::string field_;
+    bool complete_ = false;
+    bool healthy_ = false;
+    bool model_loaded_ = false;
+};
+
+} // namespace
+
+// Состояние асинхронного вызова по политике: попытки завершаются в потоках циклов
+// разных движков (основного клиента и воркера с дублем)
+struct HttpClient::PolicyCall {
+    explicit PolicyCall(const RequestPolicy& call_policy) : policy(call_policy), deadline(call_policy.timeout_ms) {}
+    
+    HttpClient* client = nullptr;      // основной сервер, повторы - тоже на него
+    std::string method;
+    std::string endpoint;
+    std::shared_ptr<const std::string> body;
+    bool binary = false;
+    std::string trace_id;
+    RequestPolicy policy;
+    RequestDeadline deadline;
+    AsyncHttpEngine::Callback callback;
+    HttpDecoderFactory make_decoder;   // свой декодер на каждую попытку
+    std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+    
+    std::mutex mutex;
+    int attempts = 0;                  // завершённых попыток, считая дубль
+    int primary_attempts = 0;          // отправленных на основной сервер - их ограничивает max_attempts
+    int outstanding = 0;               // попыток в очереди и в полёте
+    bool finished = false;
+};
+
 HttpClient::HttpClient(const std::string& host, int port, int timeout_ms, Logger* logger)
-    : host_(host), port_(port), timeout_ms_(timeout_ms), logger_(logger) {
-    curl_global_init(CURL_GLOBAL_DEFAULT);
+    : host_(host), port_(port), logger_(logger) {
+    base_url_ = "http://" + host_ + ":" + std::to_string(port_);
+    default_policy_.timeout_ms = timeout_ms;
+    json_headers_ = curl_slist_append(json_headers_, "Content-Type: application/json");
+    json_headers_ = curl_slist_append(json_headers_, "Expect:"); // без лишнего 100-continue
+    binary_headers_ = curl_slist_append(binary_headers_, "Content-Type: application/octet-stream");
+    binary_headers_ = curl_slist_append(binary_headers_, "Expect:");
+}
+
+void HttpClient::setPort(int port) {
+    port_ = port;
+    base_url_ = "http://" + host_ + ":" + std::to_string(port_);
 }
 
 HttpClient::~HttpClient() {
-    curl_global_cleanup();
+    streams_.reset();
+    async_.reset(); // запросы в полёте ещё ссылаются на json_headers_
+    curl_slist_free_all(json_headers_);
+    curl_slist_free_all(binary_headers_);
 }
 
 std::string HttpClient::buildUrl(const std::string& endpoint) {
-    return "http://" + host_ + ":" + std::to_string(port_) + endpoint;
+    return base_url_ + endpoint;
+}
+
+std::string HttpClient::traceId() {
+    // trace id берётся в потоке вызывающего - там, где открыт его TraceSpan
+    TraceRecorder& tracer = TraceRecorder::instance();
+    return tracer.enabled() ? tracer.requestTraceId() : std::string();
 }
 
 size_t HttpClient::writeCallback(void* contents, size_t size, size_t nmemb, std::string* response) {
@@ -24,79 +139,180 @@ size_t HttpClient::writeCallback(void* contents, size_t size, size_t nmemb, std:
     return totalSize;
 }
 
-std::string HttpClient::get(const std::string& endpoint) {
-    CURL* curl = curl_easy_init();
-    std::string response;
+size_t HttpClient::decodeCallback(char* contents, size_t size, size_t nmemb, void* decoder) {
+    size_t total = size * nmemb;
+    return static_cast<HttpBodyDecoder*>(decoder)->feed(contents, total) ? total : 0;
+}
+
+void HttpClient::setEndpointPolicy(const std::string& endpoint, const RequestPolicy& policy) {
+    endpoint_policies_[endpoint] = policy;
+}
+
+RequestPolicy HttpClient::policyFor(const std::string& endpoint) const {
+    if (!endpoint_policies_.empty()) {
+        std::string server, path;
+        HttpMetrics::splitUrl(base_url_ + endpoint, server, path);
+        auto it = endpoint_policies_.find(path);
+        if (it != endpoint_policies_.end()) {
+            return it->second;
+        }
+    }
+    return default_policy_;
+}
+
+const curl_slist* HttpClient::headersFor(const std::string& method, bool binary) const {
+    if (method != "POST") {
+        return nullptr;
+    }
+    return binary ? binary_headers_ : json_headers_;
+}
+
+HttpResponse HttpClient::perform(const std::string& method, const std::string& endpoint, const std::string& body,
+                                 bool binary, long timeout_ms, std::shared_ptr<HttpBodyDecoder> decoder) {
+    HttpResponse response;
+    PooledCurlHandle handle;
+    if (!handle) {
+        response.result = CURLE_FAILED_INIT;
+        response.error = "curl_easy_init failed";
+        return response;
+    }
+    CURL* curl = handle.get();
+    std::string url = buildUrl(endpoint);
+    const curl_slist* headers = headersFor(method, binary);
     
-    if (curl) {
-        std::string url = buildUrl(endpoint);
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    // С трассировкой заголовки копируются ради X-Trace-Id; сервер отвечает своими интервалами
+    TraceRecorder& tracer = TraceRecorder::instance();
+    std::string trace_id, trace_spans;
+    curl_slist* traced_headers = nullptr;
+    if (tracer.enabled()) {
+        trace_id = tracer.requestTraceId();
+        traced_headers = TraceRecorder::withTraceHeader(headers, trace_id);
+        headers = traced_headers;
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, TraceRecorder::receiveHeader);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &trace_spans);
+    }
+    if (headers) {
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    }
+    if (method == "POST") {
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.data());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(body.size()));
+    }
+    
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    if (decoder) {
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, decodeCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, decoder.get());
+    } else {
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_ms_);
-        
-        CURLcode res = curl_easy_perform(curl);
-        if (res != CURLE_OK && logger_) {
-            std::string error_msg = "HTTP GET failed: " + std::string(curl_easy_strerror(res));
-            logger_->error(error_msg);
-        }
-        
-        curl_easy_cleanup(curl);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response.body);
+    }
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_ms);
+    if (!unix_socket_path_.empty()) {
+        curl_easy_setopt(curl, CURLOPT_UNIX_SOCKET_PATH, unix_socket_path_.c_str());
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    CURLcode res = curl_easy_perform(curl);
+    HttpMetrics::instance().recordTransfer(curl, url, res);
+    if (traced_headers) {
+        tracer.recordTransfer(curl, url, method.c_str(), trace_id, trace_spans);
+        curl_slist_free_all(traced_headers);
     }
     
+    response.ok = res == CURLE_OK;
+    response.result = res;
+    if (!response.ok) {
+        response.error = curl_easy_strerror(res);
+    }
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.status);
+    if (decoder) {
+        if (response.ok) {
+            decoder->finish();
+        }
+        response.decoded = std::move(decoder);
+    }
+    response.elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
     return response;
 }
 
-std::string HttpClient::post(const std::string& endpoint, const std::string& json_data) {
-    CURL* curl = curl_easy_init();
-    std::string response;
+HttpResponse HttpClient::call(const std::string& method, const std::string& endpoint, const std::string& body,
+                              bool binary, const HttpDecoderFactory& make_decoder) {
+    RequestPolicy policy = policyFor(endpoint);
+    policy.idempotent = policy.idempotent || method == "GET";
+    if (policy.hedge_after_ms > 0 && policy.idempotent && hedge_peers_) {
+        // Дубль требует двух запросов сразу - через асинхронные движки, ждём здесь
+        auto promise = std::make_shared<std::promise<HttpResponse>>();
+        std::future<HttpResponse> future = promise->get_future();
+        submit(method, endpoint, body, binary, policy, [promise](HttpResponse&& response) {
+            promise->set_value(std::move(response));
+        }, make_decoder);
+        return future.get();
+    }
     
-    if (curl) {
-        std::string url = buildUrl(endpoint);
-        
-        struct curl_slist* headers = nullptr;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
+    RequestDeadline deadline(policy.timeout_ms);
+    HttpResponse response;
+    for (int attempt = 1;; ++attempt) {
+        response = perform(method, endpoint, body, binary, deadline.attemptTimeoutMs(policy, std::chrono::milliseconds(0)),
+                           make_decoder ? make_decoder() : nullptr);
+        response.attempts = attempt;
         
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_data.c_str());
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, json_data.length());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeout_ms_);
-        
-        CURLcode res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
-            std::string error_msg = "HTTP POST failed: " + std::string(curl_easy_strerror(res));
-            logger_->error(error_msg);
+        std::chrono::milliseconds delay;
+        if (!nextAttempt(policy, deadline, attempt, response, delay)) {
+            break;
         }
-        
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
+        if (logger_) {
+            logger_->warning("HTTP " + method + " " + endpoint + " attempt " + std::to_string(attempt) + " failed (" +
+                             (response.ok ? "status " + std::to_string(response.status) : response.error) +
+                             "), retry in " + std::to_string(delay.count()) + " ms");
+        }
+        std::this_thread::sleep_for(delay);
     }
-    
+    response.elapsed_ms = static_cast<double>(deadline.elapsedMs());
+    response.budget_left_ms = deadline.remainingMs();
     return response;
 }
 
+std::string HttpClient::responseBody(const std::string& method, const std::string& endpoint, HttpResponse&& response) {
+    if (logger_) {
+        std::string attempts = response.attempts > 1 ? ", " + std::to_string(response.attempts) + " attempts" : "";
+        if (!response.ok) {
+            logger_->error("HTTP " + method + " failed: " + response.error + attempts);
+        } else if (logger_->isEnabled(Logger::Level::Debug)) {
+            logger_->debug("HTTP " + method + " " + endpoint + ": " + std::to_string(response.status) + " in " +
+                           std::to_string(static_cast<long>(response.elapsed_ms)) + " ms" + attempts +
+                           (response.hedged ? ", hedged" : "") +
+                           (response.budget_left_ms >= 0 ? ", budget left " + std::to_string(response.budget_left_ms) +
+                                                               " ms" : ""));
+        }
+    }
+    return std::move(response.body);
+}
+
+std::string HttpClient::get(const std::string& endpoint) {
+    return responseBody("GET", endpoint, call("GET", endpoint));
+}
+
+std::string HttpClient::post(const std::string& endpoint, const std::string& json_data) {
+    return responseBody("POST", endpoint, call("POST", endpoint, json_data));
+}
+
 bool HttpClient::healthCheck() {
     try {
-        std::string response = get("/health");
-        Json::Value json;
-        Json::Reader reader;
-        
-        if (reader.parse(response, json)) {
-            return json["status"].asString() == "healthy" && 
-                   json["model_loaded"].asBool();
-        }
+        HttpResponse response = call("GET", "/health", "", false, []() { return std::make_shared<HealthDecoder>(); });
+        auto decoder = std::static_pointer_cast<HealthDecoder>(response.decoded);
+        bool healthy = response.ok && decoder && decoder->healthy();
+        responseBody("GET", "/health", std::move(response)); // только журнал
+        return healthy;
     } catch (...) {
         // Ignore errors, return false
     }
     return false;
 }
 
-std::string HttpClient::trainModel(const std::string& base_name, const std::string& base_path,
-                                  const std::string& config_path, const std::string& model_type) {
+std::string HttpClient::trainRequestJson(const std::string& base_name, const std::string& base_path,
+                                         const std::string& config_path, const std::string& model_type) {
     Json::Value request;
     request["base_name"] = base_name;
     request["base_path"] = base_path;
@@ -104,19 +320,234 @@ std::string HttpClient::trainModel(const std::string& base_name, const std::stri
     request["model_type"] = model_type;
     
     Json::StreamWriterBuilder writer;
-    std::string json_request = Json::writeString(writer, request);
-    
-    return post("/train", json_request);
+    return Json::writeString(writer, request);
 }
 
-std::string HttpClient::predictWithModel(const std::string& file_path, const std::string& model_name, const std::string& base_name) {
+std::string HttpClient::predictRequestJson(const std::string& file_path, const std::string& model_name,
+                                           const std::string& base_name) {
     Json::Value request;
     request["file_path"] = file_path;
     request["model_name"] = model_name;
     request["base_name"] = base_name;
     
     Json::StreamWriterBuilder writer;
-    std::string json_request = Json::writeString(writer, request);
+    return Json::writeString(writer, request);
+}
+
+std::string HttpClient::predictBinaryEndpoint(const std::string& file_path, const std::string& model_name,
+                                              const std::string& base_name, bool inline_predictions) {
+    return "/predict/binary?file_path=" + urlEncode(file_path) + "&model_name=" + urlEncode(model_name) +
+           "&base_name=" + urlEncode(base_name) + (inline_predictions ? "&inline=1" : "");
+}
+
+std::string HttpClient::trainModel(const std::string& base_name, const std::string& base_path,
+                                  const std::string& config_path, const std::string& model_type) {
+    return post("/train", trainRequestJson(base_name, base_path, config_path, model_type));
+}
+
+std::string HttpClient::predictWithModel(const std::string& file_path, const std::string& model_name, const std::string& base_name) {
+    return post("/predict", predictRequestJson(file_path, model_name, base_name));
+}
+
+std::string HttpClient::predictWithModelBinary(const std::string& file_path, const std::string& model_name,
+                                               const std::string& base_name, const std::string& payload) {
+    std::string endpoint = predictBinaryEndpoint(file_path, model_name, base_name);
+    return responseBody("POST", endpoint, call("POST", endpoint, payload, true));
+}
+
+bool HttpClient::predictWithModelBinaryInline(const std::string& file_path, const std::string& model_name,
+                                              const std::string& base_name, const std::string& payload,
+                                              size_t expected_count, PredictionReply& reply, std::string& error) {
+    std::string endpoint = predictBinaryEndpoint(file_path, model_name, base_name, true);
+    HttpResponse response = call("POST", endpoint, payload, true, [expected_count]() {
+        return std::make_shared<PredictionReplyDecoder>(expected_count);
+    });
+    bool ok = takePredictionReply(response, reply, error);
+    responseBody("POST", endpoint, std::move(response)); // только журнал: тело ушло в декодер
+    return ok;
+}
+
+void HttpClient::setMaxConcurrency(size_t max_concurrency) {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    max_concurrency_ = max_concurrency;
+    if (async_) {
+        async_->setMaxConcurrency(max_concurrency);
+    }
+}
+
+AsyncHttpEngine& HttpClient::asyncEngine() {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    if (!async_) {
+        async_ = std::make_unique<AsyncHttpEngine>(max_concurrency_);
+    }
+    return *async_;
+}
+
+AsyncHttpEngine& HttpClient::streamEngine() {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    if (!streams_) {
+        streams_ = std::make_unique<AsyncHttpEngine>(64);
+    }
+    return *streams_;
+}
+
+HttpClient* HttpClient::hedgePeer(const RequestPolicy& policy) {
+    if (policy.hedge_after_ms <= 0 || !policy.idempotent || !hedge_peers_) {
+        return nullptr;
+    }
+    std::vector<HttpClient*> peers = hedge_peers_();
+    peers.erase(std::remove(peers.begin(), peers.end(), this), peers.end());
+    if (peers.empty()) {
+        return nullptr;
+    }
+    return peers[next_hedge_peer_++ % peers.size()];
+}
+
+void HttpClient::submit(const std::string& method, const std::string& endpoint, std::string body, bool binary,
+                        const RequestPolicy& policy, AsyncHttpEngine::Callback callback,
+                        HttpDecoderFactory make_decoder) {
+    auto call = std::make_shared<PolicyCall>(policy);
+    call->policy.idempotent = policy.idempotent || method == "GET";
+    call->client = this;
+    call->method = method;
+    call->endpoint = endpoint;
+    call->body = std::make_shared<const std::string>(std::move(body));
+    call->binary = binary;
+    call->trace_id = traceId();
+    call->callback = std::move(callback);
+    call->make_decoder = std::move(make_decoder);
     
-    return post("/predict", json_request);
-}
\ No newline at end of file
+    startAttempt(call, *this, std::chrono::milliseconds(0), false);
+    if (HttpClient* peer = hedgePeer(call->policy)) {
+        startAttempt(call, *peer, std::chrono::milliseconds(call->policy.hedge_after_ms), true);
+    }
+}
+
+void HttpClient::startAttempt(const std::shared_ptr<PolicyCall>& call, HttpClient& target,
+                              std::chrono::milliseconds delay, bool hedge) {
+    HttpRequest request;
+    request.url = target.buildUrl(call->endpoint);
+    request.method = call->method;
+    request.shared_body = call->body;
+    request.headers = target.headersFor(call->method, call->binary);
+    request.timeout_ms = call->deadline.attemptTimeoutMs(call->policy, delay);
+    request.unix_socket_path = target.unix_socket_path_;
+    request.trace_id = call->trace_id;
+    request.not_before = std::chrono::steady_clock::now() + delay;
+    request.cancelled = call->cancelled;
+    if (call->make_decoder) {
+        request.decoder = call->make_decoder();
+    }
+    {
+        std::lock_guard<std::mutex> lock(call->mutex);
+        ++call->outstanding;
+        if (!hedge) {
+            ++call->primary_attempts;
+        }
+    }
+    target.asyncEngine().submit(std::move(request), [call, hedge](HttpResponse&& response) {
+        finishAttempt(call, std::move(response), hedge);
+    });
+}
+
+void HttpClient::finishAttempt(const std::shared_ptr<PolicyCall>& call, HttpResponse&& response, bool hedge) {
+    std::unique_lock<std::mutex> lock(call->mutex);
+    --call->outstanding;
+    if (call->finished) {
+        return; // проигравший дубль или попытка, снятая после ответа другой
+    }
+    ++call->attempts;
+    
+    // Выигрывает только успешный ответ; неудача (и 500 тоже) - лишь когда ждать больше некого
+    const bool succeeded = response.ok && response.status < 400;
+    if (!succeeded && call->outstanding > 0) {
+        return; // ответ ещё может дать другая попытка
+    }
+    if (isRetryable(response, call->policy.idempotent)) {
+        std::chrono::milliseconds delay;
+        if (nextAttempt(call->policy, call->deadline, call->primary_attempts, response, delay)) {
+            lock.unlock();
+            if (Logger* logger = call->client->logger_) {
+                logger->warning("HTTP " + call->method + " " + call->endpoint + " attempt " +
+                                std::to_string(call->primary_attempts) + " failed (" +
+                                (response.ok ? "status " + std::to_string(response.status) : response.error) +
+                                "), retry in " + std::to_string(delay.count()) + " ms");
+            }
+            startAttempt(call, *call->client, delay, false);
+            return;
+        }
+    }
+    
+    call->finished = true;
+    call->cancelled->store(true); // второй запрос больше не нужен
+    response.attempts = call->attempts;
+    response.hedged = hedge;
+    response.elapsed_ms = static_cast<double>(call->deadline.elapsedMs());
+    response.budget_left_ms = call->deadline.remainingMs();
+    AsyncHttpEngine::Callback callback = std::move(call->callback);
+    lock.unlock();
+    
+    callback(std::move(response));
+}
+
+std::future<HttpResponse> HttpClient::getAsync(const std::string& endpoint) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    std::future<HttpResponse> future = promise->get_future();
+    submit("GET", endpoint, "", false, policyFor(endpoint), [promise](HttpResponse&& response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+void HttpClient::getStream(const std::string& endpoint, HttpDataCallback on_data, AsyncHttpEngine::Callback on_done) {
+    HttpRequest request;
+    request.url = buildUrl(endpoint);
+    request.timeout_ms = 0; // поток живёт, пока сервер его не закроет
+    request.unix_socket_path = unix_socket_path_;
+    request.on_data = std::move(on_data);
+    streamEngine().submit(std::move(request), std::move(on_done));
+}
+
+std::future<HttpResponse> HttpClient::postAsync(const std::string& endpoint, const std::string& json_data) {
+    auto promise = std::make_shared<std::promise<HttpResponse>>();
+    std::future<HttpResponse> future = promise->get_future();
+    postAsync(endpoint, json_data, [promise](HttpResponse&& response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+void HttpClient::postAsync(const std::string& endpoint, const std::string& json_data, AsyncHttpEngine::Callback callback,
+                           long timeout_ms) {
+    RequestPolicy policy = policyFor(endpoint);
+    if (timeout_ms >= 0) {
+        policy.timeout_ms = timeout_ms;
+    }
+    submit("POST", endpoint, json_data, false, policy, std::move(callback));
+}
+
+std::future<HttpResponse> HttpClient::trainModelAsync(const std::string& base_name, const std::string& base_path,
+                                                      const std::string& config_path, const std::string& model_type) {
+    return postAsync("/train", trainRequestJson(base_name, base_path, config_path, model_type));
+}
+
+std::future<HttpResponse> HttpClient::predictWithModelAsync(const std::string& file_path, const std::string& model_name,
+                                                            const std::string& base_name) {
+    return postAsync("/predict", predictRequestJson(file_path, model_name, base_name));
+}
+
+void HttpClient::predictWithModelBinaryAsync(const std::string& file_path, const std::string& model_name,
+                                             const std::string& base_name, std::string payload,
+                                             AsyncHttpEngine::Callback callback) {
+    std::string endpoint = predictBinaryEndpoint(file_path, model_name, base_name);
+    submit("POST", endpoint, std::move(payload), true, policyFor(endpoint), std::move(callback));
+}
+
+void HttpClient::predictWithModelBinaryInlineAsync(const std::string& file_path, const std::string& model_name,
+                                                   const std::string& base_name, std::string payload,
+                                                   size_t expected_count, AsyncHttpEngine::Callback callback) {
+    std::string endpoint = predictBinaryEndpoint(file_path, model_name, base_name, true);
+    submit("POST", endpoint, std::move(payload), true, policyFor(endpoint), std::move(callback), [expected_count]() {
+        return std::make_shared<PredictionReplyDecoder>(expected_count);
+    });
+}
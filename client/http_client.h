@@ -4,31 +4,136 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <future>
+#include <atomic>
+#include <curl/curl.h>
 #include "logger.h"
+#include "async_http_engine.h"
+#include "request_policy.h"
+#include "prediction_reply.h"
 
 class HttpClient {
 public:
+    // timeout_ms - срок вызова в политике по умолчанию (без повторов)
     HttpClient(const std::string& host, int port, int timeout_ms = 5000, Logger* logger = nullptr);
     ~HttpClient(); //деструктор;)
 
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
     // Основные методы
     std::string get(const std::string& endpoint);
     std::string post(const std::string& endpoint, const std::string& json_data);
     
+    // Политики вызовов: задаются до первых запросов. Endpoint - путь без query,
+    // id заданий как {id} (см. HttpMetrics::splitUrl); остальные - политика по умолчанию.
+    // GET всегда считается идемпотентным
+    void setDefaultPolicy(const RequestPolicy& policy) { default_policy_ = policy; }
+    void setEndpointPolicy(const std::string& endpoint, const RequestPolicy& policy);
+    RequestPolicy policyFor(const std::string& endpoint) const;
+    // Серверы для дублей идемпотентных запросов (hedge_after_ms > 0), сам клиент отбрасывается
+    void setHedgePeers(std::function<std::vector<HttpClient*>()> peers) { hedge_peers_ = std::move(peers); }
+    
+    // Вызов по политике endpoint-а: ответ целиком, с числом попыток и остатком срока.
+    // make_decoder задан - тело каждой попытки разбирается по мере приёма своим декодером,
+    // декодер попытки, давшей ответ, - в HttpResponse::decoded
+    HttpResponse call(const std::string& method, const std::string& endpoint, const std::string& body = "",
+                      bool binary = false, const HttpDecoderFactory& make_decoder = nullptr);
+    
     // Специальные методы сервера
     bool healthCheck();
     std::string trainModel(const std::string& base_name, const std::string& base_path, 
                       const std::string& config_path, const std::string& model_type);
     std::string predictWithModel(const std::string& file_path, const std::string& model_name, const std::string& base_name);
+    // X/Y уже разобраны клиентом: тело - payload из encodePredictionPayload
+    std::string predictWithModelBinary(const std::string& file_path, const std::string& model_name,
+                                       const std::string& base_name, const std::string& payload);
+    // То же с предсказаниями в ответе (inline=1): файл на сервере не пишется, числа разбираются
+    // по мере приёма прямо в reply.predictions; expected_count - записей * целей
+    bool predictWithModelBinaryInline(const std::string& file_path, const std::string& model_name,
+                                      const std::string& base_name, const std::string& payload,
+                                      size_t expected_count, PredictionReply& reply, std::string& error);
+    
+    // Порт сервера ([server] port): задаётся до первых запросов
+    void setPort(int port);
+    
+    // Транспорт через Unix domain socket (uvicorn --uds); пустой путь - обычный TCP.
+    // URL остаётся http://host:port/..., host уходит только в заголовок Host
+    void setUnixSocketPath(const std::string& socket_path) { unix_socket_path_ = socket_path; }
+    const std::string& unixSocketPath() const { return unix_socket_path_; }
+    
+    // Асинхронные методы (общий поток curl_multi, не больше max_concurrency запросов сразу)
+    void setMaxConcurrency(size_t max_concurrency);
+    std::future<HttpResponse> getAsync(const std::string& endpoint);
+    std::future<HttpResponse> postAsync(const std::string& endpoint, const std::string& json_data);
+    void postAsync(const std::string& endpoint, const std::string& json_data, AsyncHttpEngine::Callback callback,
+                   long timeout_ms = -1); // -1 - срок из политики endpoint-а, 0 - без ограничения
+    std::future<HttpResponse> trainModelAsync(const std::string& base_name, const std::string& base_path,
+                                              const std::string& config_path, const std::string& model_type);
+    std::future<HttpResponse> predictWithModelAsync(const std::string& file_path, const std::string& model_name,
+                                                    const std::string& base_name);
+    // Долгий потоковый GET (SSE): тело отдаётся по кускам в on_data. Идёт через
+    // отдельный движок, чтобы не занимать слоты max_concurrency на всё время потока
+    void getStream(const std::string& endpoint, HttpDataCallback on_data, AsyncHttpEngine::Callback on_done);
+    void predictWithModelBinaryAsync(const std::string& file_path, const std::string& model_name,
+                                     const std::string& base_name, std::string payload,
+                                     AsyncHttpEngine::Callback callback);
+    // Ответ в callback - через takePredictionReply
+    void predictWithModelBinaryInlineAsync(const std::string& file_path, const std::string& model_name,
+                                           const std::string& base_name, std::string payload, size_t expected_count,
+                                           AsyncHttpEngine::Callback callback);
+    
+    static std::string trainRequestJson(const std::string& base_name, const std::string& base_path,
+                                        const std::string& config_path, const std::string& model_type);
+    static std::string predictRequestJson(const std::string& file_path, const std::string& model_name,
+                                          const std::string& base_name);
+    // /predict/binary?file_path=...&model_name=...&base_name=...[&inline=1]
+    static std::string predictBinaryEndpoint(const std::string& file_path, const std::string& model_name,
+                                             const std::string& base_name, bool inline_predictions = false);
     
 private:
+    struct PolicyCall;
+    
     std::string host_;
     int port_;
-    int timeout_ms_;
     Logger* logger_; 
+    std::string base_url_;
+    std::string unix_socket_path_;
+    struct curl_slist* json_headers_ = nullptr; // собирается один раз на клиента
+    struct curl_slist* binary_headers_ = nullptr;
+    
+    size_t max_concurrency_ = 4;
+    std::mutex async_mutex_;
+    std::unique_ptr<AsyncHttpEngine> async_; // создаётся при первом асинхронном запросе
+    std::unique_ptr<AsyncHttpEngine> streams_;
+    
+    RequestPolicy default_policy_;
+    std::map<std::string, RequestPolicy> endpoint_policies_;
+    std::function<std::vector<HttpClient*>()> hedge_peers_;
+    std::atomic<size_t> next_hedge_peer_{0};
     
     std::string buildUrl(const std::string& endpoint);
+    static std::string traceId(); // пусто - трассировка выключена
+    AsyncHttpEngine& asyncEngine();
+    AsyncHttpEngine& streamEngine();
+    const curl_slist* headersFor(const std::string& method, bool binary) const;
+    HttpClient* hedgePeer(const RequestPolicy& policy);
+    // Асинхронный вызов по политике: попытки уходят в движок основного клиента, дубль - в движок воркера
+    void submit(const std::string& method, const std::string& endpoint, std::string body, bool binary,
+                const RequestPolicy& policy, AsyncHttpEngine::Callback callback,
+                HttpDecoderFactory make_decoder = nullptr);
+    static void startAttempt(const std::shared_ptr<PolicyCall>& call, HttpClient& target,
+                             std::chrono::milliseconds delay, bool hedge);
+    static void finishAttempt(const std::shared_ptr<PolicyCall>& call, HttpResponse&& response, bool hedge);
+    // Одна синхронная попытка на соединении из пула, в потоке вызывающего
+    HttpResponse perform(const std::string& method, const std::string& endpoint, const std::string& body, bool binary,
+                         long timeout_ms, std::shared_ptr<HttpBodyDecoder> decoder = nullptr);
+    std::string responseBody(const std::string& method, const std::string& endpoint, HttpResponse&& response);
     static size_t writeCallback(void* contents, size_t size, size_t nmemb, std::string* response);
+    static size_t decodeCallback(char* contents, size_t size, size_t nmemb, void* decoder);
 };
 
 #endif // HTTP_CLIENT_H
\ No newline at end of file
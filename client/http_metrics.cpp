@@ -0,0 +1,321 @@
+#include "http_metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* const kPhaseNames[HttpEndpointMetrics::kPhaseCount] = {"dns", "connect", "ttfb", "total"};
+const double kQuantiles[] = {0.5, 0.95, 0.99};
+
+int highestBit(uint64_t value) {
+    int bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+}
+
+uint64_t nonNegative(curl_off_t value) {
+    return value > 0 ? static_cast<uint64_t>(value) : 0;
+}
+
+// Значение метки в кавычках: \, " и перевод строки экранируются
+std::string labelValue(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size() + 2);
+    escaped += '"';
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    escaped += '"';
+    return escaped;
+}
+
+} // namespace
+
+int LatencyHistogram::bucketIndex(uint64_t micros) {
+    const uint64_t limit = (uint64_t{1} << kMaxMagnitude) - 1;
+    micros = std::min(micros, limit);
+    if (micros < 2 * kSubBuckets) {
+        return static_cast<int>(micros);
+    }
+    // Октава [2^m, 2^(m+1)) делится на kSubBuckets корзин шириной 2^(m - kSubBucketBits)
+    const int magnitude = highestBit(micros);
+    const int shift = magnitude - kSubBucketBits;
+    return (shift + 1) * kSubBuckets + static_cast<int>((micros >> shift) - kSubBuckets);
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(int index) {
+    if (index < 2 * kSubBuckets) {
+        return static_cast<uint64_t>(index);
+    }
+    const int shift = index / kSubBuckets - 1;
+    return static_cast<uint64_t>(index % kSubBuckets + kSubBuckets) << shift;
+}
+
+uint64_t LatencyHistogram::bucketWidth(int index) {
+    return index < 2 * kSubBuckets ? 1 : uint64_t{1} << (index / kSubBuckets - 1);
+}
+
+void LatencyHistogram::record(uint64_t micros) {
+    counts_[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(micros, std::memory_order_relaxed);
+    uint64_t current = max_.load(std::memory_order_relaxed);
+    while (micros > current && !max_.compare_exchange_weak(current, micros, std::memory_order_relaxed)) {
+    }
+}
+
+double LatencyHistogram::quantileMicros(double q) const {
+    // Снимок корзин: пока идёт обход, запись в другом потоке может его чуть сдвинуть - для квантилей это неважно
+    std::array<uint64_t, kBucketCount> snapshot;
+    uint64_t total = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        snapshot[i] = counts_[i].load(std::memory_order_relaxed);
+        total += snapshot[i];
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+
+    q = std::min(std::max(q, 0.0), 1.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += snapshot[i];
+        if (seen >= rank) {
+            double middle = static_cast<double>(bucketLowerBound(i)) + static_cast<double>(bucketWidth(i) - 1) / 2.0;
+            return std::min(middle, static_cast<double>(maxMicros()));
+        }
+    }
+    return static_cast<double>(maxMicros());
+}
+
+uint64_t HttpEndpointMetrics::requests() const {
+    uint64_t total = 0;
+    for (const auto& counter : responses) {
+        total += counter.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t HttpEndpointMetrics::errors() const {
+    return responses[0].load(std::memory_order_relaxed) + responses[5].load(std::memory_order_relaxed);
+}
+
+HttpMetrics& HttpMetrics::instance() {
+    static HttpMetrics metrics;
+    return metrics;
+}
+
+HttpMetrics::~HttpMetrics() {
+    for (auto& slot : slots_) {
+        delete slot.load();
+    }
+}
+
+void HttpMetrics::splitUrl(const std::string& url, std::string& server, std::string& endpoint) {
+    size_t authority = url.find("://");
+    authority = authority == std::string::npos ? 0 : authority + 3;
+    size_t path = url.find('/', authority);
+    server = url.substr(authority, path == std::string::npos ? std::string::npos : path - authority);
+    endpoint = path == std::string::npos ? "/" : url.substr(path, url.find('?', path) - path);
+
+    // /train/jobs/<id>/... - одна запись на все задания, иначе таблица разрастётся по числу заданий
+    const std::string jobs = "/train/jobs/";
+    if (endpoint.compare(0, jobs.size(), jobs) == 0 && endpoint.size() > jobs.size()) {
+        size_t id_end = endpoint.find('/', jobs.size());
+        endpoint = jobs + "{id}" + (id_end == std::string::npos ? "" : endpoint.substr(id_end));
+    }
+}
+
+HttpEndpointMetrics& HttpMetrics::find(const std::string& server, const std::string& endpoint) {
+    // Слоты заполняются строго по порядку, поэтому две записи с одним ключом появиться не могут
+    for (auto& slot : slots_) {
+        HttpEndpointMetrics* entry = slot.load(std::memory_order_acquire);
+        if (!entry) {
+            auto created = std::make_unique<HttpEndpointMetrics>(server, endpoint);
+            if (slot.compare_exchange_strong(entry, created.get(), std::memory_order_acq_rel)) {
+                return *created.release();
+            }
+            // слот занял другой поток - entry теперь указывает на его запись
+        }
+        if (entry->server == server && entry->endpoint == endpoint) {
+            return *entry;
+        }
+    }
+    return overflow_;
+}
+
+void HttpMetrics::recordTransfer(CURL* easy, const std::string& url, CURLcode result) {
+    std::string server, endpoint;
+    splitUrl(url, server, endpoint);
+    HttpEndpointMetrics& metrics = find(server, endpoint);
+
+    long status = 0;
+    curl_off_t sent = 0, received = 0;
+    curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &status);
+    curl_easy_getinfo(easy, CURLINFO_SIZE_UPLOAD_T, &sent);
+    curl_easy_getinfo(easy, CURLINFO_SIZE_DOWNLOAD_T, &received);
+    metrics.bytes_sent.fetch_add(nonNegative(sent), std::memory_order_relaxed);
+    metrics.bytes_received.fetch_add(nonNegative(received), std::memory_order_relaxed);
+
+    const bool answered = result == CURLE_OK && status >= 100 && status < 600;
+    const size_t status_class = answered ? static_cast<size_t>(status / 100) : 0;
+    metrics.responses[status_class].fetch_add(1, std::memory_order_relaxed);
+    if (result != CURLE_OK) {
+        return; // времена оборванного запроса не показательны
+    }
+
+    // Времена curl отсчитываются от начала запроса; connect - сама установка соединения
+    // (0 при keep-alive), TTFB - до первого байта ответа, как его обычно и понимают
+    curl_off_t dns = 0, connect = 0, ttfb = 0, total = 0;
+    curl_easy_getinfo(easy, CURLINFO_NAMELOOKUP_TIME_T, &dns);
+    curl_easy_getinfo(easy, CURLINFO_CONNECT_TIME_T, &connect);
+    curl_easy_getinfo(easy, CURLINFO_STARTTRANSFER_TIME_T, &ttfb);
+    curl_easy_getinfo(easy, CURLINFO_TOTAL_TIME_T, &total);
+    metrics.phases[HttpEndpointMetrics::kDns].record(nonNegative(dns));
+    metrics.phases[HttpEndpointMetrics::kConnect].record(nonNegative(connect - dns));
+    metrics.phases[HttpEndpointMetrics::kTtfb].record(nonNegative(ttfb));
+    metrics.phases[HttpEndpointMetrics::kTotal].record(nonNegative(total));
+}
+
+std::vector<const HttpEndpointMetrics*> HttpMetrics::endpoints() const {
+    std::vector<const HttpEndpointMetrics*> result;
+    for (const auto& slot : slots_) {
+        const HttpEndpointMetrics* entry = slot.load(std::memory_order_acquire);
+        if (!entry) {
+            break;
+        }
+        result.push_back(entry);
+    }
+    if (overflow_.requests() > 0) {
+        result.push_back(&overflow_);
+    }
+    return result;
+}
+
+void HttpMetrics::writePrometheus(std::ostream& out) const {
+    auto entries = endpoints();
+    auto labels = [](const HttpEndpointMetrics& entry) {
+        return "server=" + labelValue(entry.server) + ",endpoint=" + labelValue(entry.endpoint);
+    };
+    std::ostringstream text;
+    text << std::setprecision(9);
+
+    text << "# HELP ressys_http_requests_total HTTP requests by response class (error - transport failure).\n"
+         << "# TYPE ressys_http_requests_total counter\n";
+    for (const auto* entry : entries) {
+        for (size_t k = 0; k < 6; ++k) {
+            uint64_t value = entry->responses[k].load(std::memory_order_relaxed);
+            if (value > 0) {
+                text << "ressys_http_requests_total{" << labels(*entry) << ",code="
+                     << labelValue(k == 0 ? "error" : std::to_string(k) + "xx") << "} " << value << "\n";
+            }
+        }
+    }
+
+    text << "# HELP ressys_http_request_bytes_total Request body bytes sent.\n"
+         << "# TYPE ressys_http_request_bytes_total counter\n";
+    for (const auto* entry : entries) {
+        text << "ressys_http_request_bytes_total{" << labels(*entry) << "} "
+             << entry->bytes_sent.load(std::memory_order_relaxed) << "\n";
+    }
+    text << "# HELP ressys_http_response_bytes_total Response body bytes received.\n"
+         << "# TYPE ressys_http_response_bytes_total counter\n";
+    for (const auto* entry : entries) {
+        text << "ressys_http_response_bytes_total{" << labels(*entry) << "} "
+             << entry->bytes_received.load(std::memory_order_relaxed) << "\n";
+    }
+
+    text << "# HELP ressys_http_duration_seconds HTTP request phase durations (dns, connect, ttfb, total).\n"
+         << "# TYPE ressys_http_duration_seconds summary\n";
+    for (const auto* entry : entries) {
+        for (int phase = 0; phase < HttpEndpointMetrics::kPhaseCount; ++phase) {
+            const LatencyHistogram& histogram = entry->phases[phase];
+            std::string phase_labels = labels(*entry) + ",phase=" + labelValue(kPhaseNames[phase]);
+            for (double q : kQuantiles) {
+                text << "ressys_http_duration_seconds{" << phase_labels << ",quantile=\"" << q << "\"} "
+                     << histogram.quantileMicros(q) / 1e6 << "\n";
+            }
+            text << "ressys_http_duration_seconds_sum{" << phase_labels << "} " << histogram.sumMicros() / 1e6 << "\n"
+                 << "ressys_http_duration_seconds_count{" << phase_labels << "} " << histogram.count() << "\n";
+        }
+    }
+    out << text.str();
+}
+
+bool HttpMetrics::dumpPrometheus(const std::string& path, std::string& error) const {
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::trunc);
+        if (!file.is_open()) {
+            error = "Cannot create file: " + tmp_path;
+            return false;
+        }
+        writePrometheus(file);
+        if (!file) {
+            error = "Write failed: " + tmp_path;
+            file.close();
+            fs::remove(tmp_path);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+        error = "Cannot rename " + tmp_path + ": " + ec.message();
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+HttpMetricsExporter::HttpMetricsExporter(std::string path, std::chrono::seconds interval, Logger* logger)
+    : path_(std::move(path)), interval_(std::max(interval, std::chrono::seconds(1))), logger_(logger) {
+    std::error_code ec;
+    fs::create_directories(fs::path(path_).parent_path(), ec);
+    thread_ = std::thread(&HttpMetricsExporter::loop, this);
+}
+
+HttpMetricsExporter::~HttpMetricsExporter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    dump();
+}
+
+void HttpMetricsExporter::loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!wake_.wait_for(lock, interval_, [this]() { return stop_; })) {
+        lock.unlock();
+        dump();
+        lock.lock();
+    }
+}
+
+void HttpMetricsExporter::dump() {
+    std::string error;
+    if (!HttpMetrics::instance().dumpPrometheus(path_, error) && logger_) {
+        logger_->warning("HTTP metrics not written: " + error);
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef HTTP_METRICS_H
+#define HTTP_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <curl/curl.h>
+#include "logger.h"
+
+// Гистограмма задержек в духе HdrHistogram: значения в микросекундах, на каждую
+// двоичную октаву kSubBuckets линейных корзин (погрешность квантиля ~3%),
+// диапазон от 1 мкс до 2^kMaxMagnitude мкс (~19 ч). Запись - fetch_add без
+// блокировок, её можно звать из колбэков curl в любом потоке.
+class LatencyHistogram {
+public:
+    static const int kSubBucketBits = 5;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+    static const int kMaxMagnitude = 36;
+    static const int kBucketCount = (kMaxMagnitude - kSubBucketBits + 1) * kSubBuckets;
+
+    void record(uint64_t micros);
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sumMicros() const { return sum_.load(std::memory_order_relaxed); }
+    uint64_t maxMicros() const { return max_.load(std::memory_order_relaxed); }
+    // Квантиль q из [0, 1] по текущим счётчикам (середина корзины); 0 - записей нет
+    double quantileMicros(double q) const;
+
+    static int bucketIndex(uint64_t micros);
+    static uint64_t bucketLowerBound(int index);
+    static uint64_t bucketWidth(int index);
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> counts_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Метрики одного endpoint одного сервера (воркеры различаются портом)
+struct HttpEndpointMetrics {
+    enum Phase { kDns, kConnect, kTtfb, kTotal, kPhaseCount };
+
+    HttpEndpointMetrics(std::string server_name, std::string endpoint_name)
+        : server(std::move(server_name)), endpoint(std::move(endpoint_name)) {}
+
+    const std::string server;     // host:port
+    const std::string endpoint;   // путь без query, id заданий заменены на {id}
+    LatencyHistogram phases[kPhaseCount];
+    std::atomic<uint64_t> responses[6] = {}; // [0] - ошибка транспорта, [k] - ответы kxx
+    std::atomic<uint64_t> bytes_sent{0};
+    std::atomic<uint64_t> bytes_received{0};
+
+    uint64_t requests() const;
+    uint64_t errors() const;      // ошибки транспорта и ответы 5xx
+};
+
+// Реестр метрик HTTP на весь процесс: HttpClient и AsyncHttpEngine отдают сюда
+// каждый завершённый запрос. Поиск записи endpoint-а - без блокировок: записи
+// добавляются CAS-ом в фиксированную таблицу и живут до конца процесса.
+class HttpMetrics {
+public:
+    static HttpMetrics& instance();
+
+    // Фазы (DNS, connect, TTFB, total), байты и код ответа - из curl_easy_getinfo
+    void recordTransfer(CURL* easy, const std::string& url, CURLcode result);
+
+    std::vector<const HttpEndpointMetrics*> endpoints() const;
+
+    // Текстовый формат Prometheus (summary с квантилями 0.5/0.95/0.99 и счётчики)
+    void writePrometheus(std::ostream& out) const;
+    // Через временный файл и rename - textfile collector не увидит половину файла
+    bool dumpPrometheus(const std::string& path, std::string& error) const;
+
+    // http://host:port/train/jobs/abc/cancel?x=1 -> "host:port", "/train/jobs/{id}/cancel"
+    static void splitUrl(const std::string& url, std::string& server, std::string& endpoint);
+
+    HttpMetrics(const HttpMetrics&) = delete;
+    HttpMetrics& operator=(const HttpMetrics&) = delete;
+
+private:
+    static const size_t kMaxEndpoints = 64;
+
+    HttpMetrics() = default;
+    ~HttpMetrics();
+
+    HttpEndpointMetrics& find(const std::string& server, const std::string& endpoint);
+
+    std::array<std::atomic<HttpEndpointMetrics*>, kMaxEndpoints> slots_{};
+    HttpEndpointMetrics overflow_{"*", "other"}; // таблица заполнена
+};
+
+// Периодическая запись HttpMetrics в файл .prom для textfile collector node_exporter;
+// последний снимок пишется и при остановке
+class HttpMetricsExporter {
+public:
+    HttpMetricsExporter(std::string path, std::chrono::seconds interval, Logger* logger = nullptr);
+    ~HttpMetricsExporter();
+
+    HttpMetricsExporter(const HttpMetricsExporter&) = delete;
+    HttpMetricsExporter& operator=(const HttpMetricsExporter&) = delete;
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    std::chrono::seconds interval_;
+    Logger* logger_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+    std::thread thread_;
+
+    void loop();
+    void dump();
+};
+
+#endif // HTTP_METRICS_H
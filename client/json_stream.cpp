@@ -0,0 +1,387 @@
+#include "json_stream.h"
+
+namespace {
+
+// Числа и литералы: как из этих символов собран токен, решает emitBare
+const size_t kMaxBareToken = 64;
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool isBare(char c) {
+    return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-' || c == '+' || c == '.';
+}
+
+// Без этой проверки from_chars принял бы "01", "1." и ".5", которых в JSON нет
+bool isJsonNumber(std::string_view s) {
+    size_t i = 0;
+    const size_t n = s.size();
+    if (i < n && s[i] == '-') {
+        ++i;
+    }
+    if (i < n && s[i] == '0') {
+        ++i;
+    } else if (i < n && s[i] >= '1' && s[i] <= '9') {
+        while (i < n && isDigit(s[i])) {
+            ++i;
+        }
+    } else {
+        return false;
+    }
+    if (i < n && s[i] == '.') {
+        size_t digits = ++i;
+        while (i < n && isDigit(s[i])) {
+            ++i;
+        }
+        if (i == digits) {
+            return false;
+        }
+    }
+    if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+        ++i;
+        if (i < n && (s[i] == '+' || s[i] == '-')) {
+            ++i;
+        }
+        size_t digits = i;
+        while (i < n && isDigit(s[i])) {
+            ++i;
+        }
+        if (i == digits) {
+            return false;
+        }
+    }
+    return i == n;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+} // namespace
+
+JsonStreamParser::JsonStreamParser(Handler& handler, size_t max_depth, size_t max_token)
+    : handler_(handler), max_depth_(max_depth), max_token_(max_token) {}
+
+void JsonStreamParser::reset() {
+    expect_ = Expect::Value;
+    stack_.clear();
+    token_ = Token::None;
+    token_is_key_ = false;
+    pending_.clear();
+    escape_ = 0;
+    unicode_ = 0;
+    high_surrogate_ = 0;
+    offset_ = 0;
+    failed_ = false;
+    last_error_.clear();
+}
+
+bool JsonStreamParser::fail(const std::string& message) {
+    failed_ = true;
+    last_error_ = message;
+    return false;
+}
+
+bool JsonStreamParser::fail(const char* what, char c) {
+    std::string message = std::string(what) + " '";
+    message += c;
+    return fail(message + "' at offset " + std::to_string(offset_));
+}
+
+bool JsonStreamParser::feed(const char* data, size_t size) {
+    if (failed_) {
+        return false;
+    }
+    const char* p = data;
+    const char* end = data + size;
+    while (p < end) {
+        const char* next;
+        if (token_ == Token::String) {
+            next = continueString(p, end);
+        } else if (token_ == Token::Bare) {
+            next = continueBare(p, end);
+        } else if (isSpace(*p)) {
+            next = p + 1;
+        } else if (*p == '"' && (expect_ == Expect::Key || expect_ == Expect::KeyOrEnd ||
+                                 expect_ == Expect::Value || expect_ == Expect::ValueOrEnd)) {
+            // Строка без escape целиком в куске уходит в handler прямо из буфера curl
+            token_is_key_ = expect_ == Expect::Key || expect_ == Expect::KeyOrEnd;
+            const char* q = p + 1;
+            while (q < end && *q != '"' && *q != '\\' && static_cast<unsigned char>(*q) >= 0x20) {
+                ++q;
+            }
+            if (q < end && *q == '"') {
+                if (!emitString(std::string_view(p + 1, static_cast<size_t>(q - p - 1)))) {
+                    return false;
+                }
+                next = q + 1;
+            } else {
+                token_ = Token::String;
+                pending_.assign(p + 1, q);
+                next = q;
+            }
+        } else if (isBare(*p) && (expect_ == Expect::Value || expect_ == Expect::ValueOrEnd)) {
+            const char* q = p;
+            while (q < end && isBare(*q)) {
+                ++q;
+            }
+            if (q < end) {
+                if (!emitBare(std::string_view(p, static_cast<size_t>(q - p)))) {
+                    return false;
+                }
+            } else {
+                token_ = Token::Bare;
+                pending_.assign(p, q);
+            }
+            next = q;
+        } else if (!beginValue(*p)) {
+            return false;
+        } else {
+            next = p + 1;
+        }
+        if (!next) {
+            return false;
+        }
+        offset_ += static_cast<uint64_t>(next - p);
+        p = next;
+    }
+    return true;
+}
+
+// Структурные символы: скобки, ':' и ','
+bool JsonStreamParser::beginValue(char c) {
+    switch (expect_) {
+    case Expect::Value:
+    case Expect::ValueOrEnd:
+        if (c == ']' && expect_ == Expect::ValueOrEnd) {
+            stack_.pop_back();
+            return (handler_.endArray() || fail("stopped by handler")) && valueDone();
+        }
+        if (c == '{' || c == '[') {
+            if (stack_.size() >= max_depth_) {
+                return fail("JSON nesting deeper than " + std::to_string(max_depth_));
+            }
+            stack_.push_back(c);
+            expect_ = c == '{' ? Expect::KeyOrEnd : Expect::ValueOrEnd;
+            return (c == '{' ? handler_.startObject() : handler_.startArray()) || fail("stopped by handler");
+        }
+        return fail("Unexpected character", c);
+    case Expect::KeyOrEnd:
+        if (c == '}') {
+            stack_.pop_back();
+            return (handler_.endObject() || fail("stopped by handler")) && valueDone();
+        }
+        return fail("Expected object key, got", c);
+    case Expect::Key:
+        return fail("Expected object key, got", c);
+    case Expect::Colon:
+        if (c != ':') {
+            return fail("Expected ':', got", c);
+        }
+        expect_ = Expect::Value;
+        return true;
+    case Expect::CommaOrEnd:
+        if (c == ',') {
+            expect_ = stack_.back() == '{' ? Expect::Key : Expect::Value;
+            return true;
+        }
+        if ((c == '}' && stack_.back() == '{') || (c == ']' && stack_.back() == '[')) {
+            stack_.pop_back();
+            bool resumed = c == '}' ? handler_.endObject() : handler_.endArray();
+            return (resumed || fail("stopped by handler")) && valueDone();
+        }
+        return fail("Expected ',' or end of container, got", c);
+    case Expect::Done:
+        return fail("Unexpected data after JSON value:", c);
+    }
+    return false;
+}
+
+const char* JsonStreamParser::continueString(const char* p, const char* end) {
+    while (p < end) {
+        if (escape_ == 0) {
+            if (high_surrogate_ && *p != '\\') {
+                high_surrogate_ = 0;
+                appendUtf8(0xFFFD); // одиночная половина суррогатной пары
+            }
+            const char* q = p;
+            while (q < end && *q != '"' && *q != '\\' && static_cast<unsigned char>(*q) >= 0x20) {
+                ++q;
+            }
+            pending_.append(p, q);
+            p = q;
+            if (pending_.size() > max_token_) {
+                fail("String longer than " + std::to_string(max_token_) + " bytes");
+                return nullptr;
+            }
+            if (p == end) {
+                break;
+            }
+            if (*p == '"') {
+                token_ = Token::None;
+                if (!emitString(pending_)) {
+                    return nullptr;
+                }
+                pending_.clear();
+                return p + 1;
+            }
+            if (*p != '\\') {
+                fail("Control character in string at offset " + std::to_string(offset_));
+                return nullptr;
+            }
+            escape_ = 1;
+            ++p;
+        } else if (escape_ == 1) {
+            char c = *p++;
+            if (c == 'u') {
+                escape_ = 2;
+                unicode_ = 0;
+                continue;
+            }
+            if (high_surrogate_) {
+                high_surrogate_ = 0;
+                appendUtf8(0xFFFD);
+            }
+            switch (c) {
+            case '"': case '\\': case '/': pending_ += c; break;
+            case 'b': pending_ += '\b'; break;
+            case 'f': pending_ += '\f'; break;
+            case 'n': pending_ += '\n'; break;
+            case 'r': pending_ += '\r'; break;
+            case 't': pending_ += '\t'; break;
+            default:
+                fail("Invalid escape", c);
+                return nullptr;
+            }
+            escape_ = 0;
+        } else {
+            int digit = hexValue(*p);
+            if (digit < 0) {
+                fail("Invalid \\u escape digit", *p);
+                return nullptr;
+            }
+            ++p;
+            unicode_ = (unicode_ << 4) | static_cast<uint32_t>(digit);
+            if (++escape_ < 6) {
+                continue;
+            }
+            escape_ = 0;
+            if (unicode_ >= 0xD800 && unicode_ <= 0xDBFF) {
+                if (high_surrogate_) {
+                    appendUtf8(0xFFFD);
+                }
+                high_surrogate_ = unicode_;
+            } else if (unicode_ >= 0xDC00 && unicode_ <= 0xDFFF) {
+                appendUtf8(high_surrogate_ ? 0x10000 + ((high_surrogate_ - 0xD800) << 10) + (unicode_ - 0xDC00)
+                                           : 0xFFFD);
+                high_surrogate_ = 0;
+            } else {
+                if (high_surrogate_) {
+                    high_surrogate_ = 0;
+                    appendUtf8(0xFFFD);
+                }
+                appendUtf8(unicode_);
+            }
+        }
+    }
+    return p;
+}
+
+const char* JsonStreamParser::continueBare(const char* p, const char* end) {
+    const char* q = p;
+    while (q < end && isBare(*q)) {
+        ++q;
+    }
+    pending_.append(p, q);
+    if (pending_.size() > kMaxBareToken) {
+        fail("Token longer than " + std::to_string(kMaxBareToken) + " bytes");
+        return nullptr;
+    }
+    if (q < end) {
+        token_ = Token::None;
+        if (!emitBare(pending_)) {
+            return nullptr;
+        }
+        pending_.clear();
+    }
+    return q;
+}
+
+void JsonStreamParser::appendUtf8(uint32_t code_point) {
+    if (code_point < 0x80) {
+        pending_ += static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        pending_ += static_cast<char>(0xC0 | (code_point >> 6));
+        pending_ += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+        pending_ += static_cast<char>(0xE0 | (code_point >> 12));
+        pending_ += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        pending_ += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else {
+        pending_ += static_cast<char>(0xF0 | (code_point >> 18));
+        pending_ += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        pending_ += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        pending_ += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+}
+
+bool JsonStreamParser::emitString(std::string_view text) {
+    if (token_is_key_) {
+        expect_ = Expect::Colon;
+        return handler_.key(text) || fail("stopped by handler");
+    }
+    return (handler_.string(text) || fail("stopped by handler")) && valueDone();
+}
+
+bool JsonStreamParser::emitBare(std::string_view text) {
+    bool resumed;
+    if (text == "true" || text == "false") {
+        resumed = handler_.boolean(text == "true");
+    } else if (text == "null") {
+        resumed = handler_.null();
+    } else if (text == "NaN" || text == "Infinity" || text == "-Infinity" || isJsonNumber(text)) {
+        resumed = handler_.number(text);
+    } else {
+        return fail("Invalid token '" + std::string(text) + "'");
+    }
+    return (resumed || fail("stopped by handler")) && valueDone();
+}
+
+bool JsonStreamParser::valueDone() {
+    expect_ = stack_.empty() ? Expect::Done : Expect::CommaOrEnd;
+    return true;
+}
+
+bool JsonStreamParser::finish() {
+    if (failed_) {
+        return false;
+    }
+    if (token_ == Token::Bare) {
+        token_ = Token::None;
+        if (!emitBare(pending_)) {
+            return false;
+        }
+        pending_.clear();
+    }
+    if (token_ == Token::String) {
+        return fail("Unterminated string at end of JSON");
+    }
+    if (expect_ != Expect::Done) {
+        return fail("Unexpected end of JSON at offset " + std::to_string(offset_));
+    }
+    return true;
+}
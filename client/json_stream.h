@@ -0,0 +1,75 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Потоковый (SAX) разбор JSON: текст подаётся кусками по мере приёма (write callback
+// curl), события уходят в Handler без построения дерева. Копируются только токены,
+// разрезанные границей куска, и строки с escape-последовательностями, поэтому память
+// не растёт с размером ответа. Как json.dumps из Python, принимает NaN, Infinity и
+// -Infinity - они приходят в number() как есть.
+class JsonStreamParser {
+public:
+    // false из любого события останавливает разбор (ошибка "stopped by handler")
+    class Handler {
+    public:
+        virtual ~Handler() = default;
+        virtual bool startObject() { return true; }
+        virtual bool endObject() { return true; }
+        virtual bool startArray() { return true; }
+        virtual bool endArray() { return true; }
+        virtual bool key(std::string_view /*name*/) { return true; }
+        virtual bool string(std::string_view /*value*/) { return true; }
+        virtual bool number(std::string_view /*text*/) { return true; } // текст числа, грамматика уже проверена
+        virtual bool boolean(bool /*value*/) { return true; }
+        virtual bool null() { return true; }
+    };
+
+    explicit JsonStreamParser(Handler& handler, size_t max_depth = 64, size_t max_token = 1 << 20);
+
+    // Очередной кусок текста; false - ошибка, дальнейшие куски не разбираются
+    bool feed(const char* data, size_t size);
+    // Конец текста: значение должно быть полным
+    bool finish();
+    void reset();
+
+    bool failed() const { return failed_; }
+    const std::string& lastError() const { return last_error_; }
+    uint64_t offset() const { return offset_; } // разобрано байт
+
+private:
+    enum class Expect : uint8_t { Value, ValueOrEnd, Key, KeyOrEnd, Colon, CommaOrEnd, Done };
+    enum class Token : uint8_t { None, String, Bare };
+
+    const char* continueString(const char* p, const char* end);
+    const char* continueBare(const char* p, const char* end);
+    bool beginValue(char c);
+    bool emitString(std::string_view text);
+    bool emitBare(std::string_view text);
+    bool valueDone();
+    void appendUtf8(uint32_t code_point);
+    bool fail(const std::string& message);
+    bool fail(const char* what, char c);
+
+    Handler& handler_;
+    size_t max_depth_;
+    size_t max_token_;
+
+    Expect expect_ = Expect::Value;
+    std::vector<char> stack_;        // '{' или '[' открытых контейнеров
+    Token token_ = Token::None;
+    bool token_is_key_ = false;
+    std::string pending_;            // токен, начатый в прошлом куске
+    uint8_t escape_ = 0;             // 0 - нет, 1 - после '\', 2..5 - цифры \uXXXX
+    uint32_t unicode_ = 0;
+    uint32_t high_surrogate_ = 0;
+    uint64_t offset_ = 0;
+    bool failed_ = false;
+    std::string last_error_;
+};
+
+#endif // JSON_STREAM_H
@@ -0,0 +1,251 @@
+#include "learning_base_binary.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+const char kLearningBaseBinaryMagic[8] = {'R', 'S', 'L', 'B', 'A', 'S', 'E', '\0'};
+
+namespace {
+
+const uint64_t kFixedHeaderSize = 64;
+
+uint64_t alignUp(uint64_t value) {
+    return (value + kLearningBaseBinaryAlignment - 1) / kLearningBaseBinaryAlignment * kLearningBaseBinaryAlignment;
+}
+
+template <typename T>
+void appendValue(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+bool readValue(const char* data, size_t size, uint64_t& pos, T& value) {
+    if (pos + sizeof(T) > size) {
+        return false;
+    }
+    std::memcpy(&value, data + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+bool writeZeros(std::ofstream& file, uint64_t count) {
+    static const char zeros[kLearningBaseBinaryAlignment] = {};
+    while (count > 0) {
+        uint64_t chunk = count < sizeof(zeros) ? count : sizeof(zeros);
+        file.write(zeros, static_cast<std::streamsize>(chunk));
+        count -= chunk;
+    }
+    return static_cast<bool>(file);
+}
+
+} // namespace
+
+LearningBaseBinaryLayout computeLearningBaseBinaryLayout(const LearningBaseConfig& config, uint64_t num_samples) {
+    LearningBaseBinaryLayout layout;
+
+    uint64_t variable_size = config.num_features_x * (sizeof(uint64_t) + sizeof(uint32_t)) +
+                             config.num_targets_y * sizeof(double) +
+                             sizeof(uint32_t) + config.name.size();
+    layout.header_size = alignUp(kFixedHeaderSize + variable_size);
+
+    uint64_t pos = layout.header_size;
+    for (int c = 0; c < config.num_features_x; ++c) {
+        layout.x_offsets.push_back(pos);
+        pos = alignUp(pos + num_samples * config.x_lengths[c] * sizeof(float));
+    }
+    layout.y_offset = pos;
+    pos = alignUp(pos + num_samples * config.num_targets_y * sizeof(float));
+    layout.offsets_offset = pos;
+    layout.file_size = pos + num_samples * sizeof(uint64_t);
+    return layout;
+}
+
+std::string encodeLearningBaseBinaryHeader(const LearningBaseConfig& config, uint64_t num_samples,
+                                           const LearningBaseBinaryLayout& layout) {
+    std::string header;
+    header.reserve(layout.header_size);
+
+    header.append(kLearningBaseBinaryMagic, sizeof(kLearningBaseBinaryMagic));
+    appendValue<uint32_t>(header, kLearningBaseBinaryVersion);
+    appendValue<uint32_t>(header, static_cast<uint32_t>(layout.header_size));
+    appendValue<uint64_t>(header, num_samples);
+    appendValue<uint32_t>(header, static_cast<uint32_t>(config.num_targets_y));
+    appendValue<uint32_t>(header, static_cast<uint32_t>(config.num_features_x));
+    appendValue<uint64_t>(header, layout.y_offset);
+    appendValue<uint64_t>(header, layout.offsets_offset);
+    appendValue<uint64_t>(header, layout.file_size);
+    header.resize(kFixedHeaderSize, '\0');
+
+    for (uint64_t offset : layout.x_offsets) {
+        appendValue<uint64_t>(header, offset);
+    }
+    for (int length : config.x_lengths) {
+        appendValue<uint32_t>(header, static_cast<uint32_t>(length));
+    }
+    for (double precision : config.y_precision) {
+        appendValue<double>(header, precision);
+    }
+    appendValue<uint32_t>(header, static_cast<uint32_t>(config.name.size()));
+    header += config.name;
+
+    header.resize(layout.header_size, '\0');
+    return header;
+}
+
+bool writeLearningBaseBinary(const std::string& path, const LearningBaseConfig& config,
+                             const LearningBaseData& data, std::string& error) {
+    if (data.num_samples <= 0 || static_cast<int>(data.x.size()) != config.num_features_x ||
+        data.num_targets_y != config.num_targets_y ||
+        static_cast<int>(config.y_precision.size()) != config.num_targets_y) {
+        error = "Learning base data does not match config";
+        return false;
+    }
+
+    const uint64_t num_samples = static_cast<uint64_t>(data.num_samples);
+    LearningBaseBinaryLayout layout = computeLearningBaseBinaryLayout(config, num_samples);
+
+    // Пишем во временный файл и переименовываем, чтобы не оставить битый .rslb
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            error = "Cannot create file: " + tmp_path;
+            return false;
+        }
+
+        std::string header = encodeLearningBaseBinaryHeader(config, num_samples, layout);
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+        uint64_t pos = layout.header_size;
+        for (int c = 0; c < config.num_features_x; ++c) {
+            writeZeros(file, layout.x_offsets[c] - pos);
+            uint64_t bytes = data.x[c].size() * sizeof(float);
+            file.write(reinterpret_cast<const char*>(data.x[c].data()), static_cast<std::streamsize>(bytes));
+            pos = layout.x_offsets[c] + bytes;
+        }
+
+        writeZeros(file, layout.y_offset - pos);
+        uint64_t y_bytes = data.y.size() * sizeof(float);
+        file.write(reinterpret_cast<const char*>(data.y.data()), static_cast<std::streamsize>(y_bytes));
+        pos = layout.y_offset + y_bytes;
+
+        writeZeros(file, layout.offsets_offset - pos);
+        file.write(reinterpret_cast<const char*>(data.record_offsets.data()),
+                   static_cast<std::streamsize>(data.record_offsets.size() * sizeof(uint64_t)));
+
+        if (!file) {
+            error = "Write failed: " + tmp_path;
+            file.close();
+            fs::remove(tmp_path);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+        error = "Cannot rename " + tmp_path + ": " + ec.message();
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+bool LearningBaseBinary::open(const std::string& path) {
+    close();
+
+    if (!file_.open(path)) {
+        last_error_ = "Cannot map file: " + path;
+        return false;
+    }
+
+    const char* data = file_.data();
+    const size_t size = file_.size();
+    uint64_t pos = sizeof(kLearningBaseBinaryMagic);
+
+    if (size < kFixedHeaderSize || std::memcmp(data, kLearningBaseBinaryMagic, sizeof(kLearningBaseBinaryMagic)) != 0) {
+        last_error_ = "Not a binary learning base: " + path;
+        close();
+        return false;
+    }
+
+    uint32_t version = 0, header_size = 0, num_targets_y = 0, num_features_x = 0;
+    uint64_t num_samples = 0, y_offset = 0, offsets_offset = 0, file_size = 0;
+    readValue(data, size, pos, version);
+    readValue(data, size, pos, header_size);
+    readValue(data, size, pos, num_samples);
+    readValue(data, size, pos, num_targets_y);
+    readValue(data, size, pos, num_features_x);
+    readValue(data, size, pos, y_offset);
+    readValue(data, size, pos, offsets_offset);
+    readValue(data, size, pos, file_size);
+
+    if (version != kLearningBaseBinaryVersion) {
+        last_error_ = "Unsupported binary learning base version: " + std::to_string(version);
+        close();
+        return false;
+    }
+    if (file_size != size) {
+        last_error_ = "Binary learning base is truncated: " + path;
+        close();
+        return false;
+    }
+
+    config_ = LearningBaseConfig();
+    config_.num_samples = static_cast<int>(num_samples);
+    config_.num_targets_y = static_cast<int>(num_targets_y);
+    config_.num_features_x = static_cast<int>(num_features_x);
+
+    pos = kFixedHeaderSize;
+    std::vector<uint64_t> x_offsets(num_features_x);
+    bool ok = true;
+    for (auto& offset : x_offsets) {
+        ok = ok && readValue(data, size, pos, offset);
+    }
+    for (uint32_t c = 0; c < num_features_x; ++c) {
+        uint32_t length = 0;
+        ok = ok && readValue(data, size, pos, length);
+        config_.x_lengths.push_back(static_cast<int>(length));
+    }
+    for (uint32_t i = 0; i < num_targets_y; ++i) {
+        double precision = 0.0;
+        ok = ok && readValue(data, size, pos, precision);
+        config_.y_precision.push_back(precision);
+    }
+    uint32_t name_length = 0;
+    ok = ok && readValue(data, size, pos, name_length) && pos + name_length <= header_size;
+    if (!ok) {
+        last_error_ = "Corrupted binary learning base header: " + path;
+        close();
+        return false;
+    }
+    config_.name.assign(data + pos, name_length);
+
+    // Проверяем, что смещения совпадают с тем, что даёт конфиг
+    LearningBaseBinaryLayout layout = computeLearningBaseBinaryLayout(config_, num_samples);
+    if (layout.header_size != header_size || layout.x_offsets != x_offsets ||
+        layout.y_offset != y_offset || layout.offsets_offset != offsets_offset || layout.file_size != file_size) {
+        last_error_ = "Inconsistent binary learning base layout: " + path;
+        close();
+        return false;
+    }
+
+    for (uint64_t offset : x_offsets) {
+        x_.push_back(reinterpret_cast<const float*>(data + offset));
+    }
+    y_ = reinterpret_cast<const float*>(data + y_offset);
+    record_offsets_ = reinterpret_cast<const uint64_t*>(data + offsets_offset);
+    return true;
+}
+
+void LearningBaseBinary::close() {
+    file_.close();
+    config_ = LearningBaseConfig();
+    x_.clear();
+    y_ = nullptr;
+    record_offsets_ = nullptr;
+}
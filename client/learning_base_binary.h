@@ -0,0 +1,72 @@
+#ifndef LEARNING_BASE_BINARY_H
+#define LEARNING_BASE_BINARY_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "learning_base_config.h"
+#include "learning_base_parser.h"
+#include "mapped_file.h"
+
+// Бинарный колоночный формат обучающей базы (.rslb), little-endian.
+//
+//   [0, 64)        заголовок: magic "RSLBASE\0", version, header_size, num_samples,
+//                  num_targets_y, num_features_x, y_offset, offsets_offset, file_size
+//   [64, ...)      uint64 x_offsets[nx], uint32 x_lengths[nx], float64 y_precision[ny],
+//                  uint32 name_length, char name[name_length]
+//   x_offsets[c]   float32 [num_samples][x_lengths[c]] - канал X[c]
+//   y_offset       float32 [num_samples][num_targets_y]
+//   offsets_offset uint64  [num_samples] - смещение записи в исходном .txt
+//
+// Все блоки выровнены на kLearningBaseBinaryAlignment, поэтому файл можно
+// отображать в память и отдавать каналы в numpy/torch без копирования.
+extern const char kLearningBaseBinaryMagic[8];
+const uint32_t kLearningBaseBinaryVersion = 1;
+const uint64_t kLearningBaseBinaryAlignment = 64;
+
+// Смещения блоков для заданного конфига и числа записей
+struct LearningBaseBinaryLayout {
+    uint64_t header_size = 0;
+    std::vector<uint64_t> x_offsets;
+    uint64_t y_offset = 0;
+    uint64_t offsets_offset = 0;
+    uint64_t file_size = 0;
+};
+
+LearningBaseBinaryLayout computeLearningBaseBinaryLayout(const LearningBaseConfig& config, uint64_t num_samples);
+std::string encodeLearningBaseBinaryHeader(const LearningBaseConfig& config, uint64_t num_samples,
+                                           const LearningBaseBinaryLayout& layout);
+
+bool writeLearningBaseBinary(const std::string& path, const LearningBaseConfig& config,
+                             const LearningBaseData& data, std::string& error);
+
+// Zero-copy доступ к .rslb через отображение в память
+class LearningBaseBinary {
+public:
+    bool open(const std::string& path);
+    void close();
+
+    const std::string& lastError() const { return last_error_; }
+    const LearningBaseConfig& config() const { return config_; }
+
+    int numSamples() const { return config_.num_samples; }
+    const float* x(int channel) const { return x_[channel]; }
+    const float* sampleX(int channel, int sample) const {
+        return x_[channel] + static_cast<size_t>(sample) * config_.x_lengths[channel];
+    }
+    const float* y() const { return y_; }
+    const float* sampleY(int sample) const {
+        return y_ + static_cast<size_t>(sample) * config_.num_targets_y;
+    }
+    const uint64_t* recordOffsets() const { return record_offsets_; }
+
+private:
+    MappedFile file_;
+    LearningBaseConfig config_;
+    std::vector<const float*> x_;
+    const float* y_ = nullptr;
+    const uint64_t* record_offsets_ = nullptr;
+    std::string last_error_;
+};
+
+#endif // LEARNING_BASE_BINARY_H
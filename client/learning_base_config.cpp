@@ -0,0 +1,204 @@
+#include "learning_base_config.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+void trim(std::string& str) {
+    size_t begin = str.find_first_not_of(" \t\r\n");
+    size_t end = str.find_last_not_of(" \t\r\n");
+    str = begin == std::string::npos ? "" : str.substr(begin, end - begin + 1);
+}
+
+template <typename T, typename Convert>
+std::vector<T> splitList(const std::string& value, Convert convert) {
+    std::vector<T> result;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        trim(item);
+        if (!item.empty()) {
+            result.push_back(convert(item));
+        }
+    }
+    return result;
+}
+
+std::vector<double>* statsField(LearningBaseConfig& config, const std::string& key) {
+    if (key == "x_mean") return &config.x_mean;
+    if (key == "x_std") return &config.x_std;
+    if (key == "x_min") return &config.x_min;
+    if (key == "x_max") return &config.x_max;
+    if (key == "y_mean") return &config.y_mean;
+    if (key == "y_std") return &config.y_std;
+    if (key == "y_min") return &config.y_min;
+    if (key == "y_max") return &config.y_max;
+    return nullptr;
+}
+
+} // namespace
+
+bool loadLearningBaseConfig(const std::string& path, LearningBaseConfig& config, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "Cannot open config: " + path;
+        return false;
+    }
+
+    config = LearningBaseConfig();
+    std::string line;
+    try {
+        while (std::getline(file, line)) {
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) {
+                continue;
+            }
+            std::string key = line.substr(0, eq);
+            std::string value = line.substr(eq + 1);
+            trim(key);
+            trim(value);
+
+            if (key == "name") {
+                config.name = value;
+            } else if (key == "num_samples") {
+                config.num_samples = std::stoi(value);
+            } else if (key == "num_targets_y") {
+                config.num_targets_y = std::stoi(value);
+            } else if (key == "y_precision") {
+                config.y_precision = splitList<double>(value, [](const std::string& s) { return std::stod(s); });
+            } else if (key == "num_features_x") {
+                config.num_features_x = std::stoi(value);
+            } else if (key == "x_lengths") {
+                config.x_lengths = splitList<int>(value, [](const std::string& s) { return std::stoi(s); });
+            } else if (std::vector<double>* stats = statsField(config, key)) {
+                *stats = splitList<double>(value, [](const std::string& s) { return std::stod(s); });
+            }
+        }
+    } catch (const std::exception& e) {
+        error = "Invalid value in " + path + ": " + e.what();
+        return false;
+    }
+
+    if (config.num_features_x != static_cast<int>(config.x_lengths.size()) || config.num_targets_y <= 0) {
+        error = "Incomplete learning base config: " + path;
+        return false;
+    }
+    return true;
+}
+
+bool writeLearningBaseConfig(const std::string& path, const LearningBaseConfig& config, std::string& error) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        error = "Cannot create file: " + path;
+        return false;
+    }
+    
+    file << "name=" << config.name << "\n";
+    file << "num_samples=" << config.num_samples << "\n";
+    file << "num_targets_y=" << config.num_targets_y << "\n";
+    
+    file << "y_precision=";
+    for (size_t i = 0; i < config.y_precision.size(); ++i) {
+        file << config.y_precision[i];
+        if (i < config.y_precision.size() - 1) file << ",";
+    }
+    file << "\n";
+    
+    file << "num_features_x=" << config.num_features_x << "\n";
+    
+    file << "x_lengths=";
+    for (size_t i = 0; i < config.x_lengths.size(); ++i) {
+        file << config.x_lengths[i];
+        if (i < config.x_lengths.size() - 1) file << ",";
+    }
+    file << "\n";
+    
+    if (config.hasStats()) {
+        file << std::setprecision(10);
+        auto writeStats = [&file](const char* key, const std::vector<double>& values) {
+            file << key << "=";
+            for (size_t i = 0; i < values.size(); ++i) {
+                file << values[i];
+                if (i < values.size() - 1) file << ",";
+            }
+            file << "\n";
+        };
+        writeStats("x_mean", config.x_mean);
+        writeStats("x_std", config.x_std);
+        writeStats("x_min", config.x_min);
+        writeStats("x_max", config.x_max);
+        writeStats("y_mean", config.y_mean);
+        writeStats("y_std", config.y_std);
+        writeStats("y_min", config.y_min);
+        writeStats("y_max", config.y_max);
+    }
+    
+    file.close();
+    if (!file) {
+        error = "Write failed: " + path;
+        return false;
+    }
+    return true;
+}
+
+bool parseLearningBaseConfig(const std::string& input, LearningBaseConfig& config, std::string& error) {
+    std::vector<std::string> tokens;
+    std::istringstream iss(input);
+    std::string token;
+    
+    while (iss >> token) {
+        tokens.push_back(token);
+    }
+    
+    if (tokens.size() < 4) {
+        error = "Not enough parameters";
+        return false;
+    }
+    
+    try {
+        config.name = tokens[0];
+        config.num_samples = std::stoi(tokens[1]);
+        config.num_targets_y = std::stoi(tokens[2]);
+        
+        if (config.num_targets_y < 0 || tokens.size() < 3 + static_cast<size_t>(config.num_targets_y) + 1) {
+            error = "Not enough precision values for Y";
+            return false;
+        }
+        
+        config.y_precision.clear();
+        for (int i = 0; i < config.num_targets_y; ++i) {
+            config.y_precision.push_back(std::stod(tokens[3 + i]));
+        }
+        
+        size_t current_index = 3 + static_cast<size_t>(config.num_targets_y);
+        if (tokens.size() <= current_index) {
+            error = "Missing number of features X";
+            return false;
+        }
+        
+        config.num_features_x = std::stoi(tokens[current_index]);
+        current_index++;
+        
+        if (config.num_features_x < 0 || tokens.size() < current_index + config.num_features_x) {
+            error = "Not enough length values for X";
+            return false;
+        }
+        
+        config.x_lengths.clear();
+        for (int i = 0; i < config.num_features_x; ++i) {
+            config.x_lengths.push_back(std::stoi(tokens[current_index + i]));
+        }
+        
+        if (tokens.size() != current_index + config.num_features_x) {
+            error = "Too many parameters provided";
+            return false;
+        }
+        
+        return true;
+        
+    } catch (const std::exception& e) {
+        error = std::string("Cannot parse parameters (") + e.what() + ")";
+        return false;
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef LEARNING_BASE_CONFIG_H
+#define LEARNING_BASE_CONFIG_H
+
+#include <string>
+#include <vector>
+
+// Описание обучающей базы (то, что пользователь вводит при загрузке
+// и что сохраняется в LearningBase/Configs/<name>.txt)
+struct LearningBaseConfig {
+    std::string name;
+    int num_samples = 0;          // <= 0 - количество записей не проверяется
+    int num_targets_y = 0;
+    std::vector<double> y_precision;
+    int num_features_x = 0;
+    std::vector<int> x_lengths;
+    
+    // Статистика значений, считается при загрузке базы (пусто - база загружена раньше):
+    // x_* - по всем значениям канала X[c], y_* - по каждой целевой переменной; std - популяционное
+    std::vector<double> x_mean, x_std, x_min, x_max;
+    std::vector<double> y_mean, y_std, y_min, y_max;
+    
+    bool hasStats() const {
+        const size_t nx = static_cast<size_t>(num_features_x);
+        const size_t ny = static_cast<size_t>(num_targets_y);
+        return x_mean.size() == nx && x_std.size() == nx && x_min.size() == nx && x_max.size() == nx &&
+               y_mean.size() == ny && y_std.size() == ny && y_min.size() == ny && y_max.size() == ny;
+    }
+};
+
+// Чтение LearningBase/Configs/<name>.txt (формат key=value, списки через запятую)
+bool loadLearningBaseConfig(const std::string& path, LearningBaseConfig& config, std::string& error);
+// Запись того же файла (статистика - если есть)
+bool writeLearningBaseConfig(const std::string& path, const LearningBaseConfig& config, std::string& error);
+
+// Строка, которую пользователь вводит при загрузке базы (её же принимает ResSysGen):
+// name num_samples num_targets_y y_precision1 ... num_features_x x_length1 ...
+bool parseLearningBaseConfig(const std::string& input, LearningBaseConfig& config, std::string& error);
+
+#endif // LEARNING_BASE_CONFIG_H
@@ -0,0 +1,381 @@
+#include "learning_base_generator.h"
+#include "learning_base_parser.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const size_t kValuesPerLine = 16;   // как в базах, которые выдаёт прибор
+const size_t kMaxValueChars = 14;   // "-1.234567e-05" + разделитель
+const size_t kMaxLineChars = 64;    // строки "nY=", "Yi=", "nX=", "array of X[c] with L values"
+const int kMaxYDecimals = 9;
+
+unsigned resolveThreads(unsigned requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Равномерное [0, 1) из старших 24 бит - ровно столько помещается в мантиссу float
+float uniform(uint64_t& state) {
+    return static_cast<float>(splitmix64(state) >> 40) * (1.0f / 16777216.0f);
+}
+
+// Что не зависит от записи: пики каналов, диапазоны и формат Y
+struct GeneratorModel {
+    std::vector<std::vector<float>> peaks; // [c][i * L + j] - пик цели i в канале c
+    std::vector<double> y_range;           // Y лежит в [0, y_range)
+    std::vector<int> y_decimals;           // -1 - без округления, печать %.6e
+    size_t max_record_bytes = 0;
+};
+
+GeneratorModel buildModel(const LearningBaseConfig& config) {
+    GeneratorModel model;
+    const int ny = config.num_targets_y;
+    const int nx = config.num_features_x;
+
+    for (int i = 0; i < ny; ++i) {
+        double precision = config.y_precision[i];
+        if (precision > 0.0) {
+            // Хотя бы сотня различимых уровней при любом шаге
+            model.y_range.push_back(std::max(1.0, 100.0 * precision));
+            int decimals = static_cast<int>(std::ceil(-std::log10(precision) - 1e-9));
+            model.y_decimals.push_back(std::clamp(decimals, 0, kMaxYDecimals));
+        } else {
+            model.y_range.push_back(1.0);
+            model.y_decimals.push_back(-1);
+        }
+    }
+
+    // Пики целей разнесены по оси канала, в соседних каналах чуть сдвинуты и шире
+    model.peaks.resize(nx);
+    size_t values = 0;
+    for (int c = 0; c < nx; ++c) {
+        const int length = config.x_lengths[c];
+        values += static_cast<size_t>(length);
+        model.peaks[c].resize(static_cast<size_t>(ny) * length);
+        const double sigma = (0.25 + 0.05 * c) / std::max(ny, 1);
+        for (int i = 0; i < ny; ++i) {
+            const double center = (i + 0.5 + 0.3 * std::sin(1.7 * c + i)) / ny;
+            for (int j = 0; j < length; ++j) {
+                const double t = (j + 0.5) / length - center;
+                model.peaks[c][static_cast<size_t>(i) * length + j] =
+                    static_cast<float>(std::exp(-0.5 * t * t / (sigma * sigma)));
+            }
+        }
+    }
+
+    model.max_record_bytes = std::strlen(kLearningBaseRecordMarker) + 1 + kMaxLineChars * (2 + ny + nx) +
+                             values * kMaxValueChars;
+    return model;
+}
+
+char* appendText(char* out, const char* text) {
+    size_t length = std::strlen(text);
+    std::memcpy(out, text, length);
+    return out + length;
+}
+
+// 10^k для k в [-kPow10Bias, kPow10Bias): степени, на которые умножается float при печати
+const int kPow10Bias = 64;
+
+struct Pow10Table {
+    double values[2 * kPow10Bias];
+    Pow10Table() {
+        for (int k = -kPow10Bias; k < kPow10Bias; ++k) {
+            values[k + kPow10Bias] = std::pow(10.0, k);
+        }
+    }
+};
+
+const Pow10Table kPow10;
+
+const char kDigitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// %.6e для float без printf и to_chars (они - основная часть времени генерации): мантисса -
+// целое из 7 цифр. Редко, на границе округления, последняя цифра расходится с printf на
+// единицу; для синтетики это неважно, а результат так же детерминирован
+char* appendScientific(char* out, float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if (bits >> 31) {
+        *out++ = '-';
+    }
+    const int biased = static_cast<int>((bits >> 23) & 0xFF);
+    if (biased == 0 || biased == 0xFF) { // ноль, денормализованные и не-числа синтетике не нужны
+        return appendText(out, "0.000000e+00");
+    }
+    const double v = std::fabs(static_cast<double>(value));
+    // floor(log10(2) * e2) целочисленно: оценка десятичного порядка, ошибка не больше единицы
+    int exponent = ((biased - 127) * 78913) >> 18;
+    auto scaled = [&]() {
+        return static_cast<int64_t>(v * kPow10.values[6 - exponent + kPow10Bias] + 0.5);
+    };
+    int64_t mantissa = scaled();
+    if (mantissa >= 10000000) {
+        ++exponent;
+        mantissa = scaled();
+    } else if (mantissa < 1000000) {
+        --exponent;
+        mantissa = scaled();
+    }
+    if (mantissa >= 10000000) { // 9.9999995 округлилось до 10.000000
+        ++exponent;
+        mantissa = 1000000;
+    }
+
+    // Первая цифра, точка и три пары цифр по таблице
+    const uint32_t head = static_cast<uint32_t>(mantissa / 1000000);
+    uint32_t tail = static_cast<uint32_t>(mantissa % 1000000);
+    *out++ = static_cast<char>('0' + head);
+    *out++ = '.';
+    std::memcpy(out, kDigitPairs + 2 * (tail / 10000), 2);
+    tail %= 10000;
+    std::memcpy(out + 2, kDigitPairs + 2 * (tail / 100), 2);
+    std::memcpy(out + 4, kDigitPairs + 2 * (tail % 100), 2);
+    out += 6;
+    *out++ = 'e';
+    *out++ = exponent < 0 ? '-' : '+';
+    int magnitude = exponent < 0 ? -exponent : exponent;
+    std::memcpy(out, kDigitPairs + 2 * magnitude, 2);
+    return out + 2;
+}
+
+template <typename T>
+char* appendInt(char* out, T value) {
+    return std::to_chars(out, out + 24, value).ptr;
+}
+
+// Запись k: свой генератор от (seed, k), числа - как %.6e у printf
+char* writeRecord(char* out, const LearningBaseConfig& config, const GeneratorModel& model, uint64_t seed,
+                  uint64_t index, std::vector<float>& amplitudes, std::vector<float>& channel) {
+    const int ny = config.num_targets_y;
+    const int nx = config.num_features_x;
+    uint64_t state = seed ^ (index * 0xD1B54A32D192ED03ull);
+    splitmix64(state);
+
+    out = appendText(out, kLearningBaseRecordMarker);
+    out = appendText(out, "\nnY=");
+    out = appendInt(out, ny);
+    *out++ = '\n';
+    for (int i = 0; i < ny; ++i) {
+        double y = uniform(state) * model.y_range[i];
+        *out++ = 'Y';
+        out = appendInt(out, i + 1);
+        *out++ = '=';
+        if (model.y_decimals[i] >= 0) {
+            y = std::round(y / config.y_precision[i]) * config.y_precision[i];
+            out = std::to_chars(out, out + 48, y, std::chars_format::fixed, model.y_decimals[i]).ptr;
+        } else {
+            out = std::to_chars(out, out + 48, y, std::chars_format::scientific, 6).ptr;
+        }
+        *out++ = '\n';
+        amplitudes[i] = static_cast<float>(y / model.y_range[i]);
+    }
+
+    out = appendText(out, "nX=");
+    out = appendInt(out, nx);
+    *out++ = '\n';
+    for (int c = 0; c < nx; ++c) {
+        const size_t length = static_cast<size_t>(config.x_lengths[c]);
+        out = appendText(out, "array of X[");
+        out = appendInt(out, c);
+        out = appendText(out, "] with ");
+        out = appendInt(out, length);
+        out = appendText(out, " values\n");
+
+        float* values = channel.data();
+        for (size_t j = 0; j < length; ++j) {
+            values[j] = 0.01f * (uniform(state) - 0.5f);
+        }
+        for (int i = 0; i < ny; ++i) {
+            const float a = amplitudes[i];
+            const float* peak = model.peaks[c].data() + static_cast<size_t>(i) * length;
+            for (size_t j = 0; j < length; ++j) {
+                values[j] += a * peak[j];
+            }
+        }
+        for (size_t j = 0; j < length; ++j) {
+            out = appendScientific(out, values[j]);
+            *out++ = (j % kValuesPerLine == kValuesPerLine - 1 || j + 1 == length) ? '\n' : ' ';
+        }
+    }
+    return out;
+}
+
+bool validateConfig(const LearningBaseConfig& config, std::string& error) {
+    if (config.name.empty()) {
+        error = "Empty learning base name";
+    } else if (config.num_samples <= 0) {
+        error = "num_samples must be positive";
+    } else if (config.num_targets_y <= 0) {
+        error = "num_targets_y must be positive";
+    } else if (config.y_precision.size() != static_cast<size_t>(config.num_targets_y)) {
+        error = "y_precision count does not match num_targets_y";
+    } else if (config.num_features_x <= 0 || config.x_lengths.size() != static_cast<size_t>(config.num_features_x)) {
+        error = "x_lengths count does not match num_features_x";
+    } else if (std::any_of(config.x_lengths.begin(), config.x_lengths.end(), [](int length) { return length <= 0; })) {
+        error = "x_lengths must be positive";
+    } else if (std::any_of(config.y_precision.begin(), config.y_precision.end(),
+                           [](double precision) { return !std::isfinite(precision) || precision < 0.0; })) {
+        error = "y_precision must be finite and non-negative";
+    } else {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+LearningBaseGenerator::LearningBaseGenerator(uint64_t seed, unsigned num_threads, size_t block_bytes)
+    : seed_(seed), num_threads_(resolveThreads(num_threads)), block_bytes_(std::max<size_t>(block_bytes, 64 << 10)) {}
+
+bool LearningBaseGenerator::generate(const LearningBaseConfig& config, const std::string& path,
+                                     LearningBaseGeneratorStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    last_error_.clear();
+    if (!validateConfig(config, last_error_)) {
+        return false;
+    }
+
+    const GeneratorModel model = buildModel(config);
+    const uint64_t num_samples = static_cast<uint64_t>(config.num_samples);
+    const uint64_t records_per_block = std::max<uint64_t>(1, block_bytes_ / model.max_record_bytes);
+    const uint64_t num_blocks = (num_samples + records_per_block - 1) / records_per_block;
+    const unsigned threads = static_cast<unsigned>(std::min<uint64_t>(num_threads_, num_blocks));
+    const size_t max_channel = static_cast<size_t>(*std::max_element(config.x_lengths.begin(), config.x_lengths.end()));
+
+    std::string tmp_path = path + ".tmp";
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        last_error_ = "Cannot create file: " + tmp_path;
+        return false;
+    }
+    auto fail = [&](const std::string& error) {
+        last_error_ = error;
+        out.close();
+        std::error_code ec;
+        fs::remove(tmp_path, ec);
+        return false;
+    };
+
+    std::string header = "Synthetic learning base " + config.name + " (seed " + std::to_string(seed_) + ")\n" +
+                         "array of records with " + std::to_string(num_samples) + " records\n";
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    uint64_t bytes_written = header.size();
+
+    // Кольцо слотов: блок b готовится в слоте b % slots, пока писатель не дошёл до b - slots.
+    // Генераторы не ждут друг друга, а память ограничена slots блоками
+    struct Slot {
+        std::vector<char> text;
+        size_t size = 0;
+        uint64_t ready_block = UINT64_MAX;
+    };
+    const size_t num_slots = static_cast<size_t>(threads) * 2;
+    std::vector<Slot> slots(num_slots);
+    std::mutex mutex;
+    std::condition_variable block_ready;
+    std::condition_variable slot_free;
+    uint64_t next_block = 0;
+    uint64_t blocks_written = 0;
+    bool aborted = false;
+
+    auto generateBlocks = [&]() {
+        std::vector<float> amplitudes(static_cast<size_t>(config.num_targets_y));
+        std::vector<float> channel(max_channel);
+        for (;;) {
+            uint64_t block;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (aborted || next_block == num_blocks) {
+                    return;
+                }
+                block = next_block++;
+                slot_free.wait(lock, [&] { return aborted || block < blocks_written + num_slots; });
+                if (aborted) {
+                    return;
+                }
+            }
+
+            Slot& slot = slots[block % num_slots];
+            const uint64_t first = block * records_per_block;
+            const uint64_t last = std::min(num_samples, first + records_per_block);
+            slot.text.resize(static_cast<size_t>(last - first) * model.max_record_bytes);
+            char* cursor = slot.text.data();
+            for (uint64_t k = first; k < last; ++k) {
+                cursor = writeRecord(cursor, config, model, seed_, k, amplitudes, channel);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.size = static_cast<size_t>(cursor - slot.text.data());
+            slot.ready_block = block;
+            block_ready.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back(generateBlocks);
+    }
+
+    // Писатель - вызывающий поток: блоки уходят в файл строго по порядку
+    bool write_failed = false;
+    for (uint64_t block = 0; block < num_blocks && !write_failed; ++block) {
+        Slot& slot = slots[block % num_slots];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            block_ready.wait(lock, [&] { return slot.ready_block == block; });
+        }
+        out.write(slot.text.data(), static_cast<std::streamsize>(slot.size));
+        bytes_written += slot.size;
+        write_failed = !out;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        blocks_written = block + 1;
+        aborted = write_failed;
+        slot_free.notify_all();
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    out.close();
+    if (write_failed || !out) {
+        return fail("Write failed: " + tmp_path);
+    }
+    std::error_code ec;
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+        return fail("Cannot rename " + tmp_path + ": " + ec.message());
+    }
+
+    if (stats) {
+        stats->num_samples = num_samples;
+        stats->bytes_written = bytes_written;
+        stats->elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return true;
+}
@@ -0,0 +1,39 @@
+#ifndef LEARNING_BASE_GENERATOR_H
+#define LEARNING_BASE_GENERATOR_H
+
+#include <string>
+#include <cstdint>
+#include "learning_base_config.h"
+
+struct LearningBaseGeneratorStats {
+    uint64_t num_samples = 0;
+    uint64_t bytes_written = 0;
+    double elapsed_ms = 0.0;
+};
+
+// Синтетическая обучающая база в текстовом формате new*record - для нагрузочных
+// проверок загрузки, конвертации, обучения и предсказания на базах любого размера.
+// Каналы X[c] - гауссовы пики на шуме, амплитуды пиков - целевые Y (округлённые до
+// y_precision), так что моделям есть что выучить. Записи генерируются блоками
+// параллельно, блоки пишутся по порядку одним потоком большими кусками. Запись k
+// зависит только от seed и k, поэтому файл байт в байт один и тот же при любом
+// числе потоков.
+class LearningBaseGenerator {
+public:
+    explicit LearningBaseGenerator(uint64_t seed = 42, unsigned num_threads = 0, size_t block_bytes = 4 << 20);
+
+    // Через временный файл и rename: оборванная генерация не оставляет полубазу
+    bool generate(const LearningBaseConfig& config, const std::string& path, LearningBaseGeneratorStats* stats = nullptr);
+
+    const std::string& lastError() const { return last_error_; }
+    unsigned numThreads() const { return num_threads_; }
+    uint64_t seed() const { return seed_; }
+
+private:
+    uint64_t seed_;
+    unsigned num_threads_;
+    size_t block_bytes_;
+    std::string last_error_;
+};
+
+#endif // LEARNING_BASE_GENERATOR_H
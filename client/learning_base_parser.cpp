@@ -0,0 +1,338 @@
+#include "learning_base_parser.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+const char kLearningBaseRecordMarker[] = "*******************new*record*******************";
+
+namespace {
+
+const std::string_view kMarker(kLearningBaseRecordMarker);
+
+// Записи раздаются потокам блоками, чтобы не дёргать счётчик на каждую
+const size_t kRecordsPerTask = 16;
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+std::string_view trimView(std::string_view s) {
+    size_t begin = 0;
+    while (begin < s.size() && isSpace(s[begin])) {
+        ++begin;
+    }
+    size_t end = s.size();
+    while (end > begin && isSpace(s[end - 1])) {
+        --end;
+    }
+    return s.substr(begin, end - begin);
+}
+
+inline bool parseFloat(const char* begin, const char* end, float& value) {
+    if (begin != end && *begin == '+') {
+        ++begin; // from_chars не принимает явный плюс, а float() в Python - принимает
+    }
+    auto result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+inline bool parseInt(std::string_view s, int& value) {
+    s = trimView(s);
+    auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+    return result.ec == std::errc() && result.ptr == s.data() + s.size();
+}
+
+unsigned resolveThreads(unsigned requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+} // namespace
+
+LearningBaseRecordParser::LearningBaseRecordParser(const LearningBaseConfig& config)
+    : config_(config), x_counts_(config.num_features_x, 0) {}
+
+bool LearningBaseRecordParser::parse(const char* begin, const char* end, float* const* x_out, float* y_out) {
+    std::fill(x_counts_.begin(), x_counts_.end(), 0);
+    error_.clear();
+
+    int y_count = 0;
+    int channel = -1;
+    int channel_length = 0;
+    float* channel_out = nullptr;
+    int* channel_count = nullptr;
+
+    const char* p = begin;
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* line_end = nl ? nl : end;
+        std::string_view line = trimView(std::string_view(p, line_end - p));
+        p = nl ? nl + 1 : end;
+
+        if (line.empty()) {
+            continue;
+        }
+
+        if (line.compare(0, 3, "nY=") == 0) {
+            continue;
+        }
+
+        if (line[0] == 'Y') {
+            size_t eq = line.find('=');
+            if (eq != std::string_view::npos && line.find('=', eq + 1) == std::string_view::npos) {
+                std::string_view value = trimView(line.substr(eq + 1));
+                float y;
+                if (parseFloat(value.data(), value.data() + value.size(), y)) {
+                    if (y_count < config_.num_targets_y) {
+                        y_out[y_count] = y;
+                    }
+                    ++y_count;
+                }
+            }
+            continue;
+        }
+
+        if (line.compare(0, 3, "nX=") == 0) {
+            int nx = 0;
+            if (!parseInt(line.substr(3), nx)) {
+                error_ = "Invalid nX line: " + std::string(line);
+                return false;
+            }
+            if (nx != config_.num_features_x) {
+                error_ = "Feature count mismatch: config has " + std::to_string(config_.num_features_x) +
+                         ", data has " + std::to_string(nx);
+                return false;
+            }
+            continue;
+        }
+
+        size_t array_pos = line.find("array of X[");
+        if (array_pos != std::string_view::npos && line.find("with") != std::string_view::npos) {
+            size_t index_begin = array_pos + 11;
+            size_t index_end = line.find(']', index_begin);
+            int index = -1;
+            if (index_end == std::string_view::npos ||
+                !parseInt(line.substr(index_begin, index_end - index_begin), index) ||
+                index < 0 || index >= config_.num_features_x) {
+                error_ = "Invalid feature header: " + std::string(line);
+                return false;
+            }
+            channel = index;
+            channel_length = config_.x_lengths[channel];
+            channel_out = x_out[channel];
+            channel_count = &x_counts_[channel];
+            *channel_count = 0;
+            continue;
+        }
+
+        if (channel < 0) {
+            continue;
+        }
+
+        // Строка с данными эксперимента: числа через пробельные символы
+        const char* q = line.data();
+        const char* line_stop = q + line.size();
+        while (q < line_stop) {
+            while (q < line_stop && isSpace(*q)) {
+                ++q;
+            }
+            const char* token = q;
+            while (q < line_stop && !isSpace(*q)) {
+                ++q;
+            }
+            if (token == q) {
+                break;
+            }
+            float value;
+            if (parseFloat(token, q, value)) {
+                if (*channel_count < channel_length) {
+                    channel_out[*channel_count] = value;
+                }
+                ++*channel_count;
+            }
+        }
+    }
+
+    if (y_count != config_.num_targets_y) {
+        error_ = "Target variables count mismatch: config has " + std::to_string(config_.num_targets_y) +
+                 ", data has " + std::to_string(y_count);
+        return false;
+    }
+
+    for (int c = 0; c < config_.num_features_x; ++c) {
+        if (x_counts_[c] != config_.x_lengths[c]) {
+            error_ = "Feature X[" + std::to_string(c) + "] length mismatch: config has " +
+                     std::to_string(config_.x_lengths[c]) + ", data has " + std::to_string(x_counts_[c]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void learningBaseRecordBody(const char* marker, const char* stop, bool last, const char*& begin, const char*& end) {
+    // Запись начинается со строки после маркера и заканчивается перед строкой следующего
+    begin = marker + kMarker.size();
+    const char* nl = static_cast<const char*>(std::memchr(begin, '\n', stop - begin));
+    begin = nl ? nl + 1 : stop;
+    end = stop;
+    if (!last) {
+        while (end > begin && end[-1] != '\n') {
+            --end;
+        }
+    }
+}
+
+std::vector<uint64_t> findRecordOffsets(const char* data, size_t size, unsigned num_threads) {
+    std::vector<uint64_t> offsets;
+    if (size < kMarker.size()) {
+        return offsets;
+    }
+
+    // Маленькие файлы не стоят запуска потоков
+    const size_t min_range = 4 << 20;
+    unsigned threads = std::max<unsigned>(1, std::min<size_t>(resolveThreads(num_threads), size / min_range));
+
+    std::vector<std::vector<uint64_t>> partial(threads);
+    auto scan = [&](unsigned t) {
+        size_t range_begin = size * t / threads;
+        size_t range_end = size * (t + 1) / threads;
+        // Маркер должен начинаться внутри диапазона, но может выходить за его конец
+        size_t search_end = std::min(size, range_end + kMarker.size() - 1);
+        std::string_view view(data + range_begin, search_end - range_begin);
+
+        size_t pos = view.find(kMarker);
+        while (pos != std::string_view::npos && range_begin + pos < range_end) {
+            partial[t].push_back(range_begin + pos);
+            pos = view.find(kMarker, pos + kMarker.size());
+        }
+    };
+
+    if (threads == 1) {
+        scan(0);
+        return std::move(partial[0]);
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back(scan, t);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (auto& part : partial) {
+        offsets.insert(offsets.end(), part.begin(), part.end());
+    }
+    return offsets;
+}
+
+LearningBaseParser::LearningBaseParser(unsigned num_threads)
+    : num_threads_(resolveThreads(num_threads)) {}
+
+bool LearningBaseParser::parse(const std::string& path, const LearningBaseConfig& config, LearningBaseData& data) {
+    MappedFile file;
+    if (!file.open(path)) {
+        last_error_ = "Cannot map file: " + path;
+        return false;
+    }
+    return parse(file.data(), file.size(), config, data);
+}
+
+bool LearningBaseParser::parse(const char* text, size_t size, const LearningBaseConfig& config, LearningBaseData& data) {
+    last_error_.clear();
+
+    if (config.num_features_x != static_cast<int>(config.x_lengths.size())) {
+        last_error_ = "Features count mismatch: config has " + std::to_string(config.num_features_x) +
+                      ", x_lengths has " + std::to_string(config.x_lengths.size());
+        return false;
+    }
+
+    std::vector<uint64_t> offsets = findRecordOffsets(text, size, num_threads_);
+    const size_t num_records = offsets.size();
+
+    if (num_records == 0) {
+        last_error_ = "No records found";
+        return false;
+    }
+    if (config.num_samples > 0 && num_records != static_cast<size_t>(config.num_samples)) {
+        last_error_ = "Sample count mismatch: config has " + std::to_string(config.num_samples) +
+                      ", data has " + std::to_string(num_records);
+        return false;
+    }
+
+    data.num_samples = static_cast<int>(num_records);
+    data.num_targets_y = config.num_targets_y;
+    data.x_lengths = config.x_lengths;
+    data.x.assign(config.num_features_x, {});
+    for (int c = 0; c < config.num_features_x; ++c) {
+        data.x[c].resize(num_records * config.x_lengths[c]);
+    }
+    data.y.resize(num_records * config.num_targets_y);
+    data.record_offsets = std::move(offsets);
+
+    std::atomic<size_t> next_task{0};
+    std::atomic<bool> failed{false};
+    std::mutex error_mutex;
+    size_t error_record = num_records;
+
+    auto worker = [&]() {
+        LearningBaseRecordParser record_parser(config);
+        std::vector<float*> x_out(config.num_features_x);
+
+        while (!failed.load(std::memory_order_relaxed)) {
+            size_t first = next_task.fetch_add(kRecordsPerTask);
+            if (first >= num_records) {
+                break;
+            }
+            size_t last = std::min(num_records, first + kRecordsPerTask);
+
+            for (size_t i = first; i < last; ++i) {
+                const bool last_record = i + 1 == num_records;
+                const char* stop = last_record ? text + size : text + data.record_offsets[i + 1];
+                const char* begin;
+                const char* end;
+                learningBaseRecordBody(text + data.record_offsets[i], stop, last_record, begin, end);
+
+                for (int c = 0; c < config.num_features_x; ++c) {
+                    x_out[c] = data.x[c].data() + i * config.x_lengths[c];
+                }
+                float* y_out = data.y.data() + i * config.num_targets_y;
+
+                if (!record_parser.parse(begin, end, x_out.data(), y_out)) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (i < error_record) {
+                        error_record = i;
+                        last_error_ = "Record #" + std::to_string(i + 1) + ": " + record_parser.error();
+                    }
+                    failed.store(true, std::memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+    };
+
+    unsigned threads = static_cast<unsigned>(
+        std::min<size_t>(num_threads_, (num_records + kRecordsPerTask - 1) / kRecordsPerTask));
+    if (threads <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back(worker);
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    return !failed.load();
+}
@@ -0,0 +1,69 @@
+#ifndef LEARNING_BASE_PARSER_H
+#define LEARNING_BASE_PARSER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "learning_base_config.h"
+
+// Разделитель записей в текстовой обучающей базе
+extern const char kLearningBaseRecordMarker[];
+
+// Содержимое обучающей базы в непрерывных буферах по каналам
+struct LearningBaseData {
+    int num_samples = 0;
+    int num_targets_y = 0;
+    std::vector<int> x_lengths;
+    std::vector<std::vector<float>> x;      // x[c]: num_samples * x_lengths[c], построчно
+    std::vector<float> y;                   // num_samples * num_targets_y
+    std::vector<uint64_t> record_offsets;   // смещение маркера каждой записи в исходном файле
+
+    const float* sampleX(int channel, int sample) const {
+        return x[channel].data() + static_cast<size_t>(sample) * x_lengths[channel];
+    }
+    const float* sampleY(int sample) const {
+        return y.data() + static_cast<size_t>(sample) * num_targets_y;
+    }
+};
+
+// Разбор одной записи (текст после строки-маркера) прямо в буферы каналов.
+// Повторяет правила parse_data_file из python_server/preproc/Preprocess.py
+class LearningBaseRecordParser {
+public:
+    explicit LearningBaseRecordParser(const LearningBaseConfig& config);
+
+    // x_out[c] - место под x_lengths[c] значений канала c, y_out - под num_targets_y
+    bool parse(const char* begin, const char* end, float* const* x_out, float* y_out);
+    const std::string& error() const { return error_; }
+
+private:
+    const LearningBaseConfig& config_;
+    std::vector<int> x_counts_;
+    std::string error_;
+};
+
+// Границы текста записи: marker - начало её маркера, stop - начало маркера следующей
+// записи (или конец файла, тогда last = true)
+void learningBaseRecordBody(const char* marker, const char* stop, bool last, const char*& begin, const char*& end);
+
+// Поиск всех маркеров записей; поиск делится между потоками по диапазонам файла
+std::vector<uint64_t> findRecordOffsets(const char* data, size_t size, unsigned num_threads);
+
+// Параллельный разбор текстовой базы (mmap) с проверкой по LearningBaseConfig
+class LearningBaseParser {
+public:
+    explicit LearningBaseParser(unsigned num_threads = 0); // 0 - по числу ядер
+
+    bool parse(const std::string& path, const LearningBaseConfig& config, LearningBaseData& data);
+    bool parse(const char* text, size_t size, const LearningBaseConfig& config, LearningBaseData& data);
+
+    const std::string& lastError() const { return last_error_; }
+    unsigned numThreads() const { return num_threads_; }
+
+private:
+    unsigned num_threads_;
+    std::string last_error_;
+};
+
+#endif // LEARNING_BASE_PARSER_H
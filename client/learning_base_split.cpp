@@ -0,0 +1,163 @@
+#include "learning_base_split.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+
+namespace fs = std::filesystem;
+
+const char kLearningBaseSplitMagic[8] = {'R', 'S', 'S', 'P', 'L', 'I', 'T', '\0'};
+
+namespace {
+
+const uint64_t kFixedHeaderSize = 64;
+const uint64_t kAlignment = 64;
+
+template <typename T>
+void appendValue(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+// Равномерное число в [0, bound): отбрасываем хвост диапазона, который дал бы перекос по модулю
+uint64_t uniformBelow(std::mt19937_64& rng, uint64_t bound) {
+    const uint64_t max = std::numeric_limits<uint64_t>::max();
+    const uint64_t limit = max - max % bound;
+    uint64_t value;
+    do {
+        value = rng();
+    } while (value >= limit);
+    return value % bound;
+}
+
+} // namespace
+
+bool makeLearningBaseSplit(uint64_t num_samples, uint64_t seed, double train_ratio, unsigned num_folds,
+                           LearningBaseSplit& split, std::string& error) {
+    if (num_samples == 0) {
+        error = "Empty learning base";
+        return false;
+    }
+    if (!(train_ratio > 0.0 && train_ratio < 1.0)) {
+        error = "Train ratio must be in (0, 1): " + std::to_string(train_ratio);
+        return false;
+    }
+    if (num_folds == 1 || num_folds > num_samples) {
+        error = "Invalid number of folds: " + std::to_string(num_folds) + " for " + std::to_string(num_samples) +
+                " samples";
+        return false;
+    }
+
+    split = LearningBaseSplit();
+    split.num_samples = num_samples;
+    split.seed = seed;
+    split.train_count = static_cast<uint64_t>(static_cast<double>(num_samples) * train_ratio);
+
+    split.permutation.resize(num_samples);
+    std::iota(split.permutation.begin(), split.permutation.end(), uint64_t{0});
+    std::mt19937_64 rng(seed);
+    for (uint64_t i = num_samples - 1; i > 0; --i) {
+        std::swap(split.permutation[i], split.permutation[uniformBelow(rng, i + 1)]);
+    }
+
+    // Фолды - подряд идущие куски перестановки, размеры отличаются не больше чем на 1
+    for (unsigned k = 0; num_folds > 0 && k <= num_folds; ++k) {
+        split.fold_bounds.push_back(num_samples * k / num_folds);
+    }
+    return true;
+}
+
+bool writeLearningBaseSplit(const std::string& path, const LearningBaseSplit& split, std::string& error) {
+    if (split.permutation.size() != split.num_samples) {
+        error = "Split permutation does not match sample count";
+        return false;
+    }
+
+    const uint32_t num_folds = split.fold_bounds.empty() ? 0 : static_cast<uint32_t>(split.fold_bounds.size() - 1);
+    uint64_t header_size = kFixedHeaderSize + split.fold_bounds.size() * sizeof(uint64_t);
+    header_size = (header_size + kAlignment - 1) / kAlignment * kAlignment;
+
+    std::string header;
+    header.reserve(header_size);
+    header.append(kLearningBaseSplitMagic, sizeof(kLearningBaseSplitMagic));
+    appendValue<uint32_t>(header, kLearningBaseSplitVersion);
+    appendValue<uint32_t>(header, static_cast<uint32_t>(header_size));
+    appendValue<uint64_t>(header, split.num_samples);
+    appendValue<uint64_t>(header, split.seed);
+    appendValue<uint64_t>(header, split.train_count);
+    appendValue<uint32_t>(header, num_folds);
+    header.resize(kFixedHeaderSize, '\0');
+    for (uint64_t bound : split.fold_bounds) {
+        appendValue<uint64_t>(header, bound);
+    }
+    header.resize(header_size, '\0');
+
+    // Пишем во временный файл и переименовываем, чтобы сервер не увидел половину индексов
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            error = "Cannot create file: " + tmp_path;
+            return false;
+        }
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        file.write(reinterpret_cast<const char*>(split.permutation.data()),
+                   static_cast<std::streamsize>(split.permutation.size() * sizeof(uint64_t)));
+        if (!file) {
+            error = "Write failed: " + tmp_path;
+            file.close();
+            fs::remove(tmp_path);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+        error = "Cannot rename " + tmp_path + ": " + ec.message();
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+bool readLearningBaseSplitHeader(const std::string& path, LearningBaseSplit& split, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        error = "Cannot open file: " + path;
+        return false;
+    }
+
+    char magic[sizeof(kLearningBaseSplitMagic)];
+    uint32_t version = 0, header_size = 0, num_folds = 0;
+    split = LearningBaseSplit();
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, kLearningBaseSplitMagic, sizeof(magic)) != 0) {
+        error = "Not a learning base split: " + path;
+        return false;
+    }
+    bool ok = readValue(file, version) && readValue(file, header_size) && readValue(file, split.num_samples) &&
+              readValue(file, split.seed) && readValue(file, split.train_count) && readValue(file, num_folds);
+    if (!ok || version != kLearningBaseSplitVersion) {
+        error = "Unsupported learning base split: " + path;
+        return false;
+    }
+
+    file.seekg(static_cast<std::streamoff>(kFixedHeaderSize));
+    split.fold_bounds.resize(num_folds > 0 ? num_folds + 1 : 0);
+    for (auto& bound : split.fold_bounds) {
+        if (!readValue(file, bound)) {
+            error = "Corrupted learning base split header: " + path;
+            return false;
+        }
+    }
+    return true;
+}
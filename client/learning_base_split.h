@@ -0,0 +1,43 @@
+#ifndef LEARNING_BASE_SPLIT_H
+#define LEARNING_BASE_SPLIT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Файл разбиения обучающей базы (.rssplit) рядом с .rslb, little-endian.
+//
+//   [0, 64)      заголовок: magic "RSSPLIT\0", version, header_size, num_samples,
+//                seed, train_count, num_folds
+//   [64, ...)    uint64 fold_bounds[num_folds + 1]
+//   header_size  uint64 permutation[num_samples] - номера записей .rslb
+//
+// train = permutation[0, train_count), test = permutation[train_count, num_samples).
+// Проверочная часть k-го фолда - permutation[fold_bounds[k], fold_bounds[k + 1]),
+// обучающая - все остальные фолды. Сервер отображает файл в память и берёт
+// записи из .rslb по этим индексам, не копируя базу.
+extern const char kLearningBaseSplitMagic[8];
+const uint32_t kLearningBaseSplitVersion = 1;
+
+struct LearningBaseSplit {
+    uint64_t num_samples = 0;
+    uint64_t seed = 0;
+    uint64_t train_count = 0;
+    std::vector<uint64_t> fold_bounds;  // пусто - без фолдов
+    std::vector<uint64_t> permutation;
+};
+
+// Перестановка Фишера-Йетса на mt19937_64 с собственным ограничением диапазона
+// (std::uniform_int_distribution в MSVC и libstdc++ даёт разные числа), поэтому
+// один seed даёт одно и то же разбиение на любой платформе.
+// train_count = floor(num_samples * train_ratio), как int() в Python
+bool makeLearningBaseSplit(uint64_t num_samples, uint64_t seed, double train_ratio, unsigned num_folds,
+                           LearningBaseSplit& split, std::string& error);
+
+bool writeLearningBaseSplit(const std::string& path, const LearningBaseSplit& split, std::string& error);
+
+// Только заголовок и границы фолдов (permutation остаётся пустым) - проверить, что файл
+// сделан с текущими настройками, не читая индексы
+bool readLearningBaseSplitHeader(const std::string& path, LearningBaseSplit& split, std::string& error);
+
+#endif // LEARNING_BASE_SPLIT_H
@@ -0,0 +1,142 @@
+#include "learning_base_stats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const int kLanes = 8;
+
+} // namespace
+
+void RunningStats::add(const float* values, size_t n) {
+    if (n == 0) {
+        return;
+    }
+
+    // Первый проход: сумма, min, max (блок - один канал записи, он ещё в кэше)
+    double sum[kLanes] = {};
+    float lo[kLanes], hi[kLanes];
+    std::fill(lo, lo + kLanes, values[0]);
+    std::fill(hi, hi + kLanes, values[0]);
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (int l = 0; l < kLanes; ++l) {
+            float v = values[i + l];
+            sum[l] += v;
+            lo[l] = v < lo[l] ? v : lo[l];
+            hi[l] = v > hi[l] ? v : hi[l];
+        }
+    }
+    for (; i < n; ++i) {
+        sum[0] += values[i];
+        lo[0] = std::min(lo[0], values[i]);
+        hi[0] = std::max(hi[0], values[i]);
+    }
+    double total = 0.0;
+    float block_min = lo[0], block_max = hi[0];
+    for (int l = 0; l < kLanes; ++l) {
+        total += sum[l];
+        block_min = std::min(block_min, lo[l]);
+        block_max = std::max(block_max, hi[l]);
+    }
+    const double block_mean = total / static_cast<double>(n);
+
+    // Второй проход: M2 относительно среднего блока, без потери точности на больших средних
+    double sq[kLanes] = {};
+    i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (int l = 0; l < kLanes; ++l) {
+            double d = values[i + l] - block_mean;
+            sq[l] += d * d;
+        }
+    }
+    double block_m2 = 0.0;
+    for (; i < n; ++i) {
+        double d = values[i] - block_mean;
+        block_m2 += d * d;
+    }
+    for (int l = 0; l < kLanes; ++l) {
+        block_m2 += sq[l];
+    }
+
+    mergeBlock(n, block_mean, block_m2, block_min, block_max);
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.count_ > 0) {
+        mergeBlock(other.count_, other.mean(), other.m2_, other.min_, other.max_);
+    }
+}
+
+void RunningStats::mergeBlock(uint64_t count, double mean, double m2, double min, double max) {
+    if (count_ == 0) {
+        count_ = count;
+        mean_ = mean;
+        mean_error_ = 0.0;
+        m2_ = m2;
+        min_ = min;
+        max_ = max;
+        return;
+    }
+
+    const double n_a = static_cast<double>(count_);
+    const double n_b = static_cast<double>(count);
+    const double n = n_a + n_b;
+    const double delta = mean - this->mean();
+
+    // mean += delta * n_b / n с компенсацией Кахана: mean_error_ - потерянные младшие разряды
+    double step = delta * n_b / n - mean_error_;
+    double updated = mean_ + step;
+    mean_error_ = (updated - mean_) - step;
+    mean_ = updated;
+
+    m2_ += m2 + delta * delta * n_a * n_b / n;
+    count_ += count;
+    min_ = std::min(min_, min);
+    max_ = std::max(max_, max);
+}
+
+double RunningStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+void LearningBaseStats::reset(const LearningBaseConfig& config) {
+    x.assign(config.num_features_x, RunningStats());
+    y.assign(config.num_targets_y, RunningStats());
+}
+
+void LearningBaseStats::addRecord(const float* const* x_values, const int* x_lengths, const float* y_values) {
+    for (size_t c = 0; c < x.size(); ++c) {
+        x[c].add(x_values[c], static_cast<size_t>(x_lengths[c]));
+    }
+    for (size_t i = 0; i < y.size(); ++i) {
+        y[i].add(y_values + i, 1);
+    }
+}
+
+void LearningBaseStats::merge(const LearningBaseStats& other) {
+    for (size_t c = 0; c < x.size() && c < other.x.size(); ++c) {
+        x[c].merge(other.x[c]);
+    }
+    for (size_t i = 0; i < y.size() && i < other.y.size(); ++i) {
+        y[i].merge(other.y[i]);
+    }
+}
+
+void LearningBaseStats::exportTo(LearningBaseConfig& config) const {
+    auto fill = [](const std::vector<RunningStats>& stats, std::vector<double>& mean, std::vector<double>& stddev,
+                   std::vector<double>& min, std::vector<double>& max) {
+        mean.clear();
+        stddev.clear();
+        min.clear();
+        max.clear();
+        for (const auto& s : stats) {
+            mean.push_back(s.mean());
+            stddev.push_back(s.stddev());
+            min.push_back(s.min());
+            max.push_back(s.max());
+        }
+    };
+    fill(x, config.x_mean, config.x_std, config.x_min, config.x_max);
+    fill(y, config.y_mean, config.y_std, config.y_min, config.y_max);
+}
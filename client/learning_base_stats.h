@@ -0,0 +1,50 @@
+#ifndef LEARNING_BASE_STATS_H
+#define LEARNING_BASE_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "learning_base_config.h"
+
+// Накопитель count/mean/M2/min/max для одного канала. Значения добавляются
+// блоками (канал одной записи): статистика блока считается на kLanes
+// независимых аккумуляторах, которые компилятор разворачивает в SIMD, а
+// затем сливается с накопленной по формуле Чана (Welford для блоков).
+// Поправка Кахана на среднем не даёт ему плыть на миллиардах значений.
+class RunningStats {
+public:
+    void add(const float* values, size_t n);
+    void merge(const RunningStats& other);
+
+    uint64_t count() const { return count_; }
+    double mean() const { return mean_ - mean_error_; }
+    double variance() const { return count_ > 0 ? m2_ / static_cast<double>(count_) : 0.0; } // как numpy.std
+    double stddev() const;
+    double min() const { return min_; }
+    double max() const { return max_; }
+
+private:
+    uint64_t count_ = 0;
+    double mean_ = 0.0;
+    double mean_error_ = 0.0;
+    double m2_ = 0.0;
+    double min_ = 0.0;
+    double max_ = 0.0;
+
+    void mergeBlock(uint64_t count, double mean, double m2, double min, double max);
+};
+
+// Статистика базы: x[c] - все значения канала X[c], y[i] - целевая переменная Y(i+1)
+struct LearningBaseStats {
+    std::vector<RunningStats> x;
+    std::vector<RunningStats> y;
+
+    void reset(const LearningBaseConfig& config);
+    void addRecord(const float* const* x_values, const int* x_lengths, const float* y_values);
+    void merge(const LearningBaseStats& other);
+
+    // Заполняет x_mean/x_std/x_min/x_max/y_* конфига, которые сохраняются в Configs
+    void exportTo(LearningBaseConfig& config) const;
+};
+
+#endif // LEARNING_BASE_STATS_H
@@ -0,0 +1,293 @@
+#include "learning_base_stream.h"
+#include "learning_base_binary.h"
+#include "learning_base_parser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Меньше записей в куске не стоит запуска потоков
+const size_t kMinRecordsPerThread = 8;
+
+unsigned resolveThreads(unsigned requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+// Разобранные значения целых записей одного куска, в порядке колонок .rslb
+struct RecordBatch {
+    std::vector<std::vector<float>> x;
+    std::vector<float> y;
+    std::vector<uint64_t> offsets;
+
+    size_t bytes() const {
+        size_t total = y.capacity() * sizeof(float) + offsets.capacity() * sizeof(uint64_t);
+        for (const auto& channel : x) {
+            total += channel.capacity() * sizeof(float);
+        }
+        return total;
+    }
+};
+
+} // namespace
+
+LearningBaseStreamConverter::LearningBaseStreamConverter(size_t chunk_bytes, unsigned num_threads)
+    : chunk_bytes_(std::max<size_t>(chunk_bytes, 64 << 10)), num_threads_(resolveThreads(num_threads)) {}
+
+bool LearningBaseStreamConverter::countRecords(const std::string& path, uint64_t& count) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        last_error_ = "Cannot open file: " + path;
+        return false;
+    }
+
+    // Маркер может разрезаться границей куска: хвост короче маркера переносим в следующий
+    const size_t overlap = std::strlen(kLearningBaseRecordMarker) - 1;
+    std::vector<char> buffer(chunk_bytes_ + overlap);
+    size_t filled = 0;
+    count = 0;
+
+    while (in) {
+        in.read(buffer.data() + filled, static_cast<std::streamsize>(chunk_bytes_));
+        filled += static_cast<size_t>(in.gcount());
+        count += findRecordOffsets(buffer.data(), filled, num_threads_).size();
+
+        size_t keep = std::min(filled, overlap);
+        std::memmove(buffer.data(), buffer.data() + filled - keep, keep);
+        filled = keep;
+    }
+    if (in.bad()) {
+        last_error_ = "Read failed: " + path;
+        return false;
+    }
+    return true;
+}
+
+bool LearningBaseStreamConverter::convert(const std::string& text_path, const LearningBaseConfig& config,
+                                          const std::string& binary_path, LearningBaseStreamStats* stats) {
+    last_error_.clear();
+    auto start = std::chrono::steady_clock::now();
+
+    if (config.num_features_x != static_cast<int>(config.x_lengths.size())) {
+        last_error_ = "Features count mismatch: config has " + std::to_string(config.num_features_x) +
+                      ", x_lengths has " + std::to_string(config.x_lengths.size());
+        return false;
+    }
+    if (config.num_targets_y != static_cast<int>(config.y_precision.size())) {
+        last_error_ = "Target variables count mismatch: config has " + std::to_string(config.num_targets_y) +
+                      ", y_precision has " + std::to_string(config.y_precision.size());
+        return false;
+    }
+
+    // Смещения колонок зависят от числа записей, поэтому оно нужно до первой записи
+    uint64_t num_samples = 0;
+    if (config.num_samples > 0) {
+        num_samples = static_cast<uint64_t>(config.num_samples);
+    } else if (!countRecords(text_path, num_samples)) {
+        return false;
+    }
+    if (num_samples == 0) {
+        last_error_ = "No records found";
+        return false;
+    }
+
+    std::ifstream in(text_path, std::ios::binary);
+    if (!in.is_open()) {
+        last_error_ = "Cannot open file: " + text_path;
+        return false;
+    }
+
+    LearningBaseBinaryLayout layout = computeLearningBaseBinaryLayout(config, num_samples);
+
+    // Пишем во временный файл и переименовываем, чтобы не оставить битый .rslb
+    std::string tmp_path = binary_path + ".tmp";
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        last_error_ = "Cannot create file: " + tmp_path;
+        return false;
+    }
+    auto fail = [&](const std::string& error) {
+        last_error_ = error;
+        out.close();
+        std::error_code ec;
+        fs::remove(tmp_path, ec);
+        return false;
+    };
+
+    // Файл сразу получает итоговый размер: колонки дописываются кусками в свои места,
+    // промежутки выравнивания остаются нулевыми
+    std::string header = encodeLearningBaseBinaryHeader(config, num_samples, layout);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.seekp(static_cast<std::streamoff>(layout.file_size - 1));
+    out.put('\0');
+
+    const int nx = config.num_features_x;
+    const int ny = config.num_targets_y;
+    const size_t marker_size = std::strlen(kLearningBaseRecordMarker);
+
+    std::vector<char> buffer;
+    size_t filled = 0;
+    uint64_t buffer_offset = 0; // смещение buffer[0] в исходном файле
+    uint64_t next_record = 0;   // записи [0, next_record) уже в .rslb
+    uint64_t records_found = 0; // больше num_samples - только считаем, чтобы назвать точное число
+    RecordBatch batch;
+    batch.x.resize(nx);
+    LearningBaseStreamStats local_stats;
+    local_stats.values.reset(config);
+    std::vector<LearningBaseStats> thread_values;
+    bool eof = false;
+
+    while (!eof) {
+        if (buffer.size() < filled + chunk_bytes_) {
+            buffer.resize(filled + chunk_bytes_);
+        }
+        in.read(buffer.data() + filled, static_cast<std::streamsize>(chunk_bytes_));
+        size_t got = static_cast<size_t>(in.gcount());
+        if (in.bad()) {
+            return fail("Read failed: " + text_path);
+        }
+        filled += got;
+        local_stats.bytes_read += got;
+        eof = got < chunk_bytes_;
+
+        // Последняя запись куска может продолжаться в следующем - её разбираем только в конце файла
+        std::vector<uint64_t> markers = findRecordOffsets(buffer.data(), filled, num_threads_);
+        size_t complete = eof ? markers.size() : (markers.empty() ? 0 : markers.size() - 1);
+        records_found += complete;
+
+        if (complete > 0 && records_found <= num_samples) {
+            for (int c = 0; c < nx; ++c) {
+                batch.x[c].resize(complete * config.x_lengths[c]);
+            }
+            batch.y.resize(complete * ny);
+            batch.offsets.resize(complete);
+
+            const char* text = buffer.data();
+            size_t error_record = complete;
+            std::string record_error;
+            std::mutex error_mutex;
+
+            unsigned threads = static_cast<unsigned>(
+                std::min<size_t>(num_threads_, std::max<size_t>(1, complete / kMinRecordsPerThread)));
+            thread_values.resize(threads);
+            for (auto& values : thread_values) {
+                values.reset(config);
+            }
+
+            auto parseRange = [&](unsigned t, size_t first, size_t last) {
+                LearningBaseRecordParser record_parser(config);
+                std::vector<float*> x_out(nx);
+                for (size_t i = first; i < last; ++i) {
+                    const bool last_record = eof && i + 1 == markers.size();
+                    const char* stop = last_record ? text + filled : text + markers[i + 1];
+                    const char* begin;
+                    const char* end;
+                    learningBaseRecordBody(text + markers[i], stop, last_record, begin, end);
+
+                    for (int c = 0; c < nx; ++c) {
+                        x_out[c] = batch.x[c].data() + i * config.x_lengths[c];
+                    }
+                    batch.offsets[i] = buffer_offset + markers[i];
+
+                    if (!record_parser.parse(begin, end, x_out.data(), batch.y.data() + i * ny)) {
+                        std::lock_guard<std::mutex> lock(error_mutex);
+                        if (i < error_record) {
+                            error_record = i;
+                            record_error = record_parser.error();
+                        }
+                        return;
+                    }
+                    thread_values[t].addRecord(x_out.data(), config.x_lengths.data(), batch.y.data() + i * ny);
+                }
+            };
+
+            if (threads <= 1) {
+                parseRange(0, 0, complete);
+            } else {
+                std::vector<std::thread> workers;
+                for (unsigned t = 0; t < threads; ++t) {
+                    workers.emplace_back(parseRange, t, complete * t / threads, complete * (t + 1) / threads);
+                }
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+            }
+
+            if (error_record < complete) {
+                return fail("Record #" + std::to_string(next_record + error_record + 1) + ": " + record_error);
+            }
+            // Потоки брали записи подряд, поэтому слияние по порядку потоков воспроизводимо
+            for (const auto& values : thread_values) {
+                local_stats.values.merge(values);
+            }
+
+            for (int c = 0; c < nx; ++c) {
+                uint64_t row_bytes = static_cast<uint64_t>(config.x_lengths[c]) * sizeof(float);
+                out.seekp(static_cast<std::streamoff>(layout.x_offsets[c] + next_record * row_bytes));
+                out.write(reinterpret_cast<const char*>(batch.x[c].data()),
+                          static_cast<std::streamsize>(complete * row_bytes));
+            }
+            out.seekp(static_cast<std::streamoff>(layout.y_offset + next_record * ny * sizeof(float)));
+            out.write(reinterpret_cast<const char*>(batch.y.data()),
+                      static_cast<std::streamsize>(batch.y.size() * sizeof(float)));
+            out.seekp(static_cast<std::streamoff>(layout.offsets_offset + next_record * sizeof(uint64_t)));
+            out.write(reinterpret_cast<const char*>(batch.offsets.data()),
+                      static_cast<std::streamsize>(batch.offsets.size() * sizeof(uint64_t)));
+            if (!out) {
+                return fail("Write failed: " + tmp_path);
+            }
+            next_record += complete;
+        }
+
+        local_stats.peak_buffer_bytes = std::max(local_stats.peak_buffer_bytes, buffer.capacity() + batch.bytes());
+
+        // Переносим недочитанную запись в начало буфера; текст до первого маркера не нужен,
+        // кроме хвоста, в котором может начинаться разрезанный маркер
+        size_t keep_from;
+        if (!markers.empty()) {
+            keep_from = markers.back();
+        } else {
+            keep_from = filled > marker_size - 1 ? filled - (marker_size - 1) : 0;
+        }
+        std::memmove(buffer.data(), buffer.data() + keep_from, filled - keep_from);
+        buffer_offset += keep_from;
+        filled -= keep_from;
+    }
+
+    if (records_found == 0) {
+        return fail("No records found");
+    }
+    if (records_found != num_samples) {
+        return fail("Sample count mismatch: config has " + std::to_string(num_samples) + ", data has " +
+                    std::to_string(records_found));
+    }
+
+    out.close();
+    if (!out) {
+        return fail("Write failed: " + tmp_path);
+    }
+    std::error_code ec;
+    fs::rename(tmp_path, binary_path, ec);
+    if (ec) {
+        return fail("Cannot rename " + tmp_path + ": " + ec.message());
+    }
+
+    local_stats.num_samples = num_samples;
+    local_stats.elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    if (stats) {
+        *stats = local_stats;
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+#ifndef LEARNING_BASE_STREAM_H
+#define LEARNING_BASE_STREAM_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include "learning_base_config.h"
+#include "learning_base_stats.h"
+
+struct LearningBaseStreamStats {
+    uint64_t num_samples = 0;
+    uint64_t bytes_read = 0;
+    size_t peak_buffer_bytes = 0; // текст + разобранные значения одного куска
+    double elapsed_ms = 0.0;
+    LearningBaseStats values;     // статистика значений, собранная в том же проходе
+};
+
+// Потоковая конвертация текстовой базы в .rslb без загрузки её целиком:
+// файл читается кусками по chunk_bytes, целые записи куска разбираются
+// параллельно и сразу пишутся в свои места колонок .rslb, а недочитанная
+// запись в конце куска переносится в начало следующего. Память - порядка
+// двух кусков независимо от размера базы (больше - только если одна запись
+// длиннее куска). Правила разбора и проверки те же, что у LearningBaseParser.
+// Заодно по каждой записи, пока она в кэше, копится статистика каналов.
+class LearningBaseStreamConverter {
+public:
+    explicit LearningBaseStreamConverter(size_t chunk_bytes = 8 << 20, unsigned num_threads = 0);
+
+    // config.num_samples <= 0 - число записей считается отдельным проходом по файлу
+    bool convert(const std::string& text_path, const LearningBaseConfig& config, const std::string& binary_path,
+                 LearningBaseStreamStats* stats = nullptr);
+
+    const std::string& lastError() const { return last_error_; }
+    unsigned numThreads() const { return num_threads_; }
+
+private:
+    size_t chunk_bytes_;
+    unsigned num_threads_;
+    std::string last_error_;
+
+    bool countRecords(const std::string& path, uint64_t& count);
+};
+
+#endif // LEARNING_BASE_STREAM_H
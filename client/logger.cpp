@@ -24,6 +24,34 @@ Logger::Logger(bool enable_console) : console_output(enable_console) {
     std::filesystem::create_directories(log_dir);
     
     log_file_path = getSessionFilename();
+    open();
+    start();
+}
+
+Logger::Logger(const std::string& file_path, bool enable_console)
+    : log_file_path(file_path), console_output(enable_console) {
+    open();
+    start();
+}
+
+Logger::~Logger() {
+    stop_.store(true);
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+    }
+    wake_cv_.notify_one();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    
+    if (log_file.is_open()) {
+        std::string shutdown_msg = "=== Application Session Ended ===";
+        log_file << getCurrentTimestamp() << " " << shutdown_msg << "\n";
+        log_file.close();
+    }
+}
+
+void Logger::open() {
     log_file.open(log_file_path, std::ios::app);
     
     if (log_file.is_open()) {
@@ -35,12 +63,12 @@ Logger::Logger(bool enable_console) : console_output(enable_console) {
     }
 }
 
-Logger::~Logger() {
-    if (log_file.is_open()) {
-        std::string shutdown_msg = "=== Application Session Ended ===";
-        log_file << getCurrentTimestamp() << " " << shutdown_msg << "\n";
-        log_file.close();
+void Logger::start() {
+    ring_.reset(new Record[kCapacity]);
+    for (size_t i = 0; i < kCapacity; ++i) {
+        ring_[i].sequence.store(i, std::memory_order_relaxed);
     }
+    writer_ = std::thread(&Logger::writerLoop, this);
 }
 
 std::string Logger::getCurrentTimestamp() {
@@ -95,45 +123,205 @@ std::string Logger::getSessionFilename() {
     return filename;
 }
 
-void Logger::info(const std::string& message) {
-    std::string log_entry = "[INFO] " + message;
-    if (log_file.is_open()) {
-        log_file << getCurrentTimestamp() << " " << log_entry << "\n";
-        log_file.flush();
+size_t Logger::push(Level level, std::string&& message) {
+    const size_t mask = kCapacity - 1;
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Record* record;
+    
+    for (;;) {
+        record = &ring_[pos & mask];
+        size_t sequence = record->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Буфер заполнен: будим поток записи и ждём, пока он освободит эту ячейку; записи не теряем
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+            }
+            wake_cv_.notify_one();
+            producers_waiting_.fetch_add(1, std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(space_mutex_);
+                space_cv_.wait_for(lock, std::chrono::milliseconds(100), [record, pos]() {
+                    size_t current = record->sequence.load(std::memory_order_acquire);
+                    return static_cast<intptr_t>(current) - static_cast<intptr_t>(pos) >= 0;
+                });
+            }
+            producers_waiting_.fetch_sub(1, std::memory_order_relaxed);
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+    
+    record->level = level;
+    record->time = std::chrono::system_clock::now();
+    record->message = std::move(message);
+    record->sequence.store(pos + 1, std::memory_order_release);
+    
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writer_sleeping_.load(std::memory_order_relaxed) || level == Level::Error) {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_cv_.notify_one();
+    }
+    return pos;
+}
+
+void Logger::appendTimestamp(std::string& buffer, std::chrono::system_clock::time_point time) {
+    auto time_t = std::chrono::system_clock::to_time_t(time);
+    if (time_t != cached_second_) {
+        std::tm tm;
+        localtime_s(&tm, &time_t);
+        std::strftime(cached_timestamp_, sizeof(cached_timestamp_), "%Y-%m-%d %H:%M:%S", &tm);
+        cached_second_ = time_t;
+    }
+    
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+    char millis[5] = {'.', static_cast<char>('0' + ms / 100), static_cast<char>('0' + ms / 10 % 10),
+                      static_cast<char>('0' + ms % 10), ' '};
+    buffer += cached_timestamp_;
+    buffer.append(millis, sizeof(millis));
+}
+
+size_t Logger::drain(std::string& buffer, bool& has_error) {
+    static const char* const prefixes[] = {"[DEBUG] ", "[INFO] ", "[WARNING] ", "[ERROR] "};
+    const size_t mask = kCapacity - 1;
+    const size_t max_batch = 4096;
+    size_t count = 0;
+    
+    while (count < max_batch) {
+        Record& record = ring_[dequeue_pos_ & mask];
+        if (record.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+            break;
+        }
+        
+        appendTimestamp(buffer, record.time);
+        buffer += prefixes[static_cast<int>(record.level)];
+        buffer += record.message;
+        buffer += '\n';
+        has_error = has_error || record.level == Level::Error;
+        
+        record.message.clear();
+        record.sequence.store(dequeue_pos_ + kCapacity, std::memory_order_release);
+        ++dequeue_pos_;
+        ++count;
     }
+    return count;
+}
+
+void Logger::writerLoop() {
+    std::string buffer;
+    buffer.reserve(1 << 16);
+    const size_t mask = kCapacity - 1;
+    
+    for (;;) {
+        bool has_error = false;
+        if (drain(buffer, has_error) > 0) {
+            // Место освободилось ещё до записи на диск - отпускаем ждущих производителей
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (producers_waiting_.load(std::memory_order_relaxed) > 0) {
+                std::lock_guard<std::mutex> lock(space_mutex_);
+                space_cv_.notify_all();
+            }
+
+            // Одна запись и один flush на пачку вместо flush на каждую строку
+            if (log_file.is_open()) {
+                log_file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                log_file.flush();
+            }
+            buffer.clear();
+            
+            {
+                std::lock_guard<std::mutex> lock(flush_mutex_);
+                flushed_pos_.store(dequeue_pos_, std::memory_order_release);
+            }
+            flush_cv_.notify_all();
+            continue;
+        }
+        
+        if (stop_.load()) {
+            break;
+        }
+        
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        writer_sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wake_cv_.wait_for(lock, std::chrono::milliseconds(100), [this, mask]() {
+            return stop_.load() ||
+                   ring_[dequeue_pos_ & mask].sequence.load(std::memory_order_acquire) == dequeue_pos_ + 1;
+        });
+        writer_sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+void Logger::waitFlushed(size_t position, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(flush_mutex_);
+    flush_cv_.wait_for(lock, timeout, [this, position]() {
+        return flushed_pos_.load(std::memory_order_acquire) > position;
+    });
+}
+
+void Logger::flush() {
+    size_t end = enqueue_pos_.load();
+    if (end == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+    }
+    wake_cv_.notify_one();
+    waitFlushed(end - 1, std::chrono::seconds(5));
+}
+
+Logger::Level Logger::parseLevel(const std::string& name, Level fallback) {
+    if (name == "debug") return Level::Debug;
+    if (name == "info") return Level::Info;
+    if (name == "warning") return Level::Warning;
+    if (name == "error") return Level::Error;
+    return fallback;
+}
+
+void Logger::info(std::string message) {
+    if (!isEnabled(Level::Info)) {
+        return;
+    }
+    push(Level::Info, std::move(message));
     // if (console_output) {
     //     std::cout << log_entry << std::endl;
     // }
 }
 
-void Logger::error(const std::string& message) {
-    std::string log_entry = "[ERROR] " + message;
-    if (log_file.is_open()) {
-        log_file << getCurrentTimestamp() << " " << log_entry << "\n";
-        log_file.flush();
+void Logger::error(std::string message) {
+    if (!isEnabled(Level::Error)) {
+        return;
     }
     if (console_output) {
-        std::cerr << log_entry << std::endl;
+        std::cerr << "[ERROR] " << message << std::endl;
     }
+    size_t position = push(Level::Error, std::move(message));
+    // Ошибку стараемся увидеть на диске сразу, но ждём не дольше 200 мс
+    waitFlushed(position, std::chrono::milliseconds(200));
 }
 
-void Logger::warning(const std::string& message) {
-    std::string log_entry = "[WARNING] " + message;
-    if (log_file.is_open()) {
-        log_file << getCurrentTimestamp() << " " << log_entry << "\n";
-        log_file.flush();
+void Logger::warning(std::string message) {
+    if (!isEnabled(Level::Warning)) {
+        return;
     }
+    push(Level::Warning, std::move(message));
     // if (console_output) {
     //     std::cout << log_entry << std::endl;
     // }
 }
 
-void Logger::debug(const std::string& message) {
-    std::string log_entry = "[DEBUG] " + message;
-    if (log_file.is_open()) {
-        log_file << getCurrentTimestamp() << " " << log_entry << "\n";
-        log_file.flush();
+void Logger::debug(std::string message) {
+    if (!isEnabled(Level::Debug)) {
+        return;
     }
+    push(Level::Debug, std::move(message));
     // Debug сообщения не выводятся в консоль по умолчанию
 }
 
@@ -7,26 +7,95 @@
 #include <filesystem>
 #include <chrono>
 #include <iomanip>
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
 
+// Асинхронный логгер: потоки кладут записи в lock-free кольцевой буфер
+// (много писателей, один читатель), фоновый поток пишет их в файл пачками.
+// Методы можно вызывать из любых потоков.
 class Logger {
+public:
+    enum class Level { Debug = 0, Info, Warning, Error };
+
 private:
+    struct Record {
+        std::atomic<size_t> sequence{0};
+        Level level = Level::Info;
+        std::chrono::system_clock::time_point time;
+        std::string message;
+    };
+
     std::ofstream log_file;
     std::string log_file_path;
     bool console_output;
-    
+
+    std::atomic<int> min_level_{static_cast<int>(Level::Debug)};
+
+    // Кольцевой буфер (схема Вьюкова): размер - степень двойки
+    static const size_t kCapacity = 8192;
+    std::unique_ptr<Record[]> ring_;
+    std::atomic<size_t> enqueue_pos_{0};
+    size_t dequeue_pos_ = 0;              // только поток записи
+
+    std::thread writer_;
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> writer_sleeping_{false};
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+
+    // Буфер заполнен: производители ждут, пока поток записи освободит место
+    std::atomic<size_t> producers_waiting_{0};
+    std::mutex space_mutex_;
+    std::condition_variable space_cv_;
+
+    // Сколько записей уже сброшено на диск - по нему error() ждёт flush
+    std::atomic<size_t> flushed_pos_{0};
+    std::mutex flush_mutex_;
+    std::condition_variable flush_cv_;
+
+    // Кэш форматирования времени: "YYYY-mm-dd HH:MM:SS" меняется раз в секунду
+    std::time_t cached_second_ = -1;
+    char cached_timestamp_[32] = {};
+
     std::string getCurrentTimestamp();
     std::string getSessionFilename();
 
+    void open();
+    void start();
+    size_t push(Level level, std::string&& message);
+    void writerLoop();
+    size_t drain(std::string& buffer, bool& has_error);
+    void appendTimestamp(std::string& buffer, std::chrono::system_clock::time_point time);
+    void waitFlushed(size_t position, std::chrono::milliseconds timeout);
+
 public:
     Logger(bool enable_console = false);
+    Logger(const std::string& file_path, bool enable_console); // явный путь к файлу лога
     ~Logger();
-    
-    void info(const std::string& message);
-    void error(const std::string& message);
-    void warning(const std::string& message);
-    void debug(const std::string& message);
-    
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void info(std::string message);
+    void error(std::string message);
+    void warning(std::string message);
+    void debug(std::string message);
+
+    // Записи ниже уровня отбрасываются до любого форматирования
+    void setLevel(Level level) { min_level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+    bool isEnabled(Level level) const {
+        return static_cast<int>(level) >= min_level_.load(std::memory_order_relaxed);
+    }
+    static Level parseLevel(const std::string& name, Level fallback = Level::Debug);
+
+    // Дождаться записи всего, что уже поставлено в очередь
+    void flush();
+
     std::string getLogFilePath() const;
 };
 
-#endif // LOGGER_H
\ No newline at end of file
+#endif // LOGGER_H
@@ -0,0 +1,145 @@
+#include "mapped_file.h"
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        swap(other);
+    }
+    return *this;
+}
+
+void MappedFile::swap(MappedFile& other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(opened_empty_, other.opened_empty_);
+#ifdef _WIN32
+    std::swap(file_handle_, other.file_handle_);
+    std::swap(mapping_handle_, other.mapping_handle_);
+#else
+    std::swap(fd_, other.fd_);
+#endif
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    file_handle_ = file;
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    if (size_ == 0) {
+        // Пустой файл отобразить нельзя, но это не ошибка
+        opened_empty_ = true;
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        close();
+        return false;
+    }
+    mapping_handle_ = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL) {
+        close();
+        return false;
+    }
+    data_ = static_cast<const char*>(view);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_) {
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+    }
+    if (file_handle_) {
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+    }
+    data_ = nullptr;
+    size_ = 0;
+    opened_empty_ = false;
+    file_handle_ = nullptr;
+    mapping_handle_ = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0) {
+        opened_empty_ = true;
+        return true;
+    }
+
+    void* view = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        close();
+        return false;
+    }
+    madvise(view, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(view);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    opened_empty_ = false;
+    fd_ = -1;
+}
+
+#endif
@@ -0,0 +1,968 @@
+#include "native_regression.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <list>
+#include <random>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+const char kNativeModelMagic[8] = {'R', 'S', 'M', 'O', 'D', 'E', 'L', '\0'};
+
+namespace {
+
+const int kLanes = 8;
+const size_t kRowBlock = 256;       // записей в блоке Грама: транспонированный блок помещается в L2
+const size_t kCholeskyBlock = 64;   // строк в панели Холецкого
+const size_t kParallelRowWork = 1 << 18; // меньше - строку ядра считает один поток
+const double kTau = 1e-12;          // как TAU в LIBSVM
+const size_t kMaxLinearPasses = 200;       // дальше обычно мешает не точность, а плохо заданные C/epsilon
+const double kLinearTolerance = 0.1;       // как eps в LIBLINEAR: доля начальной суммы нарушений KKT
+
+template <typename T>
+bool readPod(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template <typename T>
+bool readArray(std::ifstream& file, std::vector<T>& data, size_t count) {
+    data.resize(count);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()),
+                                       static_cast<std::streamsize>(count * sizeof(T))));
+}
+
+template <typename T>
+void writePod(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void writeArray(std::ofstream& file, const std::vector<T>& data) {
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(T)));
+}
+
+// Скалярное произведение на kLanes независимых аккумуляторах (векторизуется без -ffast-math).
+// Acc - тип накопления: double для длинных сумм по float, где важна точность
+template <typename T, typename U = T, typename Acc = T>
+inline Acc dot(const T* a, const U* b, size_t n) {
+    Acc acc[kLanes] = {};
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (int l = 0; l < kLanes; ++l) {
+            acc[l] += static_cast<Acc>(a[i + l]) * static_cast<Acc>(b[i + l]);
+        }
+    }
+    Acc sum = 0;
+    for (int l = 0; l < kLanes; ++l) {
+        sum += acc[l];
+    }
+    for (; i < n; ++i) {
+        sum += static_cast<Acc>(a[i]) * static_cast<Acc>(b[i]);
+    }
+    return sum;
+}
+
+unsigned resolveThreads(unsigned requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+// fn(begin, end) на равных непрерывных кусках [0, count)
+template <typename Fn>
+void parallelRanges(unsigned num_threads, size_t count, Fn&& fn) {
+    unsigned threads = static_cast<unsigned>(std::min<size_t>(num_threads, count));
+    if (threads <= 1) {
+        if (count > 0) {
+            fn(size_t{0}, count);
+        }
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() { fn(count * t / threads, count * (t + 1) / threads); });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+// fn(i) для i из [0, count), потоки разбирают номера по одному - для строк разной длины
+template <typename Fn>
+void parallelItems(unsigned num_threads, size_t count, Fn&& fn) {
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            fn(i);
+        }
+    };
+    unsigned threads = static_cast<unsigned>(std::min<size_t>(num_threads, count));
+    if (threads <= 1) {
+        worker();
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back(worker);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
+// Холецкий A = L L^T на месте (нижний треугольник, построчно). Панелями по
+// kCholeskyBlock строк: сначала сама панель, затем все строки ниже неё
+// параллельно - каждый элемент L[i][j] - скалярное произведение непрерывных
+// кусков строк i и j, уже посчитанных к этому моменту.
+bool choleskyInPlace(std::vector<double>& a, size_t n, unsigned num_threads) {
+    auto solveRow = [&](size_t i, size_t from, size_t to) -> bool {
+        double* row_i = &a[i * n];
+        for (size_t j = from; j < to && j <= i; ++j) {
+            const double* row_j = &a[j * n];
+            double value = row_i[j] - dot(row_i, row_j, j);
+            if (j == i) {
+                if (!(value > 0.0)) {
+                    return false;
+                }
+                row_i[i] = std::sqrt(value);
+            } else {
+                row_i[j] = value / row_j[j];
+            }
+        }
+        return true;
+    };
+
+    for (size_t begin = 0; begin < n; begin += kCholeskyBlock) {
+        const size_t end = std::min(n, begin + kCholeskyBlock);
+        for (size_t i = begin; i < end; ++i) {
+            if (!solveRow(i, begin, end)) {
+                return false;
+            }
+        }
+        parallelRanges(num_threads, n - end, [&](size_t first, size_t last) {
+            for (size_t i = end + first; i < end + last; ++i) {
+                solveRow(i, begin, end);
+            }
+        });
+    }
+    return true;
+}
+
+// L L^T x = b, b[] заменяется решением
+void choleskySolve(const std::vector<double>& l, size_t n, double* b) {
+    for (size_t i = 0; i < n; ++i) {
+        b[i] = (b[i] - dot(&l[i * n], b, i)) / l[i * n + i];
+    }
+    for (size_t i = n; i-- > 0;) {
+        double value = b[i];
+        for (size_t k = i + 1; k < n; ++k) {
+            value -= l[k * n + i] * b[k];
+        }
+        b[i] = value / l[i * n + i];
+    }
+}
+
+// LRU-кэш строк ядра K[i][0..m) с ограничением по памяти (как Cache в LIBSVM).
+// Держит не меньше двух строк: шаг SMO читает строки i и j одновременно.
+class KernelRowCache {
+public:
+    template <typename ComputeRow>
+    KernelRowCache(size_t m, size_t budget_bytes, ComputeRow compute)
+        : m_(m), rows_(m), position_(m), compute_(compute) {
+        max_rows_ = std::max<size_t>(2, budget_bytes / std::max<size_t>(1, m * sizeof(float)));
+    }
+
+    const float* row(size_t i) {
+        if (!rows_[i].empty()) {
+            lru_.splice(lru_.begin(), lru_, position_[i]);
+            return rows_[i].data();
+        }
+        if (lru_.size() >= max_rows_) {
+            size_t victim = lru_.back();
+            lru_.pop_back();
+            std::vector<float>().swap(rows_[victim]);
+        }
+        rows_[i].resize(m_);
+        compute_(i, rows_[i].data());
+        lru_.push_front(i);
+        position_[i] = lru_.begin();
+        return rows_[i].data();
+    }
+
+private:
+    size_t m_;
+    size_t max_rows_ = 2;
+    std::vector<std::vector<float>> rows_;
+    std::vector<std::list<size_t>::iterator> position_;
+    std::list<size_t> lru_;
+    std::function<void(size_t, float*)> compute_;
+};
+
+// epsilon-SVR через SMO с выбором пары по второму порядку (Fan, Chen, Lin 2005;
+// solver из LIBSVM без shrinking). Переменные 2m: alpha+ (sign = +1) и alpha- (-1),
+// Q[s][t] = sign_s sign_t K[s mod m][t mod m]. coef[s] = alpha+[s] - alpha-[s].
+size_t solveSvr(KernelRowCache& cache, const std::vector<float>& qd, const double* y, size_t m,
+                double c, double epsilon, double tolerance, double* coef, double& bias, bool& converged) {
+    const size_t l = 2 * m;
+    std::vector<double> alpha(l, 0.0), grad(l);
+    std::vector<signed char> sign(l);
+    for (size_t s = 0; s < m; ++s) {
+        sign[s] = 1;
+        sign[s + m] = -1;
+        grad[s] = epsilon - y[s];     // при alpha = 0 градиент равен линейному члену
+        grad[s + m] = epsilon + y[s];
+    }
+    auto isUpper = [&](size_t t) { return alpha[t] >= c; };
+    auto isLower = [&](size_t t) { return alpha[t] <= 0.0; };
+    auto diag = [&](size_t t) { return static_cast<double>(qd[t % m]); };
+
+    const size_t max_iterations = std::max<size_t>(100000, 100 * l);
+    size_t iteration = 0;
+    for (; iteration < max_iterations; ++iteration) {
+        // i: максимальное нарушение условий KKT
+        double g_max = -std::numeric_limits<double>::infinity();
+        size_t i = l;
+        for (size_t t = 0; t < l; ++t) {
+            if (sign[t] > 0 ? !isUpper(t) : !isLower(t)) {
+                double value = -sign[t] * grad[t];
+                if (value >= g_max) {
+                    g_max = value;
+                    i = t;
+                }
+            }
+        }
+        if (i == l) {
+            break;
+        }
+
+        // j: наибольшее убывание целевой функции при шаге по паре (i, j)
+        const float* k_i = cache.row(i % m);
+        double g_max2 = -std::numeric_limits<double>::infinity();
+        double best = std::numeric_limits<double>::infinity();
+        size_t j = l;
+        for (size_t t = 0; t < l; ++t) {
+            if (sign[t] > 0 ? isLower(t) : isUpper(t)) {
+                continue;
+            }
+            double value = sign[t] * grad[t];
+            g_max2 = std::max(g_max2, value);
+            double grad_diff = g_max + value;
+            if (grad_diff > 0.0) {
+                double quad = diag(i) + diag(t) - 2.0 * k_i[t % m];
+                double obj = -(grad_diff * grad_diff) / (quad > 0.0 ? quad : kTau);
+                if (obj <= best) {
+                    best = obj;
+                    j = t;
+                }
+            }
+        }
+        if (g_max + g_max2 < tolerance || j == l) {
+            break;
+        }
+
+        const float* k_j = cache.row(j % m);
+        const double k_ij = k_i[j % m];
+        const double old_ai = alpha[i], old_aj = alpha[j];
+        double ai = old_ai, aj = old_aj;
+        if (sign[i] != sign[j]) {
+            double quad = diag(i) + diag(j) + 2.0 * sign[i] * sign[j] * k_ij;
+            double delta = (-grad[i] - grad[j]) / (quad > 0.0 ? quad : kTau);
+            double diff = ai - aj;
+            ai += delta;
+            aj += delta;
+            if (diff > 0.0) {
+                if (aj < 0.0) { aj = 0.0; ai = diff; }
+            } else {
+                if (ai < 0.0) { ai = 0.0; aj = -diff; }
+            }
+            if (diff > 0.0) {
+                if (ai > c) { ai = c; aj = c - diff; }
+            } else {
+                if (aj > c) { aj = c; ai = c + diff; }
+            }
+        } else {
+            double quad = diag(i) + diag(j) - 2.0 * k_ij;
+            double delta = (grad[i] - grad[j]) / (quad > 0.0 ? quad : kTau);
+            double sum = ai + aj;
+            ai -= delta;
+            aj += delta;
+            if (sum > c) {
+                if (ai > c) { ai = c; aj = sum - c; }
+            } else {
+                if (aj < 0.0) { aj = 0.0; ai = sum; }
+            }
+            if (sum > c) {
+                if (aj > c) { aj = c; ai = sum - c; }
+            } else {
+                if (ai < 0.0) { ai = 0.0; aj = sum; }
+            }
+        }
+        alpha[i] = ai;
+        alpha[j] = aj;
+
+        // grad[t] += Q[t][i] dai + Q[t][j] daj; у alpha+ и alpha- одной записи поправки противоположны
+        const double wi = sign[i] * (ai - old_ai);
+        const double wj = sign[j] * (aj - old_aj);
+        for (size_t s = 0; s < m; ++s) {
+            double v = wi * k_i[s] + wj * k_j[s];
+            grad[s] += v;
+            grad[s + m] -= v;
+        }
+    }
+
+    converged = iteration < max_iterations;
+
+    // Свободный член как calculate_rho в LIBSVM: среднее по свободным переменным
+    double upper = std::numeric_limits<double>::infinity();
+    double lower = -std::numeric_limits<double>::infinity();
+    double sum_free = 0.0;
+    size_t num_free = 0;
+    for (size_t t = 0; t < l; ++t) {
+        double yg = sign[t] * grad[t];
+        if (isUpper(t)) {
+            if (sign[t] < 0) upper = std::min(upper, yg); else lower = std::max(lower, yg);
+        } else if (isLower(t)) {
+            if (sign[t] > 0) upper = std::min(upper, yg); else lower = std::max(lower, yg);
+        } else {
+            ++num_free;
+            sum_free += yg;
+        }
+    }
+    const double rho = num_free > 0 ? sum_free / static_cast<double>(num_free) : (upper + lower) / 2.0;
+    bias = -rho;
+    for (size_t s = 0; s < m; ++s) {
+        coef[s] = alpha[s] - alpha[s + m];
+    }
+    return iteration;
+}
+
+// epsilon-SVR с линейным ядром: двойственный покоординатный спуск (Ho, Lin 2012;
+// solve_l2r_l1l2_svr из LIBLINEAR). Веса w = sum beta_s x_s хранятся явно, шаг по
+// записи стоит O(F), поэтому учимся на всём train. Записи, застрявшие на границе,
+// временно выбрасываются из проходов (shrinking) и возвращаются для финальной проверки.
+// Свободный член - вес постоянного признака 1, как bias в LIBLINEAR.
+// rowAt(s, buffer) - признаки записи s. Возвращает число обновлённых координат.
+template <typename RowAt>
+size_t solveLinearSvr(RowAt&& rowAt, const std::vector<float>& norms, const double* y, size_t n, size_t f,
+                      double c, double epsilon, double* w, double& bias, bool& converged) {
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> beta(n, 0.0);
+    std::vector<float> buffer(f);
+    std::vector<size_t> index(n);
+    for (size_t s = 0; s < n; ++s) {
+        index[s] = s;
+    }
+    std::fill(w, w + f, 0.0);
+    bias = 0.0;
+
+    std::mt19937_64 rng(n);
+    converged = false;
+    size_t active = n;
+    size_t steps = 0;
+    double max_violation_old = inf;
+    double first_violation = 0.0;
+    for (size_t pass = 0; pass < kMaxLinearPasses; ++pass) {
+        std::shuffle(index.begin(), index.begin() + active, rng);
+        double max_violation = 0.0;
+        double violation_sum = 0.0;
+        for (size_t k = 0; k < active; ++k) {
+            const size_t s = index[k];
+            const float* row = rowAt(s, buffer.data());
+            const double h = static_cast<double>(norms[s]) + 1.0;
+            const double g = dot(w, row, f) + bias - y[s];
+            const double gp = g + epsilon;
+            const double gn = g - epsilon;
+            const double b = beta[s];
+
+            // Нарушение условий оптимальности по координате s; запись на границе,
+            // которая с запасом там и останется, уходит из активных
+            double violation = 0.0;
+            bool shrink = false;
+            if (b == 0.0) {
+                if (gp < 0.0) {
+                    violation = -gp;
+                } else if (gn > 0.0) {
+                    violation = gn;
+                } else {
+                    shrink = gp > max_violation_old && gn < -max_violation_old;
+                }
+            } else if (b >= c) {
+                if (gp > 0.0) {
+                    violation = gp;
+                } else {
+                    shrink = gp < -max_violation_old;
+                }
+            } else if (b <= -c) {
+                if (gn < 0.0) {
+                    violation = -gn;
+                } else {
+                    shrink = gn > max_violation_old;
+                }
+            } else {
+                violation = std::fabs(b > 0.0 ? gp : gn);
+            }
+            if (shrink) {
+                std::swap(index[k], index[--active]);
+                --k;
+                continue;
+            }
+            max_violation = std::max(max_violation, violation);
+            violation_sum += violation;
+
+            // Минимум кусочно-квадратичной функции по beta_s, обрезанный до [-C, C]
+            double d = gp < h * b ? -gp / h : (gn > h * b ? -gn / h : -b);
+            d = std::min(std::max(b + d, -c), c) - b;
+            if (std::fabs(d) < 1e-12) {
+                continue;
+            }
+            beta[s] = b + d;
+            for (size_t i = 0; i < f; ++i) {
+                w[i] += d * row[i];
+            }
+            bias += d;
+            ++steps;
+        }
+
+        if (pass == 0) {
+            first_violation = violation_sum;
+        }
+        if (violation_sum <= kLinearTolerance * first_violation) {
+            if (active == n) {
+                converged = true;
+                break;
+            }
+            // Сошлись на активных - ещё один проход по всем записям
+            active = n;
+            max_violation_old = inf;
+            continue;
+        }
+        max_violation_old = max_violation;
+    }
+    return steps;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+NativeRegressor::NativeRegressor(unsigned num_threads)
+    : num_threads_(resolveThreads(num_threads)) {}
+
+bool NativeRegressor::initModel(const LearningBaseBinary& base, const LearningBaseConfig& config, size_t num_samples) {
+    const LearningBaseConfig& stored = base.config();
+    if (config.x_lengths != stored.x_lengths || config.num_targets_y != stored.num_targets_y) {
+        last_error_ = "Learning base config does not match " + config.name + ".rslb";
+        return false;
+    }
+    if (num_samples == 0) {
+        last_error_ = "No training samples";
+        return false;
+    }
+
+    x_lengths_ = stored.x_lengths;
+    num_targets_ = stored.num_targets_y;
+    num_features_ = 0;
+    for (int len : x_lengths_) {
+        num_features_ += len;
+    }
+
+    // Без статистики (база загружена до её появления) признаки идут как есть
+    const bool has_stats = config.hasStats();
+    x_mean_.assign(x_lengths_.size(), 0.0f);
+    x_scale_.assign(x_lengths_.size(), 1.0f);
+    y_mean_.assign(num_targets_, 0.0);
+    y_std_.assign(num_targets_, 1.0);
+    if (has_stats) {
+        for (size_t c = 0; c < x_lengths_.size(); ++c) {
+            x_mean_[c] = static_cast<float>(config.x_mean[c]);
+            x_scale_[c] = config.x_std[c] > 0.0 ? static_cast<float>(1.0 / config.x_std[c]) : 1.0f;
+        }
+        for (int k = 0; k < num_targets_; ++k) {
+            y_mean_[k] = config.y_mean[k];
+            y_std_[k] = config.y_std[k] > 0.0 ? config.y_std[k] : 1.0;
+        }
+    }
+
+    bias_.assign(num_targets_, 0.0);
+    weights_.clear();
+    gamma_ = 0.0;
+    num_support_ = 0;
+    support_.clear();
+    support_norms_.clear();
+    coef_.clear();
+    return true;
+}
+
+template <typename Source>
+void NativeRegressor::gatherFeatures(const Source& source, int sample, float* out) const {
+    for (size_t c = 0; c < x_lengths_.size(); ++c) {
+        const float* x = source.sampleX(static_cast<int>(c), sample);
+        const float mean = x_mean_[c];
+        const float scale = x_scale_[c];
+        for (int t = 0; t < x_lengths_[c]; ++t) {
+            out[t] = (x[t] - mean) * scale;
+        }
+        out += x_lengths_[c];
+    }
+}
+
+template <typename Source>
+void NativeRegressor::gatherTargets(const Source& source, int sample, double* out) const {
+    const float* y = source.sampleY(sample);
+    for (int k = 0; k < num_targets_; ++k) {
+        out[k] = (y[k] - y_mean_[k]) / y_std_[k];
+    }
+}
+
+bool NativeRegressor::trainRidge(const LearningBaseBinary& base, const LearningBaseConfig& config,
+                                 const std::vector<uint64_t>& samples, const RidgeOptions& options,
+                                 NativeTrainingReport* report) {
+    auto start = std::chrono::steady_clock::now();
+    if (!initModel(base, config, samples.size())) {
+        return false;
+    }
+    kind_ = Kind::Linear;
+
+    const size_t f = static_cast<size_t>(num_features_);
+    const size_t d = f + 1;                 // последний столбец - единицы под свободный член
+    const size_t n = samples.size();
+    const size_t ny = static_cast<size_t>(num_targets_);
+    std::vector<double> solution(d * ny);   // [ny][d]
+
+    if (n >= d) {
+        // Нормальные уравнения (X^T X + lambda I) w = X^T y. Грам копится блоками
+        // записей; блок транспонирован, чтобы каждый элемент G[i][j] был скалярным
+        // произведением двух непрерывных строк длины блока. Потоки берут строки G.
+        // Блоки float, но суммы внутри блока - в double: нормальные уравнения
+        // обусловлены квадратом X, и ошибка float-накопления уходит в веса.
+        std::vector<double> gram(d * d, 0.0), rhs(d * ny, 0.0);
+        std::vector<float> xt(d * kRowBlock), yt(ny * kRowBlock);
+        for (size_t first = 0; first < n; first += kRowBlock) {
+            const size_t bs = std::min(kRowBlock, n - first);
+            parallelRanges(num_threads_, bs, [&](size_t begin, size_t end) {
+                std::vector<float> row(f);
+                std::vector<double> targets(ny);
+                for (size_t s = begin; s < end; ++s) {
+                    const int sample = static_cast<int>(samples[first + s]);
+                    gatherFeatures(base, sample, row.data());
+                    gatherTargets(base, sample, targets.data());
+                    for (size_t i = 0; i < f; ++i) {
+                        xt[i * bs + s] = row[i];
+                    }
+                    xt[f * bs + s] = 1.0f;
+                    for (size_t k = 0; k < ny; ++k) {
+                        yt[k * bs + s] = static_cast<float>(targets[k]);
+                    }
+                }
+            });
+            parallelItems(num_threads_, d, [&](size_t i) {
+                const float* xi = &xt[i * bs];
+                double* g = &gram[i * d];
+                for (size_t j = i; j < d; ++j) {
+                    g[j] += dot<float, float, double>(xi, &xt[j * bs], bs);
+                }
+                for (size_t k = 0; k < ny; ++k) {
+                    rhs[i * ny + k] += dot<float, float, double>(xi, &yt[k * bs], bs);
+                }
+            });
+        }
+
+        // Холецкому нужен нижний треугольник: зеркалим верхний
+        for (size_t i = 0; i < d; ++i) {
+            for (size_t j = 0; j < i; ++j) {
+                gram[i * d + j] = gram[j * d + i];
+            }
+            if (i < f) {
+                gram[i * d + i] += options.lambda;
+            }
+        }
+        if (!choleskyInPlace(gram, d, num_threads_)) {
+            last_error_ = "Normal equations are singular, increase ridge_lambda";
+            return false;
+        }
+        for (size_t k = 0; k < ny; ++k) {
+            double* w = &solution[k * d];
+            for (size_t i = 0; i < d; ++i) {
+                w[i] = rhs[i * ny + k];
+            }
+            choleskySolve(gram, d, w);
+        }
+    } else {
+        // Записей меньше, чем признаков: w = X^T (X X^T + lambda I)^-1 y, матрица n x n.
+        // Здесь свободный член штрафуется наравне с весами - на нормированных Y он близок к нулю.
+        if (!(options.lambda > 0.0)) {
+            last_error_ = "ridge_lambda must be positive when there are fewer samples than features";
+            return false;
+        }
+        std::vector<float> x(n * d);
+        std::vector<double> y(n * ny);
+        parallelRanges(num_threads_, n, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                const int sample = static_cast<int>(samples[s]);
+                gatherFeatures(base, sample, &x[s * d]);
+                x[s * d + f] = 1.0f;
+                gatherTargets(base, sample, &y[s * ny]);
+            }
+        });
+        std::vector<double> kernel(n * n, 0.0);
+        parallelItems(num_threads_, n, [&](size_t i) {
+            for (size_t j = 0; j <= i; ++j) {
+                kernel[i * n + j] = dot(&x[i * d], &x[j * d], d);
+            }
+            kernel[i * n + i] += options.lambda;
+        });
+        if (!choleskyInPlace(kernel, n, num_threads_)) {
+            last_error_ = "Kernel matrix is singular, increase ridge_lambda";
+            return false;
+        }
+        std::vector<double> dual(n);
+        for (size_t k = 0; k < ny; ++k) {
+            for (size_t s = 0; s < n; ++s) {
+                dual[s] = y[s * ny + k];
+            }
+            choleskySolve(kernel, n, dual.data());
+            double* w = &solution[k * d];
+            std::fill(w, w + d, 0.0);
+            for (size_t s = 0; s < n; ++s) {
+                const float* row = &x[s * d];
+                for (size_t i = 0; i < d; ++i) {
+                    w[i] += dual[s] * row[i];
+                }
+            }
+        }
+    }
+
+    weights_.resize(ny * f);
+    for (size_t k = 0; k < ny; ++k) {
+        for (size_t i = 0; i < f; ++i) {
+            weights_[k * f + i] = static_cast<float>(solution[k * d + i]);
+        }
+        bias_[k] = solution[k * d + f];
+    }
+
+    if (report) {
+        *report = NativeTrainingReport();
+        report->train_samples = n;
+        report->elapsed_ms = elapsedMs(start);
+    }
+    return true;
+}
+
+bool NativeRegressor::trainSvr(const LearningBaseBinary& base, const LearningBaseConfig& config,
+                               const std::vector<uint64_t>& samples, const SvrOptions& options,
+                               NativeTrainingReport* report) {
+    auto start = std::chrono::steady_clock::now();
+    if (!initModel(base, config, samples.size())) {
+        return false;
+    }
+    if (!(options.c > 0.0) || options.epsilon < 0.0) {
+        last_error_ = "svr_c must be positive and svr_epsilon non-negative";
+        return false;
+    }
+
+    const size_t f = static_cast<size_t>(num_features_);
+    const size_t ny = static_cast<size_t>(num_targets_);
+    size_t iterations = 0;
+    size_t train_samples = 0;
+    bool converged = true;
+
+    if (options.kernel == SvrKernel::Linear) {
+        // Признаки всего train держим в памяти, если помещаются в cache_mb,
+        // иначе покоординатный спуск собирает запись из .rslb заново на каждом проходе
+        const size_t n = samples.size();
+        const bool cached = n * f * sizeof(float) <= (options.cache_mb << 20);
+        std::vector<float> x(cached ? n * f : 0), norms(n);
+        std::vector<double> targets(n * ny);
+        parallelRanges(num_threads_, n, [&](size_t begin, size_t end) {
+            std::vector<float> row(f);
+            for (size_t s = begin; s < end; ++s) {
+                const int sample = static_cast<int>(samples[s]);
+                float* features = cached ? &x[s * f] : row.data();
+                gatherFeatures(base, sample, features);
+                gatherTargets(base, sample, &targets[s * ny]);
+                norms[s] = dot(features, features, f);
+            }
+        });
+        auto rowAt = [&](size_t s, float* buffer) -> const float* {
+            if (cached) {
+                return &x[s * f];
+            }
+            gatherFeatures(base, static_cast<int>(samples[s]), buffer);
+            return buffer;
+        };
+
+        // Цели независимы: каждая решается в своём потоке
+        std::vector<double> w(ny * f), column(n * ny);
+        std::vector<size_t> steps(ny);
+        std::vector<char> target_converged(ny);
+        for (size_t s = 0; s < n; ++s) {
+            for (size_t k = 0; k < ny; ++k) {
+                column[k * n + s] = targets[s * ny + k];
+            }
+        }
+        parallelItems(num_threads_, ny, [&](size_t k) {
+            bool done = false;
+            steps[k] = solveLinearSvr(rowAt, norms, &column[k * n], n, f, options.c, options.epsilon,
+                                      &w[k * f], bias_[k], done);
+            target_converged[k] = done;
+        });
+
+        kind_ = Kind::Linear;
+        weights_.assign(w.begin(), w.end());
+        for (size_t k = 0; k < ny; ++k) {
+            iterations += steps[k];
+            converged = converged && target_converged[k];
+        }
+        train_samples = n;
+    } else {
+        // RBF: SMO на первых max_samples записях, матрица ядра m x m не хранится целиком
+        const size_t m = std::min(samples.size(), std::max<size_t>(1, options.max_samples));
+        std::vector<float> x(m * f), norms(m);
+        std::vector<double> targets(m * ny);
+        parallelRanges(num_threads_, m, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; ++s) {
+                const int sample = static_cast<int>(samples[s]);
+                gatherFeatures(base, sample, &x[s * f]);
+                gatherTargets(base, sample, &targets[s * ny]);
+                norms[s] = dot(&x[s * f], &x[s * f], f);
+            }
+        });
+
+        const double gamma = options.gamma > 0.0 ? options.gamma : 1.0 / static_cast<double>(f);
+        const float gamma_f = static_cast<float>(gamma);
+        auto kernelRange = [&](size_t i, float* out, size_t begin, size_t end) {
+            const float* xi = &x[i * f];
+            for (size_t j = begin; j < end; ++j) {
+                float distance = norms[i] + norms[j] - 2.0f * dot(xi, &x[j * f], f);
+                out[j] = std::exp(-gamma_f * std::max(0.0f, distance));
+            }
+        };
+        // Строка ядра - m скалярных произведений длины F; на больших базах её считают все потоки
+        KernelRowCache cache(m, options.cache_mb << 20, [&](size_t i, float* out) {
+            if (m * f < kParallelRowWork) {
+                kernelRange(i, out, 0, m);
+            } else {
+                parallelRanges(num_threads_, m, [&](size_t begin, size_t end) { kernelRange(i, out, begin, end); });
+            }
+        });
+        const std::vector<float> qd(m, 1.0f);
+
+        // Цели решаются по очереди, строки ядра из кэша переиспользуются между ними
+        std::vector<double> coef(ny * m), column(m);
+        for (size_t k = 0; k < ny; ++k) {
+            for (size_t s = 0; s < m; ++s) {
+                column[s] = targets[s * ny + k];
+            }
+            bool done = false;
+            iterations += solveSvr(cache, qd, column.data(), m, options.c, options.epsilon, options.tolerance,
+                                   &coef[k * m], bias_[k], done);
+            converged = converged && done;
+        }
+
+        std::vector<size_t> support;
+        for (size_t s = 0; s < m; ++s) {
+            for (size_t k = 0; k < ny; ++k) {
+                if (coef[k * m + s] != 0.0) {
+                    support.push_back(s);
+                    break;
+                }
+            }
+        }
+
+        kind_ = Kind::Kernel;
+        gamma_ = gamma;
+        num_support_ = support.size();
+        support_.resize(num_support_ * f);
+        support_norms_.resize(num_support_);
+        coef_.resize(ny * num_support_);
+        for (size_t v = 0; v < num_support_; ++v) {
+            const size_t s = support[v];
+            std::memcpy(&support_[v * f], &x[s * f], f * sizeof(float));
+            support_norms_[v] = norms[s];
+            for (size_t k = 0; k < ny; ++k) {
+                coef_[k * num_support_ + v] = static_cast<float>(coef[k * m + s]);
+            }
+        }
+        train_samples = m;
+    }
+
+    if (report) {
+        *report = NativeTrainingReport();
+        report->train_samples = train_samples;
+        report->support_vectors = num_support_;
+        report->iterations = iterations;
+        report->converged = converged;
+        report->elapsed_ms = elapsedMs(start);
+    }
+    return true;
+}
+
+template <typename Source>
+void NativeRegressor::predictSamples(const Source& source, const uint64_t* samples, size_t count,
+                                     std::vector<float>& output) const {
+    const size_t f = static_cast<size_t>(num_features_);
+    const size_t ny = static_cast<size_t>(num_targets_);
+    output.assign(count * ny, 0.0f);
+    parallelRanges(num_threads_, count, [&](size_t begin, size_t end) {
+        std::vector<float> features(f);
+        std::vector<double> sums(ny);
+        for (size_t s = begin; s < end; ++s) {
+            gatherFeatures(source, static_cast<int>(samples ? samples[s] : s), features.data());
+            if (kind_ == Kind::Linear) {
+                for (size_t k = 0; k < ny; ++k) {
+                    sums[k] = dot(&weights_[k * f], features.data(), f);
+                }
+            } else {
+                std::fill(sums.begin(), sums.end(), 0.0);
+                const float norm = dot(features.data(), features.data(), f);
+                for (size_t v = 0; v < num_support_; ++v) {
+                    float distance = norm + support_norms_[v] - 2.0f * dot(&support_[v * f], features.data(), f);
+                    double kv = std::exp(-gamma_ * std::max(0.0f, distance));
+                    for (size_t k = 0; k < ny; ++k) {
+                        sums[k] += coef_[k * num_support_ + v] * kv;
+                    }
+                }
+            }
+            for (size_t k = 0; k < ny; ++k) {
+                output[s * ny + k] = static_cast<float>(y_mean_[k] + y_std_[k] * (bias_[k] + sums[k]));
+            }
+        }
+    });
+}
+
+bool NativeRegressor::predict(const LearningBaseData& data, std::vector<float>& output) {
+    if (data.x_lengths != x_lengths_) {
+        last_error_ = "Input lengths do not match the model";
+        return false;
+    }
+    predictSamples(data, nullptr, static_cast<size_t>(data.num_samples), output);
+    return true;
+}
+
+bool NativeRegressor::predict(const LearningBaseBinary& base, const std::vector<uint64_t>& samples,
+                              std::vector<float>& output) {
+    if (base.config().x_lengths != x_lengths_) {
+        last_error_ = "Input lengths do not match the model";
+        return false;
+    }
+    predictSamples(base, samples.data(), samples.size(), output);
+    return true;
+}
+
+bool NativeRegressor::save(const std::string& path) {
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            last_error_ = "Cannot create file: " + tmp_path;
+            return false;
+        }
+        std::vector<uint32_t> lengths(x_lengths_.begin(), x_lengths_.end());
+        file.write(kNativeModelMagic, sizeof(kNativeModelMagic));
+        writePod(file, kNativeModelVersion);
+        writePod(file, static_cast<uint32_t>(kind_));
+        writePod(file, static_cast<uint32_t>(lengths.size()));
+        writePod(file, static_cast<uint32_t>(num_targets_));
+        writeArray(file, lengths);
+        writeArray(file, x_mean_);
+        writeArray(file, x_scale_);
+        writeArray(file, y_mean_);
+        writeArray(file, y_std_);
+        if (kind_ == Kind::Linear) {
+            writeArray(file, bias_);
+            writeArray(file, weights_);
+        } else {
+            writePod(file, gamma_);
+            writePod(file, static_cast<uint64_t>(num_support_));
+            writeArray(file, bias_);
+            writeArray(file, support_);
+            writeArray(file, coef_);
+        }
+        if (!file) {
+            last_error_ = "Write failed: " + tmp_path;
+            file.close();
+            fs::remove(tmp_path);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+        last_error_ = "Cannot rename " + tmp_path + ": " + ec.message();
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+bool NativeRegressor::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        last_error_ = "Cannot open model file: " + path;
+        return false;
+    }
+
+    char magic[sizeof(kNativeModelMagic)];
+    uint32_t version = 0, kind = 0, nx = 0, ny = 0;
+    file.read(magic, sizeof(magic));
+    if (!file || std::memcmp(magic, kNativeModelMagic, sizeof(magic)) != 0) {
+        last_error_ = "Not a native model file: " + path;
+        return false;
+    }
+    if (!readPod(file, version) || !readPod(file, kind) || !readPod(file, nx) || !readPod(file, ny) ||
+        version != kNativeModelVersion || (kind != static_cast<uint32_t>(Kind::Linear) &&
+                                           kind != static_cast<uint32_t>(Kind::Kernel))) {
+        last_error_ = "Unsupported native model file: " + path;
+        return false;
+    }
+
+    std::vector<uint32_t> lengths;
+    bool ok = readArray(file, lengths, nx) && readArray(file, x_mean_, nx) && readArray(file, x_scale_, nx) &&
+              readArray(file, y_mean_, ny) && readArray(file, y_std_, ny);
+    kind_ = static_cast<Kind>(kind);
+    x_lengths_.assign(lengths.begin(), lengths.end());
+    num_targets_ = static_cast<int>(ny);
+    num_features_ = 0;
+    for (int len : x_lengths_) {
+        num_features_ += len;
+    }
+    const size_t f = static_cast<size_t>(num_features_);
+
+    weights_.clear();
+    support_.clear();
+    support_norms_.clear();
+    coef_.clear();
+    num_support_ = 0;
+    gamma_ = 0.0;
+    if (ok && kind_ == Kind::Linear) {
+        ok = readArray(file, bias_, ny) && readArray(file, weights_, ny * f);
+    } else if (ok) {
+        uint64_t num_support = 0;
+        ok = readPod(file, gamma_) && readPod(file, num_support) && readArray(file, bias_, ny) &&
+             readArray(file, support_, num_support * f) && readArray(file, coef_, ny * num_support);
+        num_support_ = static_cast<size_t>(num_support);
+        if (ok) {
+            support_norms_.resize(num_support_);
+            for (size_t v = 0; v < num_support_; ++v) {
+                support_norms_[v] = dot(&support_[v * f], &support_[v * f], f);
+            }
+        }
+    }
+    if (!ok) {
+        last_error_ = "Truncated native model file: " + path;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,106 @@
+#ifndef NATIVE_REGRESSION_H
+#define NATIVE_REGRESSION_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "learning_base_binary.h"
+#include "learning_base_config.h"
+#include "learning_base_parser.h"
+
+// Модели "linear_regression" и "svr", которые клиент обучает сам, без сервера и PyTorch.
+// Признаки записи - все каналы X подряд, нормированные статистикой каналов из
+// Configs (x_mean/x_std), целевые переменные - y_mean/y_std. У баз, загруженных
+// до появления статистики, нормировки нет.
+//
+// Файл модели .rsm, little-endian:
+//   magic "RSMODEL\0", version, kind, num_features_x, num_targets_y,
+//   uint32 x_lengths[nx], float32 x_mean[nx], float32 x_scale[nx], float64 y_mean[ny], float64 y_std[ny],
+//   linear: float64 bias[ny], float32 weights[ny][F]
+//   kernel: float64 gamma, uint64 m, float64 bias[ny], float32 support[m][F], float32 coef[ny][m]
+extern const char kNativeModelMagic[8];
+const uint32_t kNativeModelVersion = 1;
+
+enum class SvrKernel { Linear, Rbf };
+
+struct RidgeOptions {
+    double lambda = 1.0;          // регуляризация на нормированных признаках; свободный член не штрафуется
+};
+
+struct SvrOptions {
+    SvrKernel kernel = SvrKernel::Rbf;
+    double c = 1.0;
+    double epsilon = 0.1;         // ширина трубки в единицах std целевой переменной
+    double gamma = 0.0;           // RBF exp(-gamma * |a - b|^2); 0 - 1 / число признаков
+    double tolerance = 1e-3;      // критерий остановки SMO (RBF), как eps в LIBSVM
+    size_t max_samples = 4000;    // RBF: SMO квадратичен по записям, берём первые записи перемешанного train
+    size_t cache_mb = 256;        // RBF: кэш строк ядра; linear: признаки train в памяти, если помещаются
+};
+
+struct NativeTrainingReport {
+    size_t train_samples = 0;
+    size_t support_vectors = 0;   // svr rbf: записи с ненулевым коэффициентом хотя бы для одной цели
+    size_t iterations = 0;        // svr: шаги SMO (rbf) или обновления координат (linear) по всем целям
+    bool converged = true;        // svr: false - решатель остановлен по лимиту итераций
+    double elapsed_ms = 0.0;
+};
+
+class NativeRegressor {
+public:
+    explicit NativeRegressor(unsigned num_threads = 0); // 0 - по числу ядер
+
+    // config - описание базы из Configs (статистика для нормировки; в .rslb её нет),
+    // samples - номера записей базы (обычно train-часть .rssplit)
+    bool trainRidge(const LearningBaseBinary& base, const LearningBaseConfig& config,
+                    const std::vector<uint64_t>& samples, const RidgeOptions& options,
+                    NativeTrainingReport* report = nullptr);
+    bool trainSvr(const LearningBaseBinary& base, const LearningBaseConfig& config,
+                  const std::vector<uint64_t>& samples, const SvrOptions& options,
+                  NativeTrainingReport* report = nullptr);
+
+    // output -> [num_samples][num_targets]
+    bool predict(const LearningBaseData& data, std::vector<float>& output);
+    bool predict(const LearningBaseBinary& base, const std::vector<uint64_t>& samples, std::vector<float>& output);
+
+    bool save(const std::string& path);
+    bool load(const std::string& path);
+
+    const std::string& lastError() const { return last_error_; }
+    const std::vector<int>& inputLengths() const { return x_lengths_; }
+    int numTargets() const { return num_targets_; }
+    bool isKernel() const { return kind_ == Kind::Kernel; }
+    size_t numSupportVectors() const { return num_support_; }
+
+private:
+    enum class Kind : uint32_t { Linear = 1, Kernel = 2 };
+
+    unsigned num_threads_;
+    std::string last_error_;
+
+    Kind kind_ = Kind::Linear;
+    std::vector<int> x_lengths_;
+    int num_features_ = 0;        // сумма x_lengths
+    int num_targets_ = 0;
+    std::vector<float> x_mean_, x_scale_;   // по каналам
+    std::vector<double> y_mean_, y_std_;
+    std::vector<double> bias_;              // в нормированных единицах Y
+
+    std::vector<float> weights_;            // linear: [ny][F]
+
+    double gamma_ = 0.0;                    // kernel: только RBF, линейная SVR хранится как weights_
+    size_t num_support_ = 0;
+    std::vector<float> support_;            // [m][F], нормированные признаки
+    std::vector<float> support_norms_;      // |sv|^2
+    std::vector<float> coef_;               // [ny][m]
+
+    bool initModel(const LearningBaseBinary& base, const LearningBaseConfig& config, size_t num_samples);
+    template <typename Source>
+    void gatherFeatures(const Source& source, int sample, float* out) const;
+    template <typename Source>
+    void gatherTargets(const Source& source, int sample, double* out) const;
+    template <typename Source>
+    void predictSamples(const Source& source, const uint64_t* samples, size_t count, std::vector<float>& output) const;
+};
+
+#endif // NATIVE_REGRESSION_H
@@ -0,0 +1,347 @@
+#include "nmr_inference.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace {
+
+const char kWeightsMagic[8] = {'R', 'S', 'W', 'E', 'I', 'G', 'H', 'T'};
+const uint32_t kWeightsVersion = 1;
+
+const int kKernel = 5;
+const int kPad = 2;
+const int kTile = 256;          // тайл по времени для свёрток: входной тайл всех каналов остаётся в кэше
+const int kSampleBlock = 8;     // сэмплов на один проход по весам Linear
+const int kDepthBlock = 1024;   // блок по K для Linear: признаки блока сэмплов помещаются в L2
+const int kLanes = 8;
+
+template <typename T>
+bool readPod(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+bool readFloats(std::ifstream& file, std::vector<float>& data, size_t count) {
+    data.resize(count);
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(data.data()),
+                                       static_cast<std::streamsize>(count * sizeof(float))));
+}
+
+// out[t] += w * src[t]; независимые итерации, компилятор разворачивает в SIMD
+inline void axpy(float* out, const float* src, float w, int n) {
+    for (int t = 0; t < n; ++t) {
+        out[t] += w * src[t];
+    }
+}
+
+// Скалярное произведение на kLanes независимых аккумуляторах (векторизуется без -ffast-math)
+inline float dot(const float* a, const float* b, int n) {
+    float acc[kLanes] = {};
+    int i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        for (int l = 0; l < kLanes; ++l) {
+            acc[l] += a[i + l] * b[i + l];
+        }
+    }
+    float sum = 0.0f;
+    for (int l = 0; l < kLanes; ++l) {
+        sum += acc[l];
+    }
+    for (; i < n; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+// ReLU + MaxPool1d(2): max(relu(a), relu(b)) == relu(max(a, b))
+inline void reluMaxPool(const float* row, float* out, int pooled_len) {
+    for (int t = 0; t < pooled_len; ++t) {
+        float v = std::max(row[2 * t], row[2 * t + 1]);
+        out[t] = v > 0.0f ? v : 0.0f;
+    }
+}
+
+unsigned resolveThreads(unsigned requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+} // namespace
+
+NmrInferenceEngine::NmrInferenceEngine(unsigned num_threads)
+    : num_threads_(resolveThreads(num_threads)) {}
+
+bool NmrInferenceEngine::load(const std::string& path) {
+    last_error_.clear();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        last_error_ = "Cannot open weights file: " + path;
+        return false;
+    }
+
+    char magic[8];
+    uint32_t version = 0, num_channels = 0, num_targets = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, kWeightsMagic, sizeof(magic)) != 0 ||
+        !readPod(file, version) || !readPod(file, num_channels) || !readPod(file, num_targets)) {
+        last_error_ = "Not a native weights file: " + path;
+        return false;
+    }
+    if (version != kWeightsVersion) {
+        last_error_ = "Unsupported native weights version: " + std::to_string(version);
+        return false;
+    }
+
+    x_lengths_.assign(num_channels, 0);
+    for (auto& length : x_lengths_) {
+        uint32_t value = 0;
+        if (!readPod(file, value)) {
+            last_error_ = "Truncated weights file: " + path;
+            return false;
+        }
+        length = static_cast<int>(value);
+    }
+    num_targets_ = static_cast<int>(num_targets);
+
+    for (Tensor* tensor : {&conv1_w_, &conv1_b_, &conv2_w_, &conv2_b_, &fc1_w_, &fc1_b_, &fc2_w_, &fc2_b_}) {
+        uint32_t ndim = 0;
+        if (!readPod(file, ndim) || ndim == 0 || ndim > 4) {
+            last_error_ = "Corrupted tensor header in " + path;
+            return false;
+        }
+        tensor->shape.assign(ndim, 0);
+        size_t count = 1;
+        for (auto& dim : tensor->shape) {
+            uint32_t value = 0;
+            readPod(file, value);
+            dim = static_cast<int>(value);
+            count *= value;
+        }
+        if (!readFloats(file, tensor->data, count)) {
+            last_error_ = "Truncated weights file: " + path;
+            return false;
+        }
+    }
+
+    if (!validateShapes()) {
+        return false;
+    }
+
+    // Эталонный прогон PyTorch: те же входы должны дать те же выходы
+    uint32_t reference_samples = 0;
+    if (!readPod(file, reference_samples) || reference_samples == 0) {
+        last_error_ = "Weights file has no PyTorch reference outputs: " + path;
+        return false;
+    }
+    std::vector<std::vector<float>> reference_inputs(num_channels);
+    for (uint32_t c = 0; c < num_channels; ++c) {
+        if (!readFloats(file, reference_inputs[c], static_cast<size_t>(reference_samples) * x_lengths_[c])) {
+            last_error_ = "Truncated reference inputs in " + path;
+            return false;
+        }
+    }
+    std::vector<float> reference_outputs;
+    if (!readFloats(file, reference_outputs, static_cast<size_t>(reference_samples) * num_targets_)) {
+        last_error_ = "Truncated reference outputs in " + path;
+        return false;
+    }
+
+    std::vector<const float*> channels;
+    for (const auto& input : reference_inputs) {
+        channels.push_back(input.data());
+    }
+    std::vector<float> outputs;
+    predict(channels, static_cast<int>(reference_samples), outputs);
+
+    reference_error_ = 0.0;
+    bool matches = true;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        double diff = std::fabs(static_cast<double>(outputs[i]) - reference_outputs[i]);
+        reference_error_ = std::max(reference_error_, diff);
+        if (!(diff <= 1e-3 * std::max(1.0, std::fabs(static_cast<double>(reference_outputs[i]))))) {
+            matches = false;
+        }
+    }
+    if (!matches) {
+        last_error_ = "Native outputs differ from PyTorch reference (max abs error " +
+                      std::to_string(reference_error_) + ")";
+        return false;
+    }
+    return true;
+}
+
+bool NmrInferenceEngine::validateShapes() {
+    const int num_channels = static_cast<int>(x_lengths_.size());
+    if (num_channels == 0) {
+        last_error_ = "Weights file has no input channels";
+        return false;
+    }
+    max_len_ = *std::max_element(x_lengths_.begin(), x_lengths_.end());
+    len1_ = max_len_ / 2;
+    len2_ = len1_ / 2;
+
+    auto shapeIs = [](const Tensor& t, std::initializer_list<int> dims) {
+        return t.shape == std::vector<int>(dims);
+    };
+
+    conv1_out_ = conv1_w_.shape.size() == 3 ? conv1_w_.shape[0] : 0;
+    conv2_out_ = conv2_w_.shape.size() == 3 ? conv2_w_.shape[0] : 0;
+    hidden_ = fc1_w_.shape.size() == 2 ? fc1_w_.shape[0] : 0;
+    flat_size_ = conv2_out_ * len2_;
+
+    bool ok = shapeIs(conv1_w_, {conv1_out_, num_channels, kKernel}) && shapeIs(conv1_b_, {conv1_out_}) &&
+              shapeIs(conv2_w_, {conv2_out_, conv1_out_, kKernel}) && shapeIs(conv2_b_, {conv2_out_}) &&
+              shapeIs(fc1_w_, {hidden_, flat_size_}) && shapeIs(fc1_b_, {hidden_}) &&
+              shapeIs(fc2_w_, {num_targets_, hidden_}) && shapeIs(fc2_b_, {num_targets_});
+    if (!ok || conv1_out_ == 0 || conv2_out_ == 0 || hidden_ == 0 || len2_ == 0) {
+        last_error_ = "Weights do not match DynamicNMRRegressor architecture";
+        return false;
+    }
+    return true;
+}
+
+void NmrInferenceEngine::initScratch(Scratch& scratch) const {
+    scratch.input.assign(x_lengths_.size() * (max_len_ + 2 * kPad), 0.0f);
+    scratch.pooled1.assign(static_cast<size_t>(conv1_out_) * (len1_ + 2 * kPad), 0.0f);
+    scratch.conv_tile.assign(kTile, 0.0f);
+    scratch.features.assign(static_cast<size_t>(kSampleBlock) * flat_size_, 0.0f);
+    scratch.hidden.assign(static_cast<size_t>(kSampleBlock) * hidden_, 0.0f);
+}
+
+void NmrInferenceEngine::extractFeatures(const std::vector<const float*>& channels, int sample,
+                                         Scratch& scratch, float* features) const {
+    const int num_channels = static_cast<int>(x_lengths_.size());
+    const int in_stride = max_len_ + 2 * kPad;
+    const int p1_stride = len1_ + 2 * kPad;
+
+    // Дополнение нулями до max_len (края под padding уже нулевые и не меняются)
+    for (int c = 0; c < num_channels; ++c) {
+        float* row = scratch.input.data() + static_cast<size_t>(c) * in_stride + kPad;
+        const int length = x_lengths_[c];
+        std::memcpy(row, channels[c] + static_cast<size_t>(sample) * length, length * sizeof(float));
+        std::fill(row + length, row + max_len_, 0.0f);
+    }
+
+    float* tile = scratch.conv_tile.data();
+
+    // Conv1 + ReLU + MaxPool: [M, max_len] -> [F1, len1]
+    for (int t0 = 0; t0 < 2 * len1_; t0 += kTile) {
+        const int width = std::min(kTile, 2 * len1_ - t0);
+        for (int f = 0; f < conv1_out_; ++f) {
+            std::fill(tile, tile + width, conv1_b_.data[f]);
+            const float* w = conv1_w_.data.data() + static_cast<size_t>(f) * num_channels * kKernel;
+            for (int m = 0; m < num_channels; ++m) {
+                const float* src = scratch.input.data() + static_cast<size_t>(m) * in_stride + t0;
+                for (int k = 0; k < kKernel; ++k) {
+                    axpy(tile, src + k, w[m * kKernel + k], width);
+                }
+            }
+            float* out = scratch.pooled1.data() + static_cast<size_t>(f) * p1_stride + kPad + t0 / 2;
+            reluMaxPool(tile, out, width / 2);
+        }
+    }
+
+    // Conv2 + ReLU + MaxPool + Flatten: [F1, len1] -> features[F2 * len2]
+    for (int t0 = 0; t0 < 2 * len2_; t0 += kTile) {
+        const int width = std::min(kTile, 2 * len2_ - t0);
+        for (int f = 0; f < conv2_out_; ++f) {
+            std::fill(tile, tile + width, conv2_b_.data[f]);
+            const float* w = conv2_w_.data.data() + static_cast<size_t>(f) * conv1_out_ * kKernel;
+            for (int m = 0; m < conv1_out_; ++m) {
+                const float* src = scratch.pooled1.data() + static_cast<size_t>(m) * p1_stride + t0;
+                for (int k = 0; k < kKernel; ++k) {
+                    axpy(tile, src + k, w[m * kKernel + k], width);
+                }
+            }
+            reluMaxPool(tile, features + static_cast<size_t>(f) * len2_ + t0 / 2, width / 2);
+        }
+    }
+}
+
+void NmrInferenceEngine::forwardBlock(const std::vector<const float*>& channels, int first, int count,
+                                      Scratch& scratch, float* output) const {
+    for (int s = 0; s < count; ++s) {
+        extractFeatures(channels, first + s, scratch, scratch.features.data() + static_cast<size_t>(s) * flat_size_);
+    }
+
+    // Linear(flat, hidden): каждая строка весов читается один раз на блок сэмплов
+    float* hidden = scratch.hidden.data();
+    for (int s = 0; s < count; ++s) {
+        std::copy(fc1_b_.data.begin(), fc1_b_.data.end(), hidden + static_cast<size_t>(s) * hidden_);
+    }
+    for (int k0 = 0; k0 < flat_size_; k0 += kDepthBlock) {
+        const int depth = std::min(kDepthBlock, flat_size_ - k0);
+        for (int j = 0; j < hidden_; ++j) {
+            const float* w = fc1_w_.data.data() + static_cast<size_t>(j) * flat_size_ + k0;
+            for (int s = 0; s < count; ++s) {
+                const float* x = scratch.features.data() + static_cast<size_t>(s) * flat_size_ + k0;
+                hidden[static_cast<size_t>(s) * hidden_ + j] += dot(w, x, depth);
+            }
+        }
+    }
+    for (int i = 0; i < count * hidden_; ++i) {
+        hidden[i] = hidden[i] > 0.0f ? hidden[i] : 0.0f;
+    }
+
+    // Linear(hidden, num_targets)
+    for (int s = 0; s < count; ++s) {
+        const float* h = hidden + static_cast<size_t>(s) * hidden_;
+        float* out = output + static_cast<size_t>(first + s) * num_targets_;
+        for (int n = 0; n < num_targets_; ++n) {
+            out[n] = fc2_b_.data[n] + dot(fc2_w_.data.data() + static_cast<size_t>(n) * hidden_, h, hidden_);
+        }
+    }
+}
+
+bool NmrInferenceEngine::predict(const std::vector<const float*>& channels, int num_samples, std::vector<float>& output) {
+    if (channels.size() != x_lengths_.size()) {
+        last_error_ = "Feature count mismatch: model has " + std::to_string(x_lengths_.size()) +
+                      ", data has " + std::to_string(channels.size());
+        return false;
+    }
+
+    output.assign(static_cast<size_t>(num_samples) * num_targets_, 0.0f);
+    const int num_blocks = (num_samples + kSampleBlock - 1) / kSampleBlock;
+    std::atomic<int> next_block{0};
+
+    auto worker = [&]() {
+        Scratch scratch;
+        initScratch(scratch);
+        for (int block = next_block++; block < num_blocks; block = next_block++) {
+            int first = block * kSampleBlock;
+            forwardBlock(channels, first, std::min(kSampleBlock, num_samples - first), scratch, output.data());
+        }
+    };
+
+    unsigned threads = std::min<unsigned>(num_threads_, static_cast<unsigned>(num_blocks));
+    if (threads <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back(worker);
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+    return true;
+}
+
+bool NmrInferenceEngine::predict(const LearningBaseData& data, std::vector<float>& output) {
+    if (data.x_lengths != x_lengths_) {
+        last_error_ = "Input lengths do not match the model";
+        return false;
+    }
+    std::vector<const float*> channels;
+    for (const auto& channel : data.x) {
+        channels.push_back(channel.data());
+    }
+    return predict(channels, data.num_samples, output);
+}
@@ -0,0 +1,66 @@
+#ifndef NMR_INFERENCE_H
+#define NMR_INFERENCE_H
+
+#include <string>
+#include <vector>
+#include "learning_base_parser.h"
+
+// CPU-инференс DynamicNMRRegressor (python_server/models/ConvLayers_model.py):
+// дополнение сигналов нулями до max_len, Conv1d(k=5)+ReLU+MaxPool1d(2) дважды,
+// Flatten, Linear+ReLU, Linear. Dropout на инференсе не действует.
+// Веса читаются из .rsw (python_server/ml/export_weights.py).
+class NmrInferenceEngine {
+public:
+    explicit NmrInferenceEngine(unsigned num_threads = 0); // 0 - по числу ядер
+
+    // Загружает веса и сверяет свой результат с эталонным прогоном PyTorch из файла
+    bool load(const std::string& path);
+    const std::string& lastError() const { return last_error_; }
+
+    const std::vector<int>& inputLengths() const { return x_lengths_; }
+    int numTargets() const { return num_targets_; }
+    double referenceError() const { return reference_error_; } // макс. отклонение от PyTorch
+
+    // channels[c] -> [num_samples][x_lengths[c]], output -> [num_samples][num_targets]
+    bool predict(const std::vector<const float*>& channels, int num_samples, std::vector<float>& output);
+    bool predict(const LearningBaseData& data, std::vector<float>& output);
+
+private:
+    struct Tensor {
+        std::vector<int> shape;
+        std::vector<float> data;
+    };
+
+    // Рабочие буферы одного потока
+    struct Scratch {
+        std::vector<float> input;     // [M][max_len + 4], с нулевыми краями под padding=2
+        std::vector<float> pooled1;   // [F1][len1 + 4]
+        std::vector<float> conv_tile; // строка свёртки до пулинга
+        std::vector<float> features;  // [block][flat_size]
+        std::vector<float> hidden;    // [block][hidden]
+    };
+
+    unsigned num_threads_;
+    std::string last_error_;
+
+    std::vector<int> x_lengths_;
+    int num_targets_ = 0;
+    int max_len_ = 0;
+    int len1_ = 0;         // после первого пулинга
+    int len2_ = 0;         // после второго пулинга
+    int conv1_out_ = 0;
+    int conv2_out_ = 0;
+    int hidden_ = 0;
+    int flat_size_ = 0;
+
+    Tensor conv1_w_, conv1_b_, conv2_w_, conv2_b_;
+    Tensor fc1_w_, fc1_b_, fc2_w_, fc2_b_;
+    double reference_error_ = 0.0;
+
+    bool validateShapes();
+    void initScratch(Scratch& scratch) const;
+    void extractFeatures(const std::vector<const float*>& channels, int sample, Scratch& scratch, float* features) const;
+    void forwardBlock(const std::vector<const float*>& channels, int first, int count, Scratch& scratch, float* output) const;
+};
+
+#endif // NMR_INFERENCE_H
@@ -0,0 +1,259 @@
+#include "prediction_cache.h"
+#include "content_hash.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char kIndexFileName[] = "index.txt";
+const char kIndexVersion[] = "ResSysPredictionCache 1";
+
+// Поля с разделителем, чтобы "ab"+"c" и "a"+"bc" давали разные ключи
+void hashField(Xxh64& hasher, const std::string& value) {
+    uint64_t size = value.size();
+    hasher.update(&size, sizeof(size));
+    hasher.update(value);
+}
+
+} // namespace
+
+PredictionCache::PredictionCache(const std::string& cache_dir, uint64_t max_bytes, Logger* logger)
+    : cache_dir_(cache_dir), max_bytes_(max_bytes), logger_(logger) {}
+
+std::string PredictionCache::blobPath(const std::string& key) const {
+    return (fs::path(cache_dir_) / (key + ".out")).string();
+}
+
+bool PredictionCache::open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code ec;
+    fs::create_directories(cache_dir_, ec);
+    if (ec) {
+        if (logger_) logger_->error("Cannot create prediction cache dir " + cache_dir_ + ": " + ec.message());
+        return false;
+    }
+
+    lru_.clear();
+    index_.clear();
+    total_bytes_ = 0;
+
+    std::ifstream file(fs::path(cache_dir_) / kIndexFileName);
+    if (!file.is_open()) {
+        return true; // пустой кэш
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != kIndexVersion) {
+        if (logger_) logger_->warning("Prediction cache index has unknown format, cache reset");
+        return true;
+    }
+
+    // Индекс хранится от свежих к старым: порядок строк = порядок LRU
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        Entry entry;
+        std::string mse, r2, test_loss;
+        if (!std::getline(fields, entry.key, '\t') || !(fields >> entry.size) || !fields.ignore(1) ||
+            !std::getline(fields, mse, '\t') || !std::getline(fields, r2, '\t') ||
+            !std::getline(fields, test_loss, '\t') || !std::getline(fields, entry.prediction.output_path)) {
+            continue;
+        }
+        try {
+            entry.prediction.metrics.mse = std::stod(mse);
+            entry.prediction.metrics.r2 = std::stod(r2);
+            entry.prediction.metrics.test_loss = std::stod(test_loss);
+        } catch (...) {
+            continue;
+        }
+        if (index_.count(entry.key) || !fs::exists(blobPath(entry.key), ec)) {
+            continue;
+        }
+        total_bytes_ += entry.size;
+        lru_.push_back(entry);
+        index_[entry.key] = std::prev(lru_.end());
+    }
+
+    evictLocked();
+    if (logger_) {
+        logger_->info("Prediction cache: " + std::to_string(lru_.size()) + " entries, " +
+                      std::to_string(total_bytes_ / 1024) + " KB in " + cache_dir_);
+    }
+    return true;
+}
+
+std::string PredictionCache::makeKey(const std::string& input_path, const std::string& config_path,
+                                     const std::vector<std::string>& weights_paths,
+                                     const std::string& model_name, const std::string& base_name) const {
+    uint64_t input_hash = 0;
+    uint64_t config_hash = 0;
+    if (!hashFileContents(input_path, input_hash) || !hashFileContents(config_path, config_hash)) {
+        return "";
+    }
+
+    Xxh64 hasher;
+    hashField(hasher, kIndexVersion);
+    hashField(hasher, model_name);
+    hashField(hasher, base_name);
+    hasher.update(&input_hash, sizeof(input_hash));
+    hasher.update(&config_hash, sizeof(config_hash));
+
+    // Веса не хэшируем целиком: переобучение всегда меняет размер или время записи
+    for (const auto& path : weights_paths) {
+        std::error_code ec;
+        uint64_t size = fs::file_size(path, ec);
+        if (ec) {
+            hashField(hasher, "missing");
+            continue;
+        }
+        int64_t mtime = fs::last_write_time(path, ec).time_since_epoch().count();
+        hashField(hasher, fs::path(path).filename().string());
+        hasher.update(&size, sizeof(size));
+        hasher.update(&mtime, sizeof(mtime));
+    }
+    return hashToHex(hasher.digest());
+}
+
+bool PredictionCache::lookup(const std::string& key, CachedPrediction& result) {
+    if (key.empty()) {
+        ++misses_;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+        ++misses_;
+        return false;
+    }
+
+    auto it = found->second;
+    std::error_code ec;
+    fs::path output(it->prediction.output_path);
+    if (output.has_parent_path()) {
+        fs::create_directories(output.parent_path(), ec);
+    }
+    // Файл результатов мог быть перезаписан предсказанием по другому входу с тем же именем
+    fs::copy_file(blobPath(key), output, fs::copy_options::overwrite_existing, ec);
+    if (ec) {
+        if (logger_) logger_->warning("Prediction cache entry " + key + " is unusable: " + ec.message());
+        removeLocked(it);
+        saveIndexLocked();
+        ++misses_;
+        return false;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it);
+    saveIndexLocked();
+    result = it->prediction;
+    ++hits_;
+    return true;
+}
+
+bool PredictionCache::store(const std::string& key, const CachedPrediction& result) {
+    if (key.empty()) {
+        return false;
+    }
+
+    std::error_code ec;
+    uint64_t size = fs::file_size(result.output_path, ec);
+    if (ec) {
+        if (logger_) logger_->warning("Prediction output not cached, file missing: " + result.output_path);
+        return false;
+    }
+    if (size > max_bytes_) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string blob = blobPath(key);
+    std::string tmp = blob + ".tmp";
+    fs::copy_file(result.output_path, tmp, fs::copy_options::overwrite_existing, ec);
+    if (!ec) {
+        fs::rename(tmp, blob, ec);
+    }
+    if (ec) {
+        fs::remove(tmp, ec);
+        if (logger_) logger_->warning("Cannot store prediction in cache: " + ec.message());
+        return false;
+    }
+
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        total_bytes_ -= found->second->size;
+        lru_.erase(found->second);
+        index_.erase(found);
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.size = size;
+    entry.prediction = result;
+    lru_.push_front(entry);
+    index_[key] = lru_.begin();
+    total_bytes_ += size;
+
+    evictLocked();
+    return saveIndexLocked();
+}
+
+void PredictionCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!lru_.empty()) {
+        removeLocked(std::prev(lru_.end()));
+    }
+    saveIndexLocked();
+}
+
+uint64_t PredictionCache::sizeBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_bytes_;
+}
+
+size_t PredictionCache::entries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+void PredictionCache::removeLocked(std::list<Entry>::iterator it) {
+    std::error_code ec;
+    fs::remove(blobPath(it->key), ec);
+    total_bytes_ -= it->size;
+    index_.erase(it->key);
+    lru_.erase(it);
+}
+
+void PredictionCache::evictLocked() {
+    while (total_bytes_ > max_bytes_ && !lru_.empty()) {
+        auto oldest = std::prev(lru_.end());
+        if (logger_) logger_->debug("Prediction cache evicts " + oldest->key);
+        removeLocked(oldest);
+    }
+}
+
+bool PredictionCache::saveIndexLocked() {
+    fs::path path = fs::path(cache_dir_) / kIndexFileName;
+    fs::path tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.precision(17);
+        file << kIndexVersion << "\n";
+        for (const auto& entry : lru_) {
+            file << entry.key << '\t' << entry.size << '\t' << entry.prediction.metrics.mse << '\t'
+                 << entry.prediction.metrics.r2 << '\t' << entry.prediction.metrics.test_loss << '\t'
+                 << entry.prediction.output_path << "\n";
+        }
+        if (!file.good()) {
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec); // индекс всегда целый, даже если процесс упадёт посреди записи
+    return !ec;
+}
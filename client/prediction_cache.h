@@ -0,0 +1,73 @@
+#ifndef PREDICTION_CACHE_H
+#define PREDICTION_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "logger.h"
+#include "prediction_output.h"
+
+struct CachedPrediction {
+    std::string output_path;
+    PredictionMetrics metrics;
+};
+
+// Дисковый кэш результатов предсказаний. Ключ - XXH64 от содержимого входного
+// файла, конфига обучающей базы, имён модели/базы и размера+mtime файлов весов,
+// так что переобучение модели или правка базы автоматически дают промах.
+// Каталог: <key>.out (копии файлов результатов) и index.txt; запись через
+// временный файл + rename, вытеснение LRU по суммарному размеру.
+class PredictionCache {
+public:
+    PredictionCache(const std::string& cache_dir, uint64_t max_bytes, Logger* logger = nullptr);
+
+    PredictionCache(const PredictionCache&) = delete;
+    PredictionCache& operator=(const PredictionCache&) = delete;
+
+    bool open(); // создаёт каталог и читает индекс
+
+    // Пустая строка - ключ построить нельзя (нет входного файла или конфига)
+    std::string makeKey(const std::string& input_path, const std::string& config_path,
+                        const std::vector<std::string>& weights_paths,
+                        const std::string& model_name, const std::string& base_name) const;
+
+    // При попадании файл результатов восстанавливается по сохранённому output_path
+    bool lookup(const std::string& key, CachedPrediction& result);
+    bool store(const std::string& key, const CachedPrediction& result);
+    void clear();
+
+    uint64_t hits() const { return hits_.load(); }
+    uint64_t misses() const { return misses_.load(); }
+    uint64_t sizeBytes() const;
+    size_t entries() const;
+
+private:
+    struct Entry {
+        std::string key;
+        uint64_t size = 0;
+        CachedPrediction prediction;
+    };
+
+    std::string cache_dir_;
+    uint64_t max_bytes_;
+    Logger* logger_;
+
+    mutable std::mutex mutex_;
+    std::list<Entry> lru_; // начало - самые свежие
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    uint64_t total_bytes_ = 0;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+
+    std::string blobPath(const std::string& key) const;
+    void evictLocked();
+    void removeLocked(std::list<Entry>::iterator it);
+    bool saveIndexLocked();
+};
+
+#endif // PREDICTION_CACHE_H
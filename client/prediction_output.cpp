@@ -0,0 +1,154 @@
+#include "prediction_output.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+PredictionMetrics computePredictionMetrics(const float* predictions, const float* targets,
+                                           size_t num_samples, int num_targets) {
+    PredictionMetrics metrics;
+    if (num_samples == 0 || num_targets <= 0) {
+        return metrics;
+    }
+
+    std::vector<double> mean(num_targets, 0.0);
+    for (size_t s = 0; s < num_samples; ++s) {
+        for (int n = 0; n < num_targets; ++n) {
+            mean[n] += targets[s * num_targets + n];
+        }
+    }
+    for (double& m : mean) {
+        m /= static_cast<double>(num_samples);
+    }
+
+    std::vector<double> ss_res(num_targets, 0.0), ss_tot(num_targets, 0.0);
+    for (size_t s = 0; s < num_samples; ++s) {
+        for (int n = 0; n < num_targets; ++n) {
+            double target = targets[s * num_targets + n];
+            double err = predictions[s * num_targets + n] - target;
+            ss_res[n] += err * err;
+            ss_tot[n] += (target - mean[n]) * (target - mean[n]);
+        }
+    }
+
+    double total_res = 0.0, r2_sum = 0.0;
+    for (int n = 0; n < num_targets; ++n) {
+        total_res += ss_res[n];
+        // sklearn: при нулевой дисперсии цели 1.0 для точного ответа, иначе 0.0
+        if (ss_tot[n] > 0.0) {
+            r2_sum += 1.0 - ss_res[n] / ss_tot[n];
+        } else {
+            r2_sum += ss_res[n] == 0.0 ? 1.0 : 0.0;
+        }
+    }
+
+    metrics.mse = total_res / (static_cast<double>(num_samples) * num_targets);
+    metrics.r2 = r2_sum / num_targets;
+    metrics.test_loss = metrics.mse;
+    return metrics;
+}
+
+std::string predictionOutputPath(const std::string& output_dir, const std::string& input_file,
+                                 const std::string& model_name, const std::string& base_name) {
+    std::string filename = fs::path(input_file).stem().string() + "_" + model_name + "_" + base_name + "_out.txt";
+    return (fs::path(output_dir) / filename).string();
+}
+
+bool writePredictionOutput(const std::string& path, const std::string& input_file,
+                           const std::string& model_name, const std::string& base_name,
+                           const PredictionMetrics& metrics, const float* predictions,
+                           const float* targets, size_t num_samples, int num_targets) {
+    fs::path output_path(path);
+    if (output_path.has_parent_path()) {
+        fs::create_directories(output_path.parent_path());
+    }
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char number[64];
+    auto fixed6 = [&](double value) {
+        std::snprintf(number, sizeof(number), "%.6f", value);
+        return number;
+    };
+
+    file << "PREDICTION RESULTS\n";
+    file << "==================\n";
+    file << "Input file: " << input_file << "\n";
+    file << "Model: " << model_name << "\n";
+    file << "Training base: " << base_name << "\n";
+    file << "MSE: " << fixed6(metrics.mse) << "\n";
+    file << "Loss: " << fixed6(metrics.test_loss) << "\n";
+    file << "R2 Score: " << fixed6(metrics.r2) << "\n";
+    file << "\nPREDICTIONS:\n";
+
+    // Заголовок повторяет save_predictions один в один (включая лишний Pred_N)
+    file << "Sample\t";
+    for (int n = 0; n < num_targets; ++n) {
+        file << (n ? "\t" : "") << "Target_" << n;
+    }
+    file << "\t";
+    for (int n = 0; n <= num_targets; ++n) {
+        file << (n ? "\t" : "") << "Pred_" << n;
+    }
+    file << "\n";
+
+    for (size_t s = 0; s < num_samples; ++s) {
+        file << (s + 1) << "\t";
+        for (int n = 0; n < num_targets; ++n) {
+            file << (n ? "\t" : "") << fixed6(targets[s * num_targets + n]);
+        }
+        file << "\t";
+        for (int n = 0; n < num_targets; ++n) {
+            file << (n ? "\t" : "") << fixed6(predictions[s * num_targets + n]);
+        }
+        file << "\n";
+    }
+
+    return static_cast<bool>(file);
+}
+
+bool readPredictionOutput(const std::string& path, int num_targets, std::vector<float>& predictions,
+                          std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "Cannot open prediction output: " + path;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line) && line.rfind("PREDICTIONS:", 0) != 0) {
+    }
+    if (!std::getline(file, line)) { // строка заголовка таблицы
+        error = "No predictions table in " + path;
+        return false;
+    }
+
+    predictions.clear();
+    size_t row = 0;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        ++row;
+        std::istringstream fields(line);
+        double value = 0.0;
+        fields >> value; // номер записи
+        for (int n = 0; n < num_targets; ++n) {
+            fields >> value; // Target_n
+        }
+        for (int n = 0; n < num_targets; ++n) {
+            if (!(fields >> value)) {
+                error = "Malformed prediction row " + std::to_string(row) + " in " + path;
+                return false;
+            }
+            predictions.push_back(static_cast<float>(value));
+        }
+    }
+    return true;
+}
@@ -0,0 +1,31 @@
+#ifndef PREDICTION_OUTPUT_H
+#define PREDICTION_OUTPUT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct PredictionMetrics {
+    double mse = 0.0;
+    double r2 = 0.0;         // как sklearn r2_score: среднее по целевым переменным
+    double test_loss = 0.0;
+};
+
+PredictionMetrics computePredictionMetrics(const float* predictions, const float* targets,
+                                           size_t num_samples, int num_targets);
+
+// <output_dir>/<input_stem>_<model>_<base>_out.txt - то же имя, что даёт save_predictions
+std::string predictionOutputPath(const std::string& output_dir, const std::string& input_file,
+                                 const std::string& model_name, const std::string& base_name);
+
+// Файл результатов в формате save_predictions из python_server/ml/predict.py
+bool writePredictionOutput(const std::string& path, const std::string& input_file,
+                           const std::string& model_name, const std::string& base_name,
+                           const PredictionMetrics& metrics, const float* predictions,
+                           const float* targets, size_t num_samples, int num_targets);
+
+// Столбцы Pred_* из файла результатов (обратное к writePredictionOutput)
+bool readPredictionOutput(const std::string& path, int num_targets, std::vector<float>& predictions,
+                          std::string& error);
+
+#endif // PREDICTION_OUTPUT_H
@@ -0,0 +1,72 @@
+#include "prediction_payload.h"
+#include <cstring>
+
+const char kPredictionPayloadMagic[8] = {'R', 'S', 'T', 'E', 'N', 'S', 'O', 'R'};
+
+namespace {
+
+const size_t kPayloadAlignment = 64;
+
+void putU32(char* out, size_t& pos, uint32_t value) {
+    std::memcpy(out + pos, &value, sizeof(value));
+    pos += sizeof(value);
+}
+
+void putFloats(char* out, size_t& pos, const float* values, size_t count) {
+    if (count > 0) {
+        std::memcpy(out + pos, values, count * sizeof(float));
+        pos += count * sizeof(float);
+    }
+}
+
+size_t payloadHeaderSize(const LearningBaseData& data) {
+    size_t header_size = sizeof(kPredictionPayloadMagic) + 5 * sizeof(uint32_t) + data.x_lengths.size() * sizeof(uint32_t);
+    return (header_size + kPayloadAlignment - 1) / kPayloadAlignment * kPayloadAlignment;
+}
+
+} // namespace
+
+size_t predictionPayloadSize(const LearningBaseData& data, size_t num_samples) {
+    size_t values_per_sample = static_cast<size_t>(data.num_targets_y);
+    for (int length : data.x_lengths) {
+        values_per_sample += static_cast<size_t>(length);
+    }
+    return payloadHeaderSize(data) + num_samples * values_per_sample * sizeof(float);
+}
+
+void encodePredictionPayload(const LearningBaseData& data, std::string& payload) {
+    encodePredictionPayload(data, 0, static_cast<size_t>(data.num_samples), payload);
+}
+
+void encodePredictionPayload(const LearningBaseData& data, size_t first_sample, size_t num_samples,
+                             std::string& payload) {
+    payload.assign(predictionPayloadSize(data, num_samples), '\0');
+    writePredictionPayload(data, first_sample, num_samples, &payload[0]);
+}
+
+void writePredictionPayload(const LearningBaseData& data, size_t first_sample, size_t num_samples, char* out) {
+    const uint32_t num_features_x = static_cast<uint32_t>(data.x_lengths.size());
+    const size_t header_size = payloadHeaderSize(data);
+
+    // Заголовок, затем строки каналов как есть - без промежуточных копий
+    std::memset(out, 0, header_size);
+    size_t pos = 0;
+    std::memcpy(out + pos, kPredictionPayloadMagic, sizeof(kPredictionPayloadMagic));
+    pos += sizeof(kPredictionPayloadMagic);
+    putU32(out, pos, kPredictionPayloadVersion);
+    putU32(out, pos, static_cast<uint32_t>(header_size));
+    putU32(out, pos, static_cast<uint32_t>(num_samples));
+    putU32(out, pos, static_cast<uint32_t>(data.num_targets_y));
+    putU32(out, pos, num_features_x);
+    for (int length : data.x_lengths) {
+        putU32(out, pos, static_cast<uint32_t>(length));
+    }
+
+    pos = header_size;
+    for (size_t c = 0; c < data.x.size(); ++c) {
+        size_t length = static_cast<size_t>(data.x_lengths[c]);
+        putFloats(out, pos, data.x[c].data() + first_sample * length, num_samples * length);
+    }
+    size_t num_targets = static_cast<size_t>(data.num_targets_y);
+    putFloats(out, pos, data.y.data() + first_sample * num_targets, num_samples * num_targets);
+}
@@ -0,0 +1,28 @@
+#ifndef PREDICTION_PAYLOAD_H
+#define PREDICTION_PAYLOAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "learning_base_parser.h"
+
+// Тело POST /predict/binary (application/octet-stream), всё little-endian:
+//   char     magic[8] = "RSTENSOR"
+//   uint32   version, header_size, num_samples, num_targets_y, num_features_x
+//   uint32   x_lengths[num_features_x]
+//   нули до header_size (кратно 64, блоки float32 выровнены для torch.frombuffer)
+//   float32  X[c] [num_samples, x_lengths[c]] для каждого канала, затем Y [num_samples, num_targets_y]
+// Декодирует python_server/preproc/TensorPayload.py
+extern const char kPredictionPayloadMagic[8];
+const uint32_t kPredictionPayloadVersion = 1;
+
+void encodePredictionPayload(const LearningBaseData& data, std::string& payload);
+// Только записи [first_sample, first_sample + num_samples) - шард для одного воркера
+void encodePredictionPayload(const LearningBaseData& data, size_t first_sample, size_t num_samples,
+                             std::string& payload);
+
+// Размер payload для num_samples записей и запись его прямо в чужой буфер (слот общей памяти)
+size_t predictionPayloadSize(const LearningBaseData& data, size_t num_samples);
+void writePredictionPayload(const LearningBaseData& data, size_t first_sample, size_t num_samples, char* out);
+
+#endif // PREDICTION_PAYLOAD_H
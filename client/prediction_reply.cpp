@@ -0,0 +1,222 @@
+#include "prediction_reply.h"
+#include <charconv>
+#include <algorithm>
+
+namespace {
+
+float parseFloat(std::string_view text) {
+    float value = 0.0f;
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (result.ec == std::errc::result_out_of_range) {
+        double wide = 0.0; // вне диапазона float - inf или 0, как при приведении
+        std::from_chars(text.data(), text.data() + text.size(), wide);
+        value = static_cast<float>(wide);
+    }
+    return value;
+}
+
+double parseDouble(std::string_view text) {
+    double value = 0.0;
+    std::from_chars(text.data(), text.data() + text.size(), value);
+    return value;
+}
+
+} // namespace
+
+PredictionReplyDecoder::PredictionReplyDecoder(size_t expected_count)
+    : parser_(*this), expected_count_(expected_count) {
+    reply_.predictions.resize(expected_count);
+}
+
+bool PredictionReplyDecoder::feed(const char* data, size_t size) {
+    if (head_.size() < kMaxHead) {
+        head_.append(data, std::min(size, kMaxHead - head_.size()));
+    }
+    parser_.feed(data, size); // после ошибки разбора остаток тела просто пропускается
+    return true;
+}
+
+void PredictionReplyDecoder::finish() {
+    parser_.finish();
+    finished_ = true;
+}
+
+bool PredictionReplyDecoder::startObject() {
+    ++depth_;
+    return true;
+}
+
+bool PredictionReplyDecoder::endObject() {
+    --depth_;
+    return true;
+}
+
+bool PredictionReplyDecoder::startArray() {
+    if (++depth_ == 1) {
+        return false; // ответ сервера - всегда объект
+    }
+    if (depth_ == 2 && field_ == Field::Predictions) {
+        predictions_depth_ = depth_;
+        has_predictions_ = true;
+    }
+    return true;
+}
+
+bool PredictionReplyDecoder::endArray() {
+    if (depth_ == predictions_depth_) {
+        predictions_depth_ = 0;
+    }
+    --depth_;
+    return true;
+}
+
+bool PredictionReplyDecoder::key(std::string_view name) {
+    if (depth_ == 1) {
+        if (name == "status") {
+            field_ = Field::Status;
+        } else if (name == "message" || (name == "detail" && reply_.message.empty())) {
+            field_ = Field::Message;
+        } else if (name == "output_path") {
+            field_ = Field::OutputPath;
+        } else if (name == "metrics") {
+            field_ = Field::Metrics;
+        } else if (name == "num_samples") {
+            field_ = Field::NumSamples;
+        } else if (name == "num_targets") {
+            field_ = Field::NumTargets;
+        } else if (name == "predictions") {
+            field_ = Field::Predictions;
+        } else {
+            field_ = Field::Other;
+        }
+    } else if (depth_ == 2 && field_ == Field::Metrics) {
+        if (name == "mse") {
+            metric_ = Metric::Mse;
+        } else if (name == "r2") {
+            metric_ = Metric::R2;
+        } else if (name == "test_loss") {
+            metric_ = Metric::TestLoss;
+        } else {
+            metric_ = Metric::Other;
+        }
+    }
+    return true;
+}
+
+bool PredictionReplyDecoder::string(std::string_view value) {
+    if (depth_ == 0) {
+        return false;
+    }
+    if (depth_ == 1) {
+        switch (field_) {
+        case Field::Status:
+            reply_.success = value == "success";
+            break;
+        case Field::Message:
+            reply_.message.assign(value.data(), std::min(value.size(), PredictionReply::kMaxMessage));
+            break;
+        case Field::OutputPath:
+            reply_.output_path.assign(value.data(), value.size());
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+bool PredictionReplyDecoder::number(std::string_view text) {
+    if (predictions_depth_) {
+        // Горячий путь: число сразу в свой слот буфера
+        float value = parseFloat(text);
+        if (received_ < reply_.predictions.size()) {
+            reply_.predictions[received_] = value;
+        } else if (expected_count_ == 0) {
+            reply_.predictions.push_back(value);
+        }
+        ++received_; // лишние не пишутся, но считаются - take() сообщит о несовпадении
+        return true;
+    }
+    if (depth_ == 0) {
+        return false;
+    }
+    if (depth_ == 1) {
+        if (field_ == Field::NumSamples) {
+            reply_.num_samples = static_cast<size_t>(parseDouble(text));
+        } else if (field_ == Field::NumTargets) {
+            reply_.num_targets = static_cast<int>(parseDouble(text));
+        }
+    } else if (depth_ == 2 && field_ == Field::Metrics) {
+        switch (metric_) {
+        case Metric::Mse:
+            reply_.metrics.mse = parseDouble(text);
+            break;
+        case Metric::R2:
+            reply_.metrics.r2 = parseDouble(text);
+            break;
+        case Metric::TestLoss:
+            reply_.metrics.test_loss = parseDouble(text);
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+bool PredictionReplyDecoder::null() {
+    if (predictions_depth_) {
+        return number("NaN");
+    }
+    return depth_ > 0;
+}
+
+bool PredictionReplyDecoder::take(PredictionReply& reply, std::string& error) {
+    if (parser_.failed() || !finished_) {
+        error = "Invalid prediction response (" + (parser_.failed() ? parser_.lastError() : "incomplete body") +
+                "): " + head_;
+        return false;
+    }
+    if (!reply_.success) {
+        error = reply_.message.empty() ? "Prediction failed" : reply_.message;
+        return false;
+    }
+    if (has_predictions_) {
+        if (expected_count_ > 0 && received_ != expected_count_) {
+            error = "Expected " + std::to_string(expected_count_) + " predictions, got " + std::to_string(received_);
+            return false;
+        }
+        if (reply_.num_targets > 0 && received_ != reply_.num_samples * static_cast<size_t>(reply_.num_targets)) {
+            error = "Prediction count " + std::to_string(received_) + " does not match " +
+                    std::to_string(reply_.num_samples) + " x " + std::to_string(reply_.num_targets);
+            return false;
+        }
+    } else {
+        reply_.predictions.clear();
+        reply_.predictions.shrink_to_fit();
+    }
+    reply = std::move(reply_);
+    return true;
+}
+
+bool takePredictionReply(HttpResponse& response, PredictionReply& reply, std::string& error) {
+    if (!response.ok) {
+        error = response.error;
+        return false;
+    }
+    auto* decoder = dynamic_cast<PredictionReplyDecoder*>(response.decoded.get());
+    PredictionReplyDecoder buffered;
+    if (!decoder) {
+        // Тело накоплено целиком (запрос без декодера) - разбор тем же путём
+        buffered.feed(response.body.data(), response.body.size());
+        buffered.finish();
+        decoder = &buffered;
+    }
+    if (decoder->take(reply, error)) {
+        return true;
+    }
+    if (response.status >= 400) {
+        error = "HTTP " + std::to_string(response.status) + ": " + error;
+    }
+    return false;
+}
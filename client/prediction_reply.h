@@ -0,0 +1,75 @@
+#ifndef PREDICTION_REPLY_H
+#define PREDICTION_REPLY_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "async_http_engine.h"
+#include "json_stream.h"
+#include "prediction_output.h"
+
+// Ответ /predict, /predict/binary и /predict/shm. С inline=1 (/predict/binary) сервер не пишет
+// файл, а возвращает предсказания в самом ответе:
+// {"status": "success", "metrics": {...}, "num_samples": P, "num_targets": N, "predictions": [P * N чисел]}
+struct PredictionReply {
+    bool success = false;            // "status": "success"
+    std::string message;             // message или строковый detail FastAPI, не длиннее kMaxMessage
+    std::string output_path;
+    PredictionMetrics metrics;
+    size_t num_samples = 0;
+    int num_targets = 0;
+    std::vector<float> predictions;  // построчно, num_samples * num_targets; пусто - ответ без inline
+
+    static constexpr size_t kMaxMessage = 1024;
+};
+
+// Декодер для HttpRequest::decoder: небольшие поля ложатся в PredictionReply, числа "predictions"
+// пишутся сразу во float-буфер, выделенный заранее, - без копии тела и без дерева jsoncpp.
+// Не-JSON (страница ошибки прокси) приём не прерывает: ошибка запоминается вместе с началом тела
+class PredictionReplyDecoder : public HttpBodyDecoder, private JsonStreamParser::Handler {
+public:
+    // expected_count - сколько чисел ждём (записей * целей); 0 - буфер растёт по мере приёма
+    explicit PredictionReplyDecoder(size_t expected_count = 0);
+
+    bool feed(const char* data, size_t size) override;
+    void finish() override;
+
+    // Разобранный ответ; false - тело не разобрано, сервер вернул ошибку или чисел не столько, сколько ждали
+    bool take(PredictionReply& reply, std::string& error);
+    size_t received() const { return received_; }
+
+private:
+    enum class Field { Other, Status, Message, OutputPath, Metrics, NumSamples, NumTargets, Predictions };
+    enum class Metric { Other, Mse, R2, TestLoss };
+
+    bool startObject() override;
+    bool endObject() override;
+    bool startArray() override;
+    bool endArray() override;
+    bool key(std::string_view name) override;
+    bool string(std::string_view value) override;
+    bool number(std::string_view text) override;
+    bool null() override;
+
+    static const size_t kMaxHead = 512;
+
+    JsonStreamParser parser_;
+    PredictionReply reply_;
+    size_t expected_count_;
+    size_t received_ = 0;
+    bool has_predictions_ = false;
+    bool finished_ = false;
+    std::string head_;               // начало тела - для сообщения, если это не JSON
+
+    int depth_ = 0;
+    Field field_ = Field::Other;     // ключ верхнего уровня, к которому относится значение
+    Metric metric_ = Metric::Other;
+    int predictions_depth_ = 0;      // глубина массива predictions, 0 - вне его
+};
+
+// Ответ попытки целиком: транспорт, разбор тела (декодером из response.decoded или накопленного body),
+// HTTP-код и status
+bool takePredictionReply(HttpResponse& response, PredictionReply& reply, std::string& error);
+
+#endif // PREDICTION_REPLY_H
@@ -0,0 +1,465 @@
+#include "process_supervisor.h"
+#include <algorithm>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+ProcessSupervisor::ProcessSupervisor(Logger* logger) : logger_(logger) {}
+
+ProcessSupervisor::~ProcessSupervisor() {
+    stop(std::chrono::seconds(2));
+    if (monitor_.joinable()) {
+        monitor_.join();
+    }
+}
+
+bool ProcessSupervisor::start(const ProcessOptions& options) {
+    // Наблюдатель прошлого запуска уже завершился (running_ == false), забираем его
+    if (monitor_.joinable() && !isRunning()) {
+        monitor_.join();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return false;
+    }
+
+    options_ = options;
+    stopping_ = false;
+    detaching_ = false;
+    restarts_ = 0;
+    last_exit_code_ = 0;
+
+    if (!spawn()) {
+        return false;
+    }
+    running_ = true;
+    monitor_ = std::thread(&ProcessSupervisor::monitorLoop, this);
+    return true;
+}
+
+bool ProcessSupervisor::waitUntilReady(const ReadinessProbe& probe, std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::chrono::milliseconds delay(50);
+
+    while (true) {
+        if (!isRunning()) {
+            return false; // процесс уже умер - ждать нечего
+        }
+        if (probe()) {
+            return true;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+
+        auto pause = std::min<std::chrono::steady_clock::duration>(delay, deadline - now);
+        std::unique_lock<std::mutex> lock(mutex_);
+        state_cv_.wait_for(lock, pause, [this]() { return !running_; });
+        delay = std::min(delay * 2, std::chrono::milliseconds(1000));
+    }
+}
+
+void ProcessSupervisor::stop(std::chrono::milliseconds grace, const std::function<void()>& graceful_request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        stopping_ = true;
+    }
+    state_cv_.notify_all();
+
+    auto exited = [this]() { return !running_; };
+
+    // 1. Просьба завершиться через API самого процесса
+    if (graceful_request) {
+        graceful_request();
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (state_cv_.wait_for(lock, grace / 2, exited)) {
+            lock.unlock();
+            monitor_.join();
+            return;
+        }
+    }
+
+    // 2. Сигнал завершения (SIGTERM / CTRL_BREAK), 3. принудительное завершение
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        sendTerminate(false);
+        if (!state_cv_.wait_for(lock, graceful_request ? grace / 2 : grace, exited)) {
+            if (logger_) {
+                logger_->warning("Process " + std::to_string(process_id_) + " did not exit in time, killing it");
+            }
+            sendTerminate(true);
+            state_cv_.wait(lock, exited);
+        }
+    }
+    monitor_.join();
+}
+
+bool ProcessSupervisor::detach() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_ || !options_.detached) {
+            return false;
+        }
+    }
+    detaching_ = true;
+    monitor_.join();
+    return true;
+}
+
+bool ProcessSupervisor::isRunning() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+long ProcessSupervisor::pid() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_ ? static_cast<long>(process_id_) : 0;
+}
+
+void ProcessSupervisor::monitorLoop() {
+    for (;;) {
+        int exit_code = 0;
+        bool exited = waitForExit(exit_code);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        closeProcessHandle();
+        if (!exited) {
+            // detach(): процесс работает дальше сам по себе
+            running_ = false;
+            state_cv_.notify_all();
+            return;
+        }
+        last_exit_code_ = exit_code;
+
+        if (stopping_) {
+            running_ = false;
+            state_cv_.notify_all();
+            return;
+        }
+
+        if (logger_) {
+            logger_->warning("Process " + options_.executable + " exited unexpectedly with code " +
+                             std::to_string(exit_code));
+        }
+        if (!options_.restart_on_crash || restarts_ >= options_.max_restarts) {
+            running_ = false;
+            state_cv_.notify_all();
+            return;
+        }
+
+        int attempt = ++restarts_;
+        auto delay = std::min(std::chrono::milliseconds(500) * (1 << std::min(attempt - 1, 5)),
+                              std::chrono::milliseconds(10000));
+        if (state_cv_.wait_for(lock, delay, [this]() { return stopping_; }) || !spawn()) {
+            running_ = false;
+            state_cv_.notify_all();
+            return;
+        }
+        if (logger_) {
+            logger_->info("Process restarted (attempt " + std::to_string(attempt) + "), pid " +
+                          std::to_string(process_id_));
+        }
+    }
+}
+
+void ProcessSupervisor::pumpOutput(intptr_t read_end, std::string log_path) {
+    std::ofstream log;
+    if (!log_path.empty()) {
+        log.open(log_path, std::ios::app | std::ios::binary);
+    }
+
+    char buffer[4096];
+    for (;;) {
+#ifdef _WIN32
+        DWORD count = 0;
+        if (!ReadFile(reinterpret_cast<HANDLE>(read_end), buffer, sizeof(buffer), &count, NULL) || count == 0) {
+            break;
+        }
+#else
+        ssize_t count = read(static_cast<int>(read_end), buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+#endif
+        if (log.is_open()) {
+            log.write(buffer, static_cast<std::streamsize>(count));
+            log.flush();
+        }
+    }
+
+#ifdef _WIN32
+    CloseHandle(reinterpret_cast<HANDLE>(read_end));
+#else
+    close(static_cast<int>(read_end));
+#endif
+}
+
+#ifdef _WIN32
+
+// Аргумент в кавычках по правилам разбора CRT (CommandLineToArgvW): обратные слэши перед
+// кавычкой и перед закрывающей кавычкой удваиваются, сама кавычка экранируется
+static std::string quoteArgument(const std::string& arg) {
+    std::string quoted = "\"";
+    size_t backslashes = 0;
+    for (char c : arg) {
+        if (c == '\\') {
+            ++backslashes;
+            continue;
+        }
+        if (c == '"') {
+            quoted.append(backslashes * 2 + 1, '\\');
+        } else {
+            quoted.append(backslashes, '\\');
+        }
+        backslashes = 0;
+        quoted += c;
+    }
+    quoted.append(backslashes * 2, '\\');
+    quoted += '"';
+    return quoted;
+}
+
+// Имя программы разбирается иначе - до следующей кавычки, без экранирования
+// (кавычек в путях Windows не бывает)
+static std::string quoteExecutable(const std::string& path) {
+    return "\"" + path + "\"";
+}
+
+bool ProcessSupervisor::spawn() {
+    SECURITY_ATTRIBUTES security = {sizeof(SECURITY_ATTRIBUTES), NULL, TRUE};
+    HANDLE read_end = NULL, write_end = NULL;
+    if (options_.detached) {
+        // Демон пишет лог сам: pipe закрылся бы вместе с клиентом
+        write_end = CreateFileA(options_.log_path.empty() ? "NUL" : options_.log_path.c_str(), FILE_APPEND_DATA,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE, &security, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (write_end == INVALID_HANDLE_VALUE) {
+            if (logger_) logger_->error("Cannot open process log " + options_.log_path + ": " +
+                                        std::to_string(GetLastError()));
+            return false;
+        }
+    } else {
+        if (!CreatePipe(&read_end, &write_end, &security, 0)) {
+            if (logger_) logger_->error("CreatePipe failed: " + std::to_string(GetLastError()));
+            return false;
+        }
+        SetHandleInformation(read_end, HANDLE_FLAG_INHERIT, 0);
+    }
+
+    STARTUPINFOA startup = {};
+    startup.cb = sizeof(startup);
+    startup.dwFlags = STARTF_USESTDHANDLES;
+    startup.hStdOutput = write_end;
+    startup.hStdError = write_end;
+    startup.hStdInput = NULL;
+
+    std::string command_line = quoteExecutable(options_.executable);
+    for (const auto& arg : options_.args) {
+        command_line += " " + quoteArgument(arg);
+    }
+
+    // Отдельная группа процессов: CTRL_BREAK уходит только нашему процессу.
+    // Демон ещё и без консоли клиента, чтобы её закрытие его не завершало
+    DWORD flags = CREATE_NEW_PROCESS_GROUP | (options_.detached ? DETACHED_PROCESS : 0);
+    PROCESS_INFORMATION info = {};
+    BOOL created = CreateProcessA(NULL, &command_line[0], NULL, NULL, TRUE, flags, NULL,
+                                  options_.working_dir.empty() ? NULL : options_.working_dir.c_str(),
+                                  &startup, &info);
+    CloseHandle(write_end);
+    if (!created) {
+        if (read_end) {
+            CloseHandle(read_end);
+        }
+        if (logger_) logger_->error("CreateProcess failed: " + std::to_string(GetLastError()));
+        return false;
+    }
+
+    CloseHandle(info.hThread);
+    process_handle_ = info.hProcess;
+    process_id_ = info.dwProcessId;
+    if (read_end) {
+        std::thread(&ProcessSupervisor::pumpOutput, reinterpret_cast<intptr_t>(read_end), options_.log_path).detach();
+    }
+
+    if (logger_) logger_->info("Process started: " + command_line + " (pid " + std::to_string(process_id_) + ")");
+    return true;
+}
+
+bool ProcessSupervisor::waitForExit(int& exit_code) {
+    HANDLE process = static_cast<HANDLE>(process_handle_);
+    // Отпустить можно только демон, его и ждём короткими интервалами
+    while (WaitForSingleObject(process, options_.detached ? 200 : INFINITE) != WAIT_OBJECT_0) {
+        if (detaching_) {
+            return false;
+        }
+    }
+    DWORD code = 0;
+    GetExitCodeProcess(process, &code);
+    exit_code = static_cast<int>(code);
+    return true;
+}
+
+bool ProcessSupervisor::isProcessAlive(long pid) {
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (process == NULL) {
+        return false;
+    }
+    DWORD code = 0;
+    bool alive = GetExitCodeProcess(process, &code) && code == STILL_ACTIVE;
+    CloseHandle(process);
+    return alive;
+}
+
+void ProcessSupervisor::sendTerminate(bool force) {
+    if (!process_handle_) {
+        return;
+    }
+    if (force) {
+        TerminateProcess(static_cast<HANDLE>(process_handle_), 1);
+    } else {
+        GenerateConsoleCtrlEvent(CTRL_BREAK_EVENT, process_id_);
+    }
+}
+
+void ProcessSupervisor::closeProcessHandle() {
+    if (process_handle_) {
+        CloseHandle(static_cast<HANDLE>(process_handle_));
+        process_handle_ = nullptr;
+    }
+}
+
+#else
+
+bool ProcessSupervisor::spawn() {
+    int fds[2] = {-1, -1};
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    if (options_.detached) {
+        // Демон пишет лог сам: pipe закрылся бы вместе с клиентом
+        const char* log_path = options_.log_path.empty() ? "/dev/null" : options_.log_path.c_str();
+        posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, log_path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+    } else {
+        if (pipe(fds) != 0) {
+            posix_spawn_file_actions_destroy(&actions);
+            if (logger_) logger_->error("pipe() failed");
+            return false;
+        }
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+        posix_spawn_file_actions_adddup2(&actions, fds[1], STDERR_FILENO);
+        posix_spawn_file_actions_addclose(&actions, fds[1]);
+    }
+#if (defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))) || defined(__APPLE__)
+    if (!options_.working_dir.empty()) {
+        posix_spawn_file_actions_addchdir_np(&actions, options_.working_dir.c_str());
+    }
+#endif
+
+    // Отдельная группа процессов: сигналы терминала не бьют по серверу напрямую
+    // Демон - в своей сессии (pgid == pid, kill(-pid) по-прежнему бьёт по всей группе)
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+#ifdef POSIX_SPAWN_SETSID
+    posix_spawnattr_setflags(&attributes, options_.detached ? POSIX_SPAWN_SETSID : POSIX_SPAWN_SETPGROUP);
+#else
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+#endif
+    posix_spawnattr_setpgroup(&attributes, 0);
+
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(options_.executable.c_str()));
+    for (const auto& arg : options_.args) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    pid_t child = 0;
+    int result = posix_spawnp(&child, options_.executable.c_str(), &actions, &attributes, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attributes);
+    if (fds[1] >= 0) {
+        close(fds[1]);
+    }
+
+    if (result != 0) {
+        if (fds[0] >= 0) {
+            close(fds[0]);
+        }
+        if (logger_) logger_->error("posix_spawn failed: " + std::to_string(result));
+        return false;
+    }
+
+    process_id_ = child;
+    if (fds[0] >= 0) {
+        std::thread(&ProcessSupervisor::pumpOutput, static_cast<intptr_t>(fds[0]), options_.log_path).detach();
+    }
+
+    if (logger_) logger_->info("Process started: " + options_.executable + " (pid " + std::to_string(child) + ")");
+    return true;
+}
+
+bool ProcessSupervisor::waitForExit(int& exit_code) {
+    // Отпустить можно только демон, его и ждём короткими интервалами
+    int status = 0;
+    for (;;) {
+        pid_t result = waitpid(static_cast<pid_t>(process_id_), &status, options_.detached ? WNOHANG : 0);
+        if (result > 0) {
+            break;
+        }
+        if (result < 0 && errno != EINTR) {
+            exit_code = -1;
+            return true;
+        }
+        if (result == 0) {
+            if (detaching_) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+    }
+    if (WIFEXITED(status)) {
+        exit_code = WEXITSTATUS(status);
+    } else {
+        exit_code = WIFSIGNALED(status) ? 128 + WTERMSIG(status) : -1;
+    }
+    return true;
+}
+
+bool ProcessSupervisor::isProcessAlive(long pid) {
+    // EPERM - процесс чужого пользователя, для нас его всё равно что нет
+    return pid > 0 && kill(static_cast<pid_t>(pid), 0) == 0;
+}
+
+void ProcessSupervisor::sendTerminate(bool force) {
+    // Процесс запущен лидером своей группы: сигнал получают и его потомки
+    if (process_id_ > 0) {
+        kill(-static_cast<pid_t>(process_id_), force ? SIGKILL : SIGTERM);
+    }
+}
+
+void ProcessSupervisor::closeProcessHandle() {}
+
+#endif
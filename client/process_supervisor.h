@@ -0,0 +1,91 @@
+#ifndef PROCESS_SUPERVISOR_H
+#define PROCESS_SUPERVISOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "logger.h"
+
+struct ProcessOptions {
+    std::string executable;
+    std::vector<std::string> args;
+    std::string working_dir;
+    std::string log_path;          // stdout/stderr дочернего процесса через pipe дописываются сюда
+    bool restart_on_crash = true;
+    int max_restarts = 5;
+    // Процесс переживает клиента (сервер-демон): вывод сразу в log_path без pipe,
+    // своя сессия без консоли клиента; можно отпустить через detach()
+    bool detached = false;
+};
+
+// Запуск и сопровождение одного дочернего процесса (CreateProcess / posix_spawn):
+// захват вывода, ожидание готовности с экспоненциальной паузой, мягкая и затем
+// принудительная остановка только своего процесса, перезапуск после падения.
+class ProcessSupervisor {
+public:
+    using ReadinessProbe = std::function<bool()>;
+
+    explicit ProcessSupervisor(Logger* logger = nullptr);
+    ~ProcessSupervisor(); // останавливает процесс, если он ещё работает
+
+    ProcessSupervisor(const ProcessSupervisor&) = delete;
+    ProcessSupervisor& operator=(const ProcessSupervisor&) = delete;
+
+    bool start(const ProcessOptions& options);
+
+    // Опрос probe с паузами 50 мс, 100 мс, ... (не больше 1 с) до timeout
+    bool waitUntilReady(const ReadinessProbe& probe, std::chrono::milliseconds timeout);
+
+    // graceful_request (например POST /shutdown) или сигнал завершения, затем через grace - kill
+    void stop(std::chrono::milliseconds grace, const std::function<void()>& graceful_request = {});
+
+    // Перестаёт сопровождать процесс, не останавливая его; только для options.detached
+    bool detach();
+
+    // Жив ли процесс pid, доступный текущему пользователю (например, из файла блокировки)
+    static bool isProcessAlive(long pid);
+
+    bool isRunning() const;
+    long pid() const;
+    int restartCount() const { return restarts_.load(); }
+    int lastExitCode() const { return last_exit_code_.load(); }
+
+private:
+    Logger* logger_;
+    ProcessOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable state_cv_;
+    bool running_ = false;
+    bool stopping_ = false;
+    std::atomic<bool> detaching_{false};
+    std::atomic<int> restarts_{0};
+    std::atomic<int> last_exit_code_{0};
+
+#ifdef _WIN32
+    void* process_handle_ = nullptr;
+    unsigned long process_id_ = 0;
+#else
+    long process_id_ = 0;
+#endif
+
+    std::thread monitor_;
+
+    bool spawn();                 // под mutex_
+    // Блокирует поток наблюдателя до выхода процесса; false - процесс отпущен через detach()
+    bool waitForExit(int& exit_code);
+    void sendTerminate(bool force);
+    void monitorLoop();
+    // Отдельный поток на каждый запуск; не держит ссылок на supervisor, т.к. pipe
+    // может оставаться открытым у потомков сервера и после его завершения
+    static void pumpOutput(intptr_t read_end, std::string log_path);
+    void closeProcessHandle();
+};
+
+#endif // PROCESS_SUPERVISOR_H
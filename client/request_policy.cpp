@@ -0,0 +1,59 @@
+#include "request_policy.h"
+#include <algorithm>
+#include <random>
+
+RequestDeadline::RequestDeadline(long timeout_ms)
+    : start_(std::chrono::steady_clock::now()), timeout_ms_(timeout_ms) {}
+
+long RequestDeadline::elapsedMs() const {
+    return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_).count());
+}
+
+long RequestDeadline::remainingMs() const {
+    if (unlimited()) {
+        return -1;
+    }
+    return std::max(0L, timeout_ms_ - elapsedMs());
+}
+
+long RequestDeadline::attemptTimeoutMs(const RequestPolicy& policy, std::chrono::milliseconds delay) const {
+    long timeout = 0;
+    if (!unlimited()) {
+        // 1 мс вместо 0: у curl 0 значит "без ограничения"
+        timeout = std::max(1L, remainingMs() - static_cast<long>(delay.count()));
+    }
+    if (policy.attempt_timeout_ms > 0 && (timeout == 0 || policy.attempt_timeout_ms < timeout)) {
+        timeout = policy.attempt_timeout_ms;
+    }
+    return timeout;
+}
+
+bool isRetryable(const HttpResponse& response, bool idempotent) {
+    if (response.ok) {
+        return idempotent && (response.status == 502 || response.status == 503 || response.status == 504);
+    }
+    if (response.result == CURLE_ABORTED_BY_CALLBACK || response.result == CURLE_WRITE_ERROR) {
+        return false; // запрос снят самим клиентом
+    }
+    // Соединение не установилось - сервер запроса не видел, повторять можно любой
+    return idempotent || response.result == CURLE_COULDNT_CONNECT || response.result == CURLE_COULDNT_RESOLVE_HOST;
+}
+
+bool nextAttempt(const RequestPolicy& policy, const RequestDeadline& deadline, int attempts_made,
+                 const HttpResponse& last, std::chrono::milliseconds& delay) {
+    if (attempts_made >= policy.max_attempts || !isRetryable(last, policy.idempotent)) {
+        return false;
+    }
+
+    // Полный jitter: повторы разных клиентов не приходят на сервер одной волной
+    long cap = policy.backoff_ms;
+    for (int k = 1; k < attempts_made && cap < policy.backoff_max_ms; ++k) {
+        cap *= 2;
+    }
+    cap = std::max(0L, std::min(cap, policy.backoff_max_ms));
+    thread_local std::mt19937 generator(std::random_device{}());
+    delay = std::chrono::milliseconds(std::uniform_int_distribution<long>(0, cap)(generator));
+
+    return deadline.unlimited() || deadline.remainingMs() > delay.count();
+}
@@ -0,0 +1,46 @@
+#ifndef REQUEST_POLICY_H
+#define REQUEST_POLICY_H
+
+#include <chrono>
+#include "async_http_engine.h"
+
+// Политика вызова endpoint-а: срок на весь вызов вместе с повторами, повторы с
+// экспоненциальной паузой и полным jitter, дубль (hedging) идемпотентного запроса
+// на другой воркер, если основной долго не отвечает - берётся первый ответ.
+// Неидемпотентные запросы повторяются, только если соединение не установилось
+// (запрос точно не дошёл до сервера).
+struct RequestPolicy {
+    long timeout_ms = 5000;          // срок вызова целиком; 0 - без ограничения
+    long attempt_timeout_ms = 0;     // срок одной попытки; 0 - весь остаток срока вызова
+    int max_attempts = 1;            // всего попыток, 1 - без повторов (дубль не считается)
+    long backoff_ms = 100;           // пауза перед k-м повтором - случайная из [0, min(backoff_max_ms, backoff_ms * 2^k)]
+    long backoff_max_ms = 2000;
+    long hedge_after_ms = 0;         // > 0 - дубль на другой воркер, если ответа нет за это время
+    bool idempotent = false;         // повтор после отправки и дубль допустимы
+};
+
+// Срок одного вызова (всех его попыток)
+class RequestDeadline {
+public:
+    explicit RequestDeadline(long timeout_ms);
+
+    bool unlimited() const { return timeout_ms_ <= 0; }
+    long elapsedMs() const;
+    long remainingMs() const;        // -1 - срока нет
+    // CURLOPT_TIMEOUT_MS попытки, которая начнётся через delay; 0 - без ограничения
+    long attemptTimeoutMs(const RequestPolicy& policy, std::chrono::milliseconds delay) const;
+
+private:
+    std::chrono::steady_clock::time_point start_;
+    long timeout_ms_;
+};
+
+// Ответ, после которого имеет смысл повторить: ошибка транспорта или 502/503/504
+bool isRetryable(const HttpResponse& response, bool idempotent);
+
+// Нужен ли ещё один заход после неудачной попытки attempts_made и через сколько;
+// повтор не планируется, если пауза съест остаток срока
+bool nextAttempt(const RequestPolicy& policy, const RequestDeadline& deadline, int attempts_made,
+                 const HttpResponse& last, std::chrono::milliseconds& delay);
+
+#endif // REQUEST_POLICY_H
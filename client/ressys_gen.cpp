@@ -0,0 +1,90 @@
+// ResSysGen: синтетическая обучающая база по той же строке конфигурации, что вводится
+// в ResSysML при загрузке базы. Пишет <out>/<name>.txt и <out>/Configs/<name>.txt -
+// базу можно загрузить через меню как обычную или положить прямо в каталог LearningBase.
+// Использование: ResSysGen [--out <каталог>] [--seed <n>] [--threads <n>]
+//                          name num_samples num_targets_y y_precision... num_features_x x_length...
+#include "learning_base_config.h"
+#include "learning_base_generator.h"
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+static void printUsage() {
+    std::cout << "Usage: ResSysGen [--out <dir>=.] [--seed <n>=42] [--threads <n>=0 (all cores)] <config>" << std::endl;
+    std::cout << "Config: name num_samples num_targets_y y_precision1 ... num_features_x x_length1 ..." << std::endl;
+    std::cout << "Example: ResSysGen --out data Base123 100000 2 0.01 0.05 3 256 128 64" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::string out_dir = ".";
+    uint64_t seed = 42;
+    unsigned threads = 0;
+    std::string spec;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "-h" || arg == "--help") {
+                printUsage();
+                return 0;
+            }
+            if ((arg == "--out" || arg == "--seed" || arg == "--threads") && i + 1 < argc) {
+                std::string value = argv[++i];
+                if (arg == "--out") {
+                    out_dir = value;
+                } else if (arg == "--seed") {
+                    seed = std::stoull(value);
+                } else {
+                    threads = static_cast<unsigned>(std::stoul(value));
+                }
+            } else {
+                // Конфиг можно передать одной строкой в кавычках или отдельными аргументами
+                spec += (spec.empty() ? "" : " ") + arg;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: invalid option value (" << e.what() << ")" << std::endl;
+        return 1;
+    }
+
+    LearningBaseConfig config;
+    std::string error;
+    if (spec.empty()) {
+        printUsage();
+        return 1;
+    }
+    if (!parseLearningBaseConfig(spec, config, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    std::error_code ec;
+    fs::path config_dir = fs::path(out_dir) / "Configs";
+    fs::create_directories(config_dir, ec);
+    if (ec) {
+        std::cerr << "Error: cannot create " << config_dir.string() << ": " << ec.message() << std::endl;
+        return 1;
+    }
+    std::string base_path = (fs::path(out_dir) / (config.name + ".txt")).string();
+    std::string config_path = (config_dir / (config.name + ".txt")).string();
+
+    LearningBaseGenerator generator(seed, threads);
+    LearningBaseGeneratorStats stats;
+    if (!generator.generate(config, base_path, &stats)) {
+        std::cerr << "Error: " << generator.lastError() << std::endl;
+        return 1;
+    }
+    if (!writeLearningBaseConfig(config_path, config, error)) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    double mb = static_cast<double>(stats.bytes_written) / (1024.0 * 1024.0);
+    std::cout << "Learning base: " << base_path << " (" << stats.num_samples << " records, " << mb << " MB)" << std::endl;
+    std::cout << "Config: " << config_path << std::endl;
+    std::cout << "Generated in " << stats.elapsed_ms << " ms, " << mb / (stats.elapsed_ms / 1000.0) << " MB/s ("
+              << generator.numThreads() << " threads, seed " << seed << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "server_daemon.h"
+#include "process_supervisor.h"
+#include <fstream>
+#include <sstream>
+#include <json/json.h>
+
+const char kServerVersion[] = "1.4";
+
+bool readServerLock(const std::string& path, ServerLockInfo& info, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "No server lock file: " + path;
+        return false;
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+
+    Json::Value lock;
+    Json::Reader reader;
+    if (!reader.parse(content.str(), lock) || !lock.isObject()) {
+        error = "Malformed server lock file: " + path;
+        return false;
+    }
+    info.pid = static_cast<long>(lock.get("pid", 0).asInt64());
+    info.port = lock.get("port", 0).asInt();
+    info.socket_path = lock.get("uds", "").asString();
+    info.version = lock.get("version", "").asString();
+    info.started = lock.get("started", "").asString();
+    return true;
+}
+
+bool verifyServerDaemon(HttpClient& client, const ServerLockInfo& lock, int port, const std::string& socket_path,
+                        std::string& error) {
+    if (!ProcessSupervisor::isProcessAlive(lock.pid)) {
+        error = "Server daemon " + std::to_string(lock.pid) + " is not running";
+        return false;
+    }
+    if (lock.version != kServerVersion) {
+        error = "Server daemon version " + lock.version + " does not match client " + kServerVersion;
+        return false;
+    }
+    if (lock.socket_path != socket_path || (socket_path.empty() && lock.port != port)) {
+        error = "Server daemon listens on " + (lock.socket_path.empty() ? "port " + std::to_string(lock.port)
+                                                                         : lock.socket_path);
+        return false;
+    }
+
+    Json::Value health;
+    Json::Reader reader;
+    if (!reader.parse(client.get("/health"), health) || health.get("status", "").asString() != "healthy") {
+        error = "Server daemon " + std::to_string(lock.pid) + " does not answer /health";
+        return false;
+    }
+    if (static_cast<long>(health.get("pid", 0).asInt64()) != lock.pid ||
+        health.get("version", "").asString() != lock.version) {
+        error = "Another process answers on the server address (pid " + health.get("pid", 0).asString() + ")";
+        return false;
+    }
+    return true;
+}
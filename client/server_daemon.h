@@ -0,0 +1,29 @@
+#ifndef SERVER_DAEMON_H
+#define SERVER_DAEMON_H
+
+#include <string>
+#include "http_client.h"
+
+// Версия протокола клиент-сервер, должна совпадать с SERVER_VERSION в python_server/config.py:
+// демон другой версии (остался от прошлой установки) не переиспользуется
+extern const char kServerVersion[];
+
+// Файл блокировки сервера-демона (python_server/main.py --daemon --lock-file ...):
+// JSON {"pid", "port", "uds", "version", "started"}, пишет и удаляет сам сервер
+struct ServerLockInfo {
+    long pid = 0;
+    int port = 0;
+    std::string socket_path;
+    std::string version;
+    std::string started;
+};
+
+bool readServerLock(const std::string& path, ServerLockInfo& info, std::string& error);
+
+// Можно ли подключиться к демону из файла блокировки: процесс жив и принадлежит
+// пользователю, слушает тот же адрес, версия совпадает, а /health отвечает
+// с тем же pid и версией (а не посторонний процесс на порту)
+bool verifyServerDaemon(HttpClient& client, const ServerLockInfo& lock, int port, const std::string& socket_path,
+                        std::string& error);
+
+#endif // SERVER_DAEMON_H
@@ -0,0 +1,147 @@
+#include "sharded_predictor.h"
+#include "prediction_payload.h"
+#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Имя шарда только для имени файла результатов на сервере: data.part2of4.txt
+std::string shardInputName(const std::string& file_path, size_t shard, size_t shards) {
+    fs::path path(file_path);
+    std::string name = path.stem().string() + ".part" + std::to_string(shard + 1) + "of" + std::to_string(shards) +
+                       path.extension().string();
+    return (path.parent_path() / name).string();
+}
+
+} // namespace
+
+ShardedPredictor::ShardedPredictor(std::vector<HttpClient*> workers, Logger& logger, size_t min_shard_samples)
+    : workers_(std::move(workers)), logger_(logger), min_shard_samples_(min_shard_samples > 0 ? min_shard_samples : 1) {}
+
+size_t ShardedPredictor::shardCount(size_t num_samples) const {
+    size_t by_size = (num_samples + min_shard_samples_ - 1) / min_shard_samples_;
+    size_t shards = std::min(workers_.size(), by_size);
+    return shards > 0 ? shards : 1;
+}
+
+bool ShardedPredictor::predict(const LearningBaseData& data, const std::string& file_path,
+                               const std::string& model_name, const std::string& base_name,
+                               const std::string& output_path, PredictionMetrics& metrics, std::string& error) {
+    const size_t num_samples = static_cast<size_t>(data.num_samples);
+    const size_t shards = shardCount(num_samples);
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<size_t> first(shards + 1);
+    for (size_t k = 0; k <= shards; ++k) {
+        first[k] = num_samples * k / shards;
+    }
+
+    struct Pending {
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t remaining = 0;
+        std::vector<HttpResponse> responses;
+    };
+    auto pending = std::make_shared<Pending>();
+    pending->remaining = shards;
+    pending->responses.resize(shards);
+
+    for (size_t k = 0; k < shards; ++k) {
+        std::string payload;
+        size_t count = first[k + 1] - first[k];
+        encodePredictionPayload(data, first[k], count, payload);
+        auto done = [pending, k](HttpResponse&& response) {
+            std::lock_guard<std::mutex> lock(pending->mutex);
+            pending->responses[k] = std::move(response);
+            if (--pending->remaining == 0) {
+                pending->done.notify_all();
+            }
+        };
+        if (inline_predictions_) {
+            workers_[k]->predictWithModelBinaryInlineAsync(shardInputName(file_path, k, shards), model_name, base_name,
+                                                           std::move(payload), count * data.num_targets_y, done);
+        } else {
+            workers_[k]->predictWithModelBinaryAsync(shardInputName(file_path, k, shards), model_name, base_name,
+                                                     std::move(payload), done);
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(pending->mutex);
+        pending->done.wait(lock, [&]() { return pending->remaining == 0; });
+    }
+
+    // Склейка: предсказания шарда k встают на его диапазон записей
+    std::vector<float> predictions(num_samples * data.num_targets_y);
+    std::vector<std::string> shard_outputs;
+    double weighted_test_loss = 0.0;
+    bool ok = true;
+
+    // Первая ошибка шарда становится ошибкой всего предсказания
+    auto shardFailed = [&](size_t k, const std::string& shard_error) {
+        if (ok) {
+            error = "Shard " + std::to_string(k + 1) + "/" + std::to_string(shards) + ": " + shard_error;
+            ok = false;
+        }
+    };
+
+    // Все шарды разбираются до конца даже после ошибки, чтобы удалить файлы успешных
+    for (size_t k = 0; k < shards; ++k) {
+        PredictionReply reply;
+        std::string shard_error;
+        if (!takePredictionReply(pending->responses[k], reply, shard_error)) {
+            shardFailed(k, shard_error);
+            continue;
+        }
+        if (!reply.output_path.empty()) {
+            shard_outputs.push_back(reply.output_path);
+        }
+
+        if (!ok) {
+            continue; // склеивать уже нечего
+        }
+        size_t count = first[k + 1] - first[k];
+        if (reply.predictions.empty() &&
+            !readPredictionOutput(reply.output_path, data.num_targets_y, reply.predictions, shard_error)) {
+            shardFailed(k, shard_error);
+            continue;
+        }
+        if (reply.predictions.size() != count * data.num_targets_y) {
+            shardFailed(k, "expected " + std::to_string(count) + " predictions, got " +
+                               std::to_string(reply.predictions.size() / data.num_targets_y));
+            continue;
+        }
+        std::copy(reply.predictions.begin(), reply.predictions.end(),
+                  predictions.begin() + first[k] * data.num_targets_y);
+        weighted_test_loss += reply.metrics.test_loss * count;
+    }
+
+    for (const auto& shard_output : shard_outputs) {
+        std::error_code ec;
+        fs::remove(shard_output, ec);
+    }
+    if (!ok) {
+        return false;
+    }
+
+    metrics = computePredictionMetrics(predictions.data(), data.y.data(), num_samples, data.num_targets_y);
+    metrics.test_loss = weighted_test_loss / static_cast<double>(num_samples);
+
+    if (!writePredictionOutput(output_path, file_path, model_name, base_name, metrics, predictions.data(),
+                               data.y.data(), num_samples, data.num_targets_y)) {
+        error = "Failed to write prediction output: " + output_path;
+        return false;
+    }
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    logger_.info("Sharded prediction: " + std::to_string(num_samples) + " records in " + std::to_string(shards) +
+                 " shards, " + std::to_string(elapsed_ms) + " ms");
+    return true;
+}
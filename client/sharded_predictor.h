@@ -0,0 +1,36 @@
+#ifndef SHARDED_PREDICTOR_H
+#define SHARDED_PREDICTOR_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "http_client.h"
+#include "learning_base_parser.h"
+#include "logger.h"
+#include "prediction_output.h"
+
+// Предсказание большого входа на нескольких серверах-воркерах: записи делятся
+// на непрерывные диапазоны, шарды параллельно уходят на /predict/binary разных
+// воркеров, предсказания шардов (из ответов или файлов результатов) склеиваются в один
+// файл, а MSE и R² пересчитываются по всему входу (R² не складывается из R² частей).
+class ShardedPredictor {
+public:
+    ShardedPredictor(std::vector<HttpClient*> workers, Logger& logger, size_t min_shard_samples = 256);
+
+    // Сколько шардов получит вход: не больше воркеров и не мельче min_shard_samples
+    size_t shardCount(size_t num_samples) const;
+    // true - предсказания шардов приходят в ответах (inline=1), без файлов на сервере
+    void setInlinePredictions(bool enabled) { inline_predictions_ = enabled; }
+
+    bool predict(const LearningBaseData& data, const std::string& file_path, const std::string& model_name,
+                 const std::string& base_name, const std::string& output_path, PredictionMetrics& metrics,
+                 std::string& error);
+
+private:
+    std::vector<HttpClient*> workers_;
+    Logger& logger_;
+    size_t min_shard_samples_;
+    bool inline_predictions_ = false;
+};
+
+#endif // SHARDED_PREDICTOR_H
@@ -0,0 +1,242 @@
+#include "shared_tensor_ring.h"
+#include <cstring>
+#include <json/json.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+const char kShmRingMagic[8] = {'R', 'S', 'S', 'H', 'M', 'R', 'N', 'G'};
+
+namespace {
+
+const size_t kSlotAlignment = 64;
+
+size_t alignUp(size_t value) {
+    return (value + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+}
+
+} // namespace
+
+SharedTensorRing::SharedTensorRing(Logger* logger) : logger_(logger) {}
+
+SharedTensorRing::~SharedTensorRing() {
+    close();
+}
+
+std::string SharedTensorRing::defaultName() {
+#ifdef _WIN32
+    unsigned long pid = GetCurrentProcessId();
+#else
+    unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+    return "ressys_" + std::to_string(pid);
+}
+
+bool SharedTensorRing::create(const std::string& name, size_t slot_count, size_t slot_bytes) {
+    close();
+    slot_bytes = alignUp(slot_bytes);
+    uint64_t total = kShmHeaderSize + static_cast<uint64_t>(slot_count) * slot_bytes;
+    if (slot_count == 0 || !mapSegment(name, total)) {
+        if (slot_count == 0) {
+            last_error_ = "Shared memory ring needs at least one slot";
+        }
+        return false;
+    }
+
+    name_ = name;
+    slot_count_ = slot_count;
+    slot_bytes_ = slot_bytes;
+    total_bytes_ = static_cast<size_t>(total);
+
+    std::memcpy(base_, kShmRingMagic, sizeof(kShmRingMagic));
+    uint32_t version = kShmRingVersion;
+    uint32_t count = static_cast<uint32_t>(slot_count);
+    uint64_t bytes = slot_bytes;
+    std::memcpy(base_ + 8, &version, sizeof(version));
+    std::memcpy(base_ + 12, &count, sizeof(count));
+    std::memcpy(base_ + 16, &bytes, sizeof(bytes));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_slots_.clear();
+        retired_slots_ = 0;
+        for (size_t i = slot_count; i > 0; --i) {
+            free_slots_.push_back(i - 1);
+        }
+    }
+
+    if (logger_) {
+        logger_->info("Shared memory ring " + name + ": " + std::to_string(slot_count) + " slots x " +
+                      std::to_string(slot_bytes >> 20) + " MB");
+    }
+    return true;
+}
+
+#ifdef _WIN32
+
+bool SharedTensorRing::mapSegment(const std::string& name, uint64_t total) {
+    // Без файла на диске: память из файла подкачки, имя видно в сессии пользователя
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                        static_cast<DWORD>(total >> 32), static_cast<DWORD>(total & 0xFFFFFFFF),
+                                        name.c_str());
+    if (mapping == NULL) {
+        last_error_ = "CreateFileMapping failed (error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        CloseHandle(mapping);
+        last_error_ = "Shared memory segment already exists: " + name;
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (view == NULL) {
+        last_error_ = "MapViewOfFile failed (error " + std::to_string(GetLastError()) + ")";
+        CloseHandle(mapping);
+        return false;
+    }
+    mapping_handle_ = mapping;
+    base_ = static_cast<char*>(view);
+    return true;
+}
+
+void SharedTensorRing::unmapSegment(char* base) {
+    UnmapViewOfFile(base);
+    CloseHandle(static_cast<HANDLE>(mapping_handle_));
+    mapping_handle_ = nullptr;
+}
+
+#else
+
+bool SharedTensorRing::mapSegment(const std::string& name, uint64_t total) {
+    std::string shm_name = "/" + name;
+    int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        last_error_ = "shm_open failed: " + std::string(std::strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+        last_error_ = "ftruncate failed: " + std::string(std::strerror(errno));
+        ::close(fd);
+        shm_unlink(shm_name.c_str());
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(total), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        last_error_ = "mmap failed: " + std::string(std::strerror(errno));
+        ::close(fd);
+        shm_unlink(shm_name.c_str());
+        return false;
+    }
+    fd_ = fd;
+    base_ = static_cast<char*>(view);
+    return true;
+}
+
+void SharedTensorRing::unmapSegment(char* base) {
+    munmap(base, total_bytes_);
+    ::close(fd_);
+    fd_ = -1;
+    // Отображение сервера живёт, пока он его держит; имя больше никому не понадобится
+    shm_unlink(("/" + name_).c_str());
+}
+
+#endif
+
+void SharedTensorRing::close() {
+    // base_ обнуляется под замком до пробуждения: ждущие acquire увидят закрытие и вернут false
+    char* base;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        base = base_;
+        base_ = nullptr;
+        free_slots_.clear();
+    }
+    slot_freed_.notify_all();
+
+    if (!base) {
+        return;
+    }
+    unmapSegment(base);
+    slot_count_ = 0;
+    slot_bytes_ = 0;
+    total_bytes_ = 0;
+}
+
+bool SharedTensorRing::fits(size_t request_size, size_t reply_count) const {
+    return alignUp(request_size) + reply_count * sizeof(float) <= slot_bytes_;
+}
+
+ShmSlotRequest SharedTensorRing::layout(const Slot& slot, size_t request_size, size_t reply_count) const {
+    ShmSlotRequest request;
+    request.request_offset = slot.offset;
+    request.request_size = request_size;
+    request.reply_offset = slot.offset + alignUp(request_size);
+    request.reply_count = reply_count;
+    return request;
+}
+
+bool SharedTensorRing::acquire(Slot& slot) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    slot_freed_.wait(lock, [this]() { return !free_slots_.empty() || !base_ || retired_slots_ == slot_count_; });
+    if (!base_ || free_slots_.empty()) {
+        return false;
+    }
+    slot.index = free_slots_.back();
+    free_slots_.pop_back();
+    slot.offset = kShmHeaderSize + slot.index * slot_bytes_;
+    slot.data = base_ + slot.offset;
+    return true;
+}
+
+void SharedTensorRing::release(const Slot& slot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!base_) {
+            return;
+        }
+        free_slots_.push_back(slot.index);
+    }
+    slot_freed_.notify_one();
+}
+
+void SharedTensorRing::retire(const Slot& slot) {
+    size_t retired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!base_) {
+            return;
+        }
+        retired = ++retired_slots_;
+    }
+    if (logger_) {
+        logger_->warning("Shared memory slot " + std::to_string(slot.index) + " retired (" + std::to_string(retired) +
+                         "/" + std::to_string(slot_count_) + "): the server may still write into it");
+    }
+    // Все слоты выведены - ждущие acquire должны вернуть false
+    slot_freed_.notify_all();
+}
+
+std::string shmPredictRequestJson(const std::string& segment, const ShmSlotRequest& request,
+                                  const std::string& file_path, const std::string& model_name,
+                                  const std::string& base_name) {
+    Json::Value body;
+    body["segment"] = segment;
+    body["request_offset"] = static_cast<Json::UInt64>(request.request_offset);
+    body["request_size"] = static_cast<Json::UInt64>(request.request_size);
+    body["reply_offset"] = static_cast<Json::UInt64>(request.reply_offset);
+    body["reply_count"] = static_cast<Json::UInt64>(request.reply_count);
+    body["file_path"] = file_path;
+    body["model_name"] = model_name;
+    body["base_name"] = base_name;
+
+    Json::StreamWriterBuilder writer;
+    return Json::writeString(writer, body);
+}
@@ -0,0 +1,96 @@
+#ifndef SHARED_TENSOR_RING_H
+#define SHARED_TENSOR_RING_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "logger.h"
+
+// Сегмент общей памяти (CreateFileMapping / shm_open) с кольцом слотов для
+// предсказаний: клиент пишет вход в формате prediction_payload.h прямо в слот,
+// по HTTP уходит только описание слота (POST /predict/shm), сервер читает
+// тензоры из того же сегмента без копий и пишет предсказания в область ответа.
+//   заголовок kShmHeaderSize байт: char magic[8] = "RSSHMRNG", uint32 version, slot_count, uint64 slot_bytes
+//   слоты по slot_bytes: [вход | нули до 64 | ответ float32 [num_samples, num_targets_y]]
+// Сервер подключается по имени: python_server/preproc/SharedTensorRing.py
+extern const char kShmRingMagic[8];
+const uint32_t kShmRingVersion = 1;
+const size_t kShmHeaderSize = 64;
+
+// Где в сегменте лежат вход и ответ одного запроса (смещения от начала сегмента)
+struct ShmSlotRequest {
+    size_t request_offset = 0;
+    size_t request_size = 0;
+    size_t reply_offset = 0;
+    size_t reply_count = 0; // float32 значений
+};
+
+class SharedTensorRing {
+public:
+    struct Slot {
+        size_t index = 0;
+        size_t offset = 0;    // от начала сегмента
+        char* data = nullptr;
+    };
+
+    explicit SharedTensorRing(Logger* logger = nullptr);
+    ~SharedTensorRing();
+
+    SharedTensorRing(const SharedTensorRing&) = delete;
+    SharedTensorRing& operator=(const SharedTensorRing&) = delete;
+
+    // Имя по умолчанию уникально для процесса клиента: ressys_<pid>
+    static std::string defaultName();
+
+    bool create(const std::string& name, size_t slot_count, size_t slot_bytes);
+    void close();
+
+    bool isOpen() const { return base_ != nullptr; }
+    const std::string& name() const { return name_; }
+    size_t slotBytes() const { return slot_bytes_; }
+    size_t slotCount() const { return slot_count_; }
+    const std::string& lastError() const { return last_error_; }
+
+    // Помещаются ли в один слот вход request_size байт и ответ reply_count float32
+    bool fits(size_t request_size, size_t reply_count) const;
+    ShmSlotRequest layout(const Slot& slot, size_t request_size, size_t reply_count) const;
+
+    // Ждёт свободный слот; false - сегмент закрыт или все слоты выведены из оборота
+    bool acquire(Slot& slot);
+    // Слот после окончательного ответа сервера
+    void release(const Slot& slot);
+    // Слот, в который сервер, возможно, ещё пишет (таймаут, обрыв, повтор): больше не выдаётся
+    void retire(const Slot& slot);
+
+private:
+    Logger* logger_;
+    std::string name_;
+    size_t slot_count_ = 0;
+    size_t slot_bytes_ = 0;
+    size_t total_bytes_ = 0;
+    char* base_ = nullptr;
+    std::string last_error_;
+#ifdef _WIN32
+    void* mapping_handle_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+
+    bool mapSegment(const std::string& name, uint64_t total);
+    void unmapSegment(char* base);
+
+    std::mutex mutex_;
+    std::condition_variable slot_freed_;
+    std::vector<size_t> free_slots_;
+    size_t retired_slots_ = 0;
+};
+
+// Тело POST /predict/shm
+std::string shmPredictRequestJson(const std::string& segment, const ShmSlotRequest& request,
+                                  const std::string& file_path, const std::string& model_name,
+                                  const std::string& base_name);
+
+#endif // SHARED_TENSOR_RING_H
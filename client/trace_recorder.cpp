@@ -0,0 +1,321 @@
+#include "trace_recorder.h"
+#include "http_metrics.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <json/json.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+const char* const TraceRecorder::kTraceHeader = "X-Trace-Id";
+const char* const TraceRecorder::kSpansHeader = "X-Trace-Spans";
+
+namespace {
+
+thread_local std::string t_trace_id; // trace внешнего TraceSpan потока
+
+int64_t epochMicros(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+}
+
+uint32_t currentPid() {
+#ifdef _WIN32
+    return static_cast<uint32_t>(GetCurrentProcessId());
+#else
+    return static_cast<uint32_t>(getpid());
+#endif
+}
+
+// Короткие номера потоков в порядке первого события - читать их проще, чем системные id
+uint32_t currentTid() {
+    static std::atomic<uint32_t> next_tid{1};
+    thread_local uint32_t tid = next_tid.fetch_add(1);
+    return tid;
+}
+
+int64_t phaseMicros(CURL* easy, CURLINFO info) {
+    curl_off_t value = 0;
+    curl_easy_getinfo(easy, info, &value);
+    return value > 0 ? static_cast<int64_t>(value) : 0;
+}
+
+void appendJsonString(std::string& out, const std::string& value) {
+    out += '"';
+    for (unsigned char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+    out += '"';
+}
+
+} // namespace
+
+TraceRecorder& TraceRecorder::instance() {
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+bool TraceRecorder::open(const std::string& path, std::string& error) {
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    std::ofstream probe(path, std::ios::trunc);
+    if (!probe.is_open()) {
+        error = "Cannot create file: " + path;
+        return false;
+    }
+    probe << "{\"traceEvents\":[]}\n";
+    probe.close();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    path_ = path;
+    pid_ = currentPid();
+    enabled_.store(true, std::memory_order_release);
+    return true;
+}
+
+std::string TraceRecorder::newTraceId() {
+    thread_local std::mt19937_64 generator(std::random_device{}() ^
+                                           static_cast<uint64_t>(epochMicros(std::chrono::system_clock::now())));
+    char id[17];
+    std::snprintf(id, sizeof(id), "%016llx", static_cast<unsigned long long>(generator()));
+    return id;
+}
+
+const std::string& TraceRecorder::currentTraceId() {
+    return t_trace_id;
+}
+
+std::string TraceRecorder::requestTraceId() const {
+    return t_trace_id.empty() ? newTraceId() : t_trace_id;
+}
+
+curl_slist* TraceRecorder::withTraceHeader(const curl_slist* headers, const std::string& trace_id) {
+    curl_slist* copy = nullptr;
+    for (const curl_slist* item = headers; item; item = item->next) {
+        copy = curl_slist_append(copy, item->data);
+    }
+    return curl_slist_append(copy, (std::string(kTraceHeader) + ": " + trace_id).c_str());
+}
+
+size_t TraceRecorder::receiveHeader(char* buffer, size_t size, size_t nitems, void* spans_header) {
+    const size_t total = size * nitems;
+    const size_t name_length = std::strlen(kSpansHeader);
+    if (total > name_length && buffer[name_length] == ':') {
+        bool match = true;
+        for (size_t i = 0; i < name_length && match; ++i) {
+            match = std::tolower(static_cast<unsigned char>(buffer[i])) ==
+                    std::tolower(static_cast<unsigned char>(kSpansHeader[i]));
+        }
+        if (match) {
+            size_t begin = name_length + 1;
+            size_t end = total;
+            while (begin < end && std::isspace(static_cast<unsigned char>(buffer[begin]))) {
+                ++begin;
+            }
+            while (end > begin && std::isspace(static_cast<unsigned char>(buffer[end - 1]))) {
+                --end;
+            }
+            static_cast<std::string*>(spans_header)->assign(buffer + begin, end - begin);
+        }
+    }
+    return total;
+}
+
+void TraceRecorder::push(Event&& event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (events_.size() >= kMaxEvents) {
+        ++dropped_;
+        return;
+    }
+    events_.push_back(std::move(event));
+    dirty_ = true;
+}
+
+void TraceRecorder::recordSpan(const std::string& name, std::chrono::system_clock::time_point start,
+                               std::chrono::system_clock::time_point end, const std::string& trace_id) {
+    if (!enabled()) {
+        return;
+    }
+    int64_t ts = epochMicros(start);
+    push(Event{name, "client", false, ts, epochMicros(end) - ts, pid_, currentTid(), 0, trace_id, -1});
+}
+
+void TraceRecorder::recordTransfer(CURL* easy, const std::string& url, const char* method,
+                                   const std::string& trace_id, const std::string& spans_header) {
+    if (!enabled()) {
+        return;
+    }
+    std::string server, endpoint;
+    HttpMetrics::splitUrl(url, server, endpoint);
+    long status = 0;
+    curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &status);
+
+    // Времена curl накопительные от начала запроса; начало восстанавливаем от "сейчас"
+    const int64_t total = phaseMicros(easy, CURLINFO_TOTAL_TIME_T);
+    const int64_t dns = std::min(phaseMicros(easy, CURLINFO_NAMELOOKUP_TIME_T), total);
+    const int64_t connect = std::min(std::max(phaseMicros(easy, CURLINFO_CONNECT_TIME_T), dns), total);
+    const int64_t ttfb = std::min(std::max(phaseMicros(easy, CURLINFO_STARTTRANSFER_TIME_T), connect), total);
+    const int64_t start = epochMicros(std::chrono::system_clock::now()) - total;
+    const uint64_t id = next_request_id_.fetch_add(1);
+    const uint32_t tid = currentTid();
+
+    std::vector<Event> events;
+    events.push_back(Event{std::string(method) + " " + endpoint, "http", true, start, total, pid_, tid, id, trace_id,
+                           status});
+    const struct { const char* name; int64_t from, to; } phases[] = {
+        {"dns", 0, dns}, {"connect", dns, connect}, {"wait", connect, ttfb}, {"receive", ttfb, total}};
+    for (const auto& phase : phases) {
+        if (phase.to > phase.from) {
+            events.push_back(Event{phase.name, "http", true, start + phase.from, phase.to - phase.from, pid_, tid, id,
+                                   trace_id, -1});
+        }
+    }
+
+    // {"pid": 123, "spans": [[name, ts, dur], ...]} - см. python_server/tracing.py
+    uint32_t server_pid = 0;
+    Json::Value spans;
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (!spans_header.empty() &&
+        reader->parse(spans_header.data(), spans_header.data() + spans_header.size(), &spans, nullptr) &&
+        spans.isObject() && spans["spans"].isArray()) {
+        server_pid = spans["pid"].asUInt();
+        for (const auto& span : spans["spans"]) {
+            if (span.isArray() && span.size() == 3 && span[0].isString()) {
+                events.push_back(Event{span[0].asString(), "server", true, span[1].asInt64(), span[2].asInt64(),
+                                       server_pid, 0, id, trace_id, -1});
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (server_pid) {
+        server_pids_.insert(server_pid);
+    }
+    for (auto& event : events) {
+        if (events_.size() >= kMaxEvents) {
+            ++dropped_;
+            continue;
+        }
+        events_.push_back(std::move(event));
+    }
+    dirty_ = true;
+}
+
+bool TraceRecorder::flush(std::string& error) {
+    if (!enabled()) {
+        return true;
+    }
+
+    std::string json;
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!dirty_) {
+            return true;
+        }
+        dirty_ = false;
+        path = path_;
+        json.reserve(events_.size() * 160 + 256);
+
+        json += "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" + std::to_string(dropped_) +
+                "},\"traceEvents\":[\n";
+        json += "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" + std::to_string(pid_) +
+                ",\"args\":{\"name\":\"ResSysML client\"}}";
+        for (uint32_t server_pid : server_pids_) {
+            json += ",\n{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" + std::to_string(server_pid) +
+                    ",\"args\":{\"name\":\"ML server " + std::to_string(server_pid) + "\"}}";
+        }
+
+        for (const Event& event : events_) {
+            std::string common = ",\"cat\":\"" + std::string(event.category) + "\",\"pid\":" +
+                                 std::to_string(event.pid) + ",\"tid\":" + std::to_string(event.tid);
+            std::string args = "\"args\":{\"trace_id\":";
+            appendJsonString(args, event.trace_id);
+            if (event.status >= 0) {
+                args += ",\"status\":" + std::to_string(event.status);
+            }
+            args += "}";
+
+            json += ",\n{\"name\":";
+            appendJsonString(json, event.name);
+            json += common;
+            if (event.async) {
+                // Вложенные async-события: дорожка id, вложенность - по времени
+                char id[40];
+                std::snprintf(id, sizeof(id), ",\"id\":\"0x%llx\"", static_cast<unsigned long long>(event.id));
+                json += std::string(id) + ",\"ph\":\"b\",\"ts\":" + std::to_string(event.ts) + "," + args + "}";
+                json += ",\n{\"name\":";
+                appendJsonString(json, event.name);
+                json += common + id + ",\"ph\":\"e\",\"ts\":" + std::to_string(event.ts + event.dur) + "}";
+            } else {
+                json += ",\"ph\":\"X\",\"ts\":" + std::to_string(event.ts) + ",\"dur\":" + std::to_string(event.dur) +
+                        "," + args + "}";
+            }
+        }
+        json += "\n]}\n";
+    }
+
+    std::string tmp_path = path + ".tmp";
+    bool written = false;
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            error = "Cannot create file: " + tmp_path;
+        } else {
+            file.write(json.data(), static_cast<std::streamsize>(json.size()));
+            written = static_cast<bool>(file);
+            if (!written) {
+                error = "Write failed: " + tmp_path;
+            }
+        }
+    }
+
+    std::error_code ec;
+    if (written) {
+        fs::rename(tmp_path, path, ec);
+        if (ec) {
+            error = "Cannot rename " + tmp_path + ": " + ec.message();
+            written = false;
+        }
+    }
+    if (!written) {
+        fs::remove(tmp_path, ec);
+        std::lock_guard<std::mutex> lock(mutex_);
+        dirty_ = true; // попробуем в следующий flush
+    }
+    return written;
+}
+
+TraceSpan::TraceSpan(std::string name) : name_(std::move(name)), start_(std::chrono::system_clock::now()) {
+    if (t_trace_id.empty() && TraceRecorder::instance().enabled()) {
+        t_trace_id = TraceRecorder::newTraceId();
+        owns_trace_ = true;
+    }
+}
+
+TraceSpan::~TraceSpan() {
+    TraceRecorder::instance().recordSpan(name_, start_, std::chrono::system_clock::now(), t_trace_id);
+    if (owns_trace_) {
+        t_trace_id.clear();
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include <curl/curl.h>
+
+// Трассировка сессии в формате Chrome trace_event (открывается в Perfetto и
+// chrome://tracing). Клиент пишет свои этапы (TraceSpan) и фазы каждого HTTP-запроса,
+// запрос уходит с заголовком X-Trace-Id, сервер возвращает в X-Trace-Spans свои
+// этапы (разбор, загрузка весов, расчёт, запись - python_server/tracing.py),
+// и они попадают в тот же файл отдельным процессом. Время - мкс от эпохи по
+// системным часам: клиент и сервер на одной машине, сдвигать не нужно.
+class TraceRecorder {
+public:
+    static const char* const kTraceHeader;   // "X-Trace-Id"
+    static const char* const kSpansHeader;   // "X-Trace-Spans"
+
+    static TraceRecorder& instance();
+
+    // Включает запись; файл переписывается целиком при каждом flush
+    bool open(const std::string& path, std::string& error);
+    bool enabled() const { return enabled_.load(std::memory_order_acquire); }
+    const std::string& path() const { return path_; }
+
+    // trace id внешнего TraceSpan этого потока, без него - новый на каждый запрос
+    std::string requestTraceId() const;
+    static const std::string& currentTraceId(); // пусто - вне TraceSpan
+    static std::string newTraceId();
+
+    // Копия headers с X-Trace-Id; освобождает вызывающий (curl_slist_free_all)
+    static curl_slist* withTraceHeader(const curl_slist* headers, const std::string& trace_id);
+    // CURLOPT_HEADERFUNCTION: значение X-Trace-Spans в std::string* из CURLOPT_HEADERDATA
+    static size_t receiveHeader(char* buffer, size_t size, size_t nitems, void* spans_header);
+
+    void recordSpan(const std::string& name, std::chrono::system_clock::time_point start,
+                    std::chrono::system_clock::time_point end, const std::string& trace_id);
+    // Фазы запроса из curl_easy_getinfo (время конца - сейчас) и интервалы сервера
+    void recordTransfer(CURL* easy, const std::string& url, const char* method, const std::string& trace_id,
+                        const std::string& spans_header);
+
+    // Через временный файл и rename; без новых событий файл не трогается
+    bool flush(std::string& error);
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+private:
+    static const size_t kMaxEvents = 1 << 20;
+
+    // async - пара b/e на дорожке запроса id (запросы идут параллельно и пересекаются),
+    // иначе - "X" на потоке tid
+    struct Event {
+        std::string name;
+        const char* category;
+        bool async;
+        int64_t ts;
+        int64_t dur;
+        uint32_t pid;
+        uint32_t tid;
+        uint64_t id;
+        std::string trace_id;
+        long status;          // только у HTTP-запроса, -1 - нет
+    };
+
+    TraceRecorder() = default;
+
+    void push(Event&& event);
+
+    std::atomic<bool> enabled_{false};
+    std::string path_;
+    uint32_t pid_ = 0;
+    std::atomic<uint64_t> next_request_id_{1};
+
+    std::mutex mutex_;
+    std::vector<Event> events_;
+    std::set<uint32_t> server_pids_;
+    size_t dropped_ = 0;
+    bool dirty_ = false;
+};
+
+// Этап клиента от конструктора до деструктора. Внешний TraceSpan потока
+// задаёт trace id для всех HTTP-запросов внутри него
+class TraceSpan {
+public:
+    explicit TraceSpan(std::string name);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    std::string name_;
+    std::chrono::system_clock::time_point start_;
+    bool owns_trace_ = false;
+};
+
+#endif // TRACE_RECORDER_H
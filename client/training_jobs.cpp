@@ -0,0 +1,261 @@
+#include "training_jobs.h"
+#include <algorithm>
+#include <json/json.h>
+
+namespace {
+
+bool parseJson(const std::string& text, Json::Value& value) {
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    std::string error;
+    return reader->parse(text.data(), text.data() + text.size(), &value, &error);
+}
+
+double numberOr(const Json::Value& value, const char* key, double fallback) {
+    const Json::Value& field = value[key];
+    return field.isNumeric() ? field.asDouble() : fallback;
+}
+
+} // namespace
+
+void SseParser::feed(const char* data, size_t size, const EventHandler& handler) {
+    for (size_t i = 0; i < size; ++i) {
+        char c = data[i];
+        if (c == '\n') {
+            processLine(handler);
+            line_.clear();
+        } else if (c != '\r') {
+            line_ += c;
+        }
+    }
+}
+
+void SseParser::processLine(const EventHandler& handler) {
+    // Пустая строка завершает событие
+    if (line_.empty()) {
+        if (!data_.empty() || !event_.empty()) {
+            handler(event_.empty() ? "message" : event_, data_);
+        }
+        event_.clear();
+        data_.clear();
+        return;
+    }
+    if (line_[0] == ':') {
+        return; // комментарий (keep-alive)
+    }
+
+    size_t colon = line_.find(':');
+    std::string field = line_.substr(0, colon);
+    std::string value;
+    if (colon != std::string::npos) {
+        value = line_.substr(colon + 1);
+        if (!value.empty() && value[0] == ' ') {
+            value.erase(0, 1);
+        }
+    }
+
+    if (field == "event") {
+        event_ = value;
+    } else if (field == "data") {
+        if (!data_.empty()) {
+            data_ += '\n';
+        }
+        data_ += value;
+    }
+}
+
+TrainingJobTable::TrainingJobTable(HttpClient& client, Logger& logger)
+    : client_(client), logger_(logger), shared_(std::make_shared<Shared>()) {}
+
+TrainingJobTable::~TrainingJobTable() {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    shared_->closed = true; // потоки ещё могут доработать в движке клиента, но сюда больше не сообщают
+    shared_->on_finished = nullptr;
+}
+
+void TrainingJobTable::setFinishedHandler(FinishedHandler handler) {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    shared_->on_finished = std::move(handler);
+}
+
+bool TrainingJobTable::submit(const std::string& base_name, const std::string& base_path,
+                              const std::string& config_path, const std::string& model_type,
+                              std::string& job_id, std::string& error) {
+    std::string response = client_.post("/train/jobs",
+                                         HttpClient::trainRequestJson(base_name, base_path, config_path, model_type));
+    Json::Value json;
+    if (!parseJson(response, json) || !json.isObject()) {
+        error = response.empty() ? "Server did not respond" : "Invalid server response: " + response;
+        return false;
+    }
+    if (json.get("status", "").asString() != "success") {
+        error = json.get("message", "Training job rejected").asString();
+        return false;
+    }
+
+    job_id = json["job_id"].asString();
+    TrainingJobStatus status;
+    status.id = job_id;
+    status.base_name = base_name;
+    status.model_type = model_type;
+    status.state = json.get("state", "queued").asString();
+    status.submitted_at = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        shared_->jobs[job_id] = status;
+    }
+
+    logger_.info("Training job " + job_id + " submitted - Base: " + base_name + ", Model: " + model_type);
+    subscribe(client_, logger_, shared_, job_id, 0, 0);
+    return true;
+}
+
+bool TrainingJobTable::cancel(const std::string& job_id, std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(shared_->mutex);
+        auto it = shared_->jobs.find(job_id);
+        if (it == shared_->jobs.end()) {
+            error = "Unknown job: " + job_id;
+            return false;
+        }
+        if (it->second.finished()) {
+            error = "Job already finished: " + it->second.state;
+            return false;
+        }
+    }
+
+    std::string response = client_.post("/train/jobs/" + job_id + "/cancel", "{}");
+    Json::Value json;
+    if (!parseJson(response, json) || json.get("status", "").asString() != "success") {
+        error = response.empty() ? "Server did not respond" : json.get("message", response).asString();
+        return false;
+    }
+    // Итоговое состояние придёт событием done, когда сервер дойдёт до проверки между пакетами
+    logger_.info("Training job " + job_id + " cancellation requested");
+    return true;
+}
+
+std::vector<TrainingJobStatus> TrainingJobTable::snapshot() const {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    std::vector<TrainingJobStatus> jobs;
+    jobs.reserve(shared_->jobs.size());
+    for (const auto& entry : shared_->jobs) {
+        jobs.push_back(entry.second);
+    }
+    std::sort(jobs.begin(), jobs.end(), [](const TrainingJobStatus& a, const TrainingJobStatus& b) {
+        return a.submitted_at < b.submitted_at;
+    });
+    return jobs;
+}
+
+size_t TrainingJobTable::activeCount() const {
+    std::lock_guard<std::mutex> lock(shared_->mutex);
+    size_t active = 0;
+    for (const auto& entry : shared_->jobs) {
+        if (!entry.second.finished()) {
+            ++active;
+        }
+    }
+    return active;
+}
+
+void TrainingJobTable::subscribe(HttpClient& client, Logger& logger, std::shared_ptr<Shared> shared,
+                                 const std::string& job_id, size_t from, int reconnects) {
+    struct StreamState {
+        SseParser parser;
+        size_t received = 0;
+    };
+    auto stream = std::make_shared<StreamState>();
+    stream->received = from;
+
+    auto on_data = [shared, stream, &logger, job_id](const char* data, size_t size) {
+        stream->parser.feed(data, size, [&](const std::string& event, const std::string& payload) {
+            ++stream->received;
+            applyEvent(*shared, logger, job_id, event, payload);
+        });
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        return !shared->closed;
+    };
+
+    auto on_done = [&client, &logger, shared, stream, job_id, reconnects](HttpResponse&& response) {
+        FinishedHandler handler;
+        TrainingJobStatus finished;
+        {
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            if (shared->closed) {
+                return;
+            }
+            auto it = shared->jobs.find(job_id);
+            if (it == shared->jobs.end() || it->second.finished()) {
+                return; // поток закрыт сервером после done
+            }
+            if (reconnects < kMaxReconnects) {
+                logger.warning("Training job " + job_id + " event stream interrupted (" +
+                               (response.ok ? "closed" : response.error) + "), reconnecting");
+            } else {
+                it->second.state = "disconnected";
+                it->second.message = response.ok ? "Event stream closed" : response.error;
+                handler = shared->on_finished;
+                finished = it->second;
+            }
+        }
+
+        if (handler) {
+            handler(finished);
+        } else if (reconnects < kMaxReconnects) {
+            // Продолжаем с первого не полученного события
+            subscribe(client, logger, shared, job_id, stream->received, reconnects + 1);
+        }
+    };
+
+    client.getStream("/train/jobs/" + job_id + "/events?from=" + std::to_string(from), std::move(on_data),
+                     std::move(on_done));
+}
+
+void TrainingJobTable::applyEvent(Shared& shared, Logger& logger, const std::string& job_id,
+                                  const std::string& event, const std::string& data) {
+    Json::Value json;
+    if (!parseJson(data, json) || !json.isObject()) {
+        logger.warning("Training job " + job_id + ": malformed event " + event);
+        return;
+    }
+
+    FinishedHandler handler;
+    TrainingJobStatus finished;
+    {
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        auto it = shared.jobs.find(job_id);
+        if (it == shared.jobs.end()) {
+            return;
+        }
+        TrainingJobStatus& status = it->second;
+
+        if (event == "epoch") {
+            status.state = "running";
+            status.epoch = json.get("epoch", status.epoch).asInt();
+            status.epochs = json.get("epochs", status.epochs).asInt();
+            status.train_loss = numberOr(json, "train_loss", status.train_loss);
+            status.test_loss = numberOr(json, "test_loss", status.test_loss);
+            status.r2 = numberOr(json, "r2", status.r2);
+            status.best_loss = numberOr(json, "best_test_loss", status.best_loss);
+            logger.debug("Training job " + job_id + " epoch " + std::to_string(status.epoch) + "/" +
+                         std::to_string(status.epochs) + ": train " + std::to_string(status.train_loss) +
+                         ", test " + std::to_string(status.test_loss) + ", R2 " + std::to_string(status.r2));
+        } else if (event == "state" || event == "done") {
+            status.state = json.get("state", status.state).asString();
+            status.message = json.get("message", status.message).asString();
+            status.weights_path = json.get("weights_path", status.weights_path).asString();
+            status.best_loss = numberOr(json, "best_loss", status.best_loss);
+            status.accuracy = numberOr(json, "accuracy", status.accuracy);
+            if (event == "done") {
+                logger.info("Training job " + job_id + " " + status.state + ": " + status.message);
+                handler = shared.closed ? nullptr : shared.on_finished;
+                finished = status;
+            }
+        }
+    }
+
+    if (handler) {
+        handler(finished);
+    }
+}
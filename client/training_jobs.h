@@ -0,0 +1,95 @@
+#ifndef TRAINING_JOBS_H
+#define TRAINING_JOBS_H
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "http_client.h"
+#include "logger.h"
+
+// Разбор text/event-stream по кускам произвольной длины (границы кусков
+// не совпадают с границами строк и событий)
+class SseParser {
+public:
+    using EventHandler = std::function<void(const std::string& event, const std::string& data)>;
+
+    void feed(const char* data, size_t size, const EventHandler& handler);
+
+private:
+    std::string line_;
+    std::string event_;
+    std::string data_;
+
+    void processLine(const EventHandler& handler);
+};
+
+struct TrainingJobStatus {
+    std::string id;
+    std::string base_name;
+    std::string model_type;
+    std::string state = "queued"; // queued | running | succeeded | failed | cancelled | disconnected
+    int epoch = 0;
+    int epochs = 0;
+    double train_loss = 0.0;
+    double test_loss = 0.0;
+    double r2 = 0.0;
+    double best_loss = 0.0;
+    double accuracy = 0.0;
+    std::string weights_path;
+    std::string message;
+    std::chrono::steady_clock::time_point submitted_at;
+
+    bool finished() const {
+        return state == "succeeded" || state == "failed" || state == "cancelled" || state == "disconnected";
+    }
+};
+
+// Обучения на сервере (POST /train/jobs) и их прогресс из SSE-потоков
+// /train/jobs/{id}/events. Меню не блокируется: потоки разбираются в
+// потоке curl_multi, таблица читается снимком.
+class TrainingJobTable {
+public:
+    using FinishedHandler = std::function<void(const TrainingJobStatus&)>;
+
+    TrainingJobTable(HttpClient& client, Logger& logger);
+    ~TrainingJobTable();
+
+    TrainingJobTable(const TrainingJobTable&) = delete;
+    TrainingJobTable& operator=(const TrainingJobTable&) = delete;
+
+    bool submit(const std::string& base_name, const std::string& base_path, const std::string& config_path,
+                const std::string& model_type, std::string& job_id, std::string& error);
+    bool cancel(const std::string& job_id, std::string& error);
+
+    // Вызывается из потока HTTP-движка по завершении задания
+    void setFinishedHandler(FinishedHandler handler);
+
+    std::vector<TrainingJobStatus> snapshot() const;
+    size_t activeCount() const;
+
+private:
+    // Общее с колбэками потоков: живёт, пока не закончится последний поток
+    struct Shared {
+        std::mutex mutex;
+        std::map<std::string, TrainingJobStatus> jobs;
+        FinishedHandler on_finished;
+        bool closed = false;
+    };
+
+    HttpClient& client_;
+    Logger& logger_;
+    std::shared_ptr<Shared> shared_;
+
+    static const int kMaxReconnects = 5;
+
+    static void subscribe(HttpClient& client, Logger& logger, std::shared_ptr<Shared> shared,
+                          const std::string& job_id, size_t from, int reconnects);
+    static void applyEvent(Shared& shared, Logger& logger, const std::string& job_id,
+                           const std::string& event, const std::string& data);
+};
+
+#endif // TRAINING_JOBS_H
@@ -25,6 +25,8 @@ for directory in [MODELS_DIR, DATA_DIR, LOGS_DIR]:
 # Настройки сервера
 HOST = "localhost"
 PORT = 8000
+# Версия протокола клиент-сервер: демон другой версии клиент не переиспользует (client/server_daemon.h)
+SERVER_VERSION = "1.4"
 DEBUG = False
 
 # Настройки модели
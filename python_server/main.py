@@ -3,19 +3,31 @@ import sys
 import os
 import signal
 sys.path.append(os.path.join(os.path.dirname(__file__), 'site-packages'))
-from fastapi import FastAPI, HTTPException, status
+from fastapi import FastAPI, HTTPException, Query, Request, status
 from fastapi.middleware.cors import CORSMiddleware
-from fastapi.responses import JSONResponse
+from fastapi.responses import JSONResponse, Response, StreamingResponse
+from starlette.concurrency import run_in_threadpool
 from pydantic import BaseModel, Field
 from typing import List, Optional, Dict, Any
 import uvicorn
 import logging
+import argparse
+import asyncio
+import json
 from datetime import datetime
 
-from config import HOST, PORT, DEBUG, MODEL_CONFIG
+from config import HOST, PORT, DEBUG, MODEL_CONFIG, SERVER_VERSION
+from server_daemon import LockFile, IdleWatchdog
+import tracing
 from moked_model import model
 import ml.predict as PRED
 import ml.train as TRAIN
+from ml.jobs import TrainingJobManager
+from SharedTensorRing import close_segments
+
+JOBS = TrainingJobManager(max_parallel=1)
+WATCHDOG = IdleWatchdog()
+LOCK = None  # файл блокировки в режиме демона
 
 logging.basicConfig(level=logging.INFO)
 logger = logging.getLogger("PY_Server")
@@ -35,6 +47,8 @@ class BatchPredictionRequest(BaseModel):
 
 class HealthResponse(BaseModel):
     status: str
+    version: str
+    pid: int
     model_loaded: bool
     server_time: str
     model_info: Dict[str, Any]
@@ -57,6 +71,29 @@ app.add_middleware(
     allow_headers=["*"],
 )
 
+@app.middleware("http")
+async def track_activity(request: Request, call_next):
+    """Учёт запросов для выхода демона по простою"""
+    WATCHDOG.begin()
+    try:
+        return await call_next(request)
+    finally:
+        WATCHDOG.end()
+
+@app.middleware("http")
+async def trace_request(request: Request, call_next):
+    """Запрос с X-Trace-Id: интервалы этапов (ml/predict.py) уходят клиенту в X-Trace-Spans"""
+    trace_id = request.headers.get(tracing.TRACE_HEADER)
+    if not trace_id:
+        return await call_next(request)
+    
+    with tracing.request_trace(trace_id) as trace:
+        with tracing.span(f"{request.method} {request.url.path}"):
+            response = await call_next(request)
+    response.headers[tracing.TRACE_HEADER] = trace_id
+    response.headers[tracing.SPANS_HEADER] = trace.header()
+    return response
+
 @app.get("/", include_in_schema=False)
 async def root():
     return {"message": "ML Model Server is running"}
@@ -66,6 +103,8 @@ async def health_check():
     """Проверка статуса сервера и модели"""
     return {
         "status": "healthy",
+        "version": SERVER_VERSION,
+        "pid": os.getpid(),
         "model_loaded": model.is_loaded,
         "server_time": datetime.now().isoformat(),
         "model_info": model.get_model_info()
@@ -77,7 +116,7 @@ async def get_model_info():
     return model.get_model_info()
 
 @app.post("/train")
-async def train_model(request: dict):
+def train_model(request: dict):
     try:
         base_name = request.get("base_name")
         base_path = request.get("base_path") 
@@ -98,8 +137,64 @@ async def train_model(request: dict):
     except Exception as e:
         return {"status": "error", "message": str(e)}
 
+@app.post("/train/jobs")
+async def submit_train_job(request: dict):
+    """Обучение в фоне: сразу возвращает job_id, прогресс - через /train/jobs/{job_id}/events"""
+    base_name = request.get("base_name")
+    base_path = request.get("base_path")
+    config_path = request.get("config_path")
+    model_type = request.get("model_type")
+    
+    if not base_name or not base_path or not config_path or not model_type:
+        return {"status": "error", "message": "Missing required parameters"}
+    
+    job = JOBS.submit(base_name, base_path, config_path, model_type)
+    return {"status": "success", "job_id": job.id, "state": job.state}
+
+@app.get("/train/jobs")
+async def list_train_jobs():
+    return {"status": "success", "jobs": JOBS.list()}
+
+@app.get("/train/jobs/{job_id}")
+async def get_train_job(job_id: str):
+    job = JOBS.get(job_id)
+    if job is None:
+        return JSONResponse(status_code=404, content={"status": "error", "message": f"Unknown job: {job_id}"})
+    return dict(job.summary(), status="success")
+
+@app.post("/train/jobs/{job_id}/cancel")
+async def cancel_train_job(job_id: str):
+    if not JOBS.cancel(job_id):
+        return JSONResponse(status_code=404, content={"status": "error", "message": f"Unknown job: {job_id}"})
+    return {"status": "success", "job_id": job_id}
+
+@app.get("/train/jobs/{job_id}/events")
+async def train_job_events(job_id: str, start: int = Query(0, alias="from")):
+    """
+    Server-Sent Events: state (queued/running), epoch (после каждой эпохи), done (итог).
+    from - сколько событий клиент уже получил (переподключение без повторов)
+    """
+    job = JOBS.get(job_id)
+    if job is None:
+        return JSONResponse(status_code=404, content={"status": "error", "message": f"Unknown job: {job_id}"})
+    
+    async def stream():
+        index = start
+        while True:
+            events, finished = await asyncio.to_thread(job.wait_events, index, 15.0)
+            if not events and not finished:
+                yield ": keep-alive\n\n"
+                continue
+            for event, data in events:
+                index += 1
+                yield f"id: {index}\nevent: {event}\ndata: {json.dumps(data)}\n\n"
+            if finished and not events:
+                break
+    
+    return StreamingResponse(stream(), media_type="text/event-stream", headers={"Cache-Control": "no-cache"})
+
 @app.post("/predict")
-async def predict_with_model(request: dict):
+def predict_with_model(request: dict):
     try:
         file_path = request.get("file_path")
         model_name = request.get("model_name") 
@@ -120,6 +215,61 @@ async def predict_with_model(request: dict):
     except Exception as e:
         return {"status": "error", "message": str(e)}
 
+@app.post("/predict/binary")
+async def predict_with_model_binary(request: Request, file_path: str = "", model_name: str = "", base_name: str = "",
+                                    inline: bool = False):
+    """
+    Предсказание по бинарным тензорам от клиента (client/prediction_payload.h).
+    inline=1 - предсказания в ответе (PRED.inline_reply), файл результатов пишет клиент
+    """
+    try:
+        if not model_name or not base_name:
+            return {"status": "error", "message": "Missing required parameters"}
+        
+        body = await request.body()
+        if inline:
+            preds, metrics = await run_in_threadpool(PRED.pred_binary, body, file_path or "binary_input",
+                                                     model_name, base_name, inline=True)
+            content = await run_in_threadpool(PRED.inline_reply, preds, metrics)
+            return Response(content=content, media_type="application/json")
+        # Сам расчёт блокирующий - в пул потоков, чтобы цикл событий продолжал принимать запросы
+        output_path, metrics = await run_in_threadpool(PRED.pred_binary, body, file_path or "binary_input",
+                                                       model_name, base_name)
+        
+        return {
+            "status": "success",
+            "output_path": output_path,
+            "metrics": metrics,
+            "message": f"Prediction completed using {model_name} model trained on {base_name}"
+        }
+        
+    except Exception as e:
+        return {"status": "error", "message": str(e)}
+
+@app.post("/predict/shm")
+async def predict_with_model_shm(request: dict):
+    """Предсказание по слоту общей памяти клиента (client/shared_tensor_ring.h): по HTTP только описание слота"""
+    try:
+        segment = request.get("segment")
+        model_name = request.get("model_name")
+        base_name = request.get("base_name")
+        if not segment or not model_name or not base_name:
+            return {"status": "error", "message": "Missing required parameters"}
+        
+        _, metrics = await run_in_threadpool(
+            PRED.pred_shm, segment, int(request["request_offset"]), int(request["request_size"]),
+            int(request["reply_offset"]), int(request["reply_count"]), request.get("file_path") or "shm_input",
+            model_name, base_name)
+        
+        return {
+            "status": "success",
+            "metrics": metrics,
+            "message": f"Prediction completed using {model_name} model trained on {base_name}"
+        }
+        
+    except Exception as e:
+        return {"status": "error", "message": str(e)}
+
 @app.get("/config")
 async def get_server_config():
     """Получение конфигурации сервера"""
@@ -131,21 +281,74 @@ async def get_server_config():
         },
         "model_config": MODEL_CONFIG
     }
+def stop_server():
+    """Выход как по Ctrl+C; блокировка снимается заранее - на Windows os.kill завершает процесс без finally"""
+    if LOCK:
+        LOCK.release()
+    os.kill(os.getpid(), signal.SIGINT)
+
 @app.post("/shutdown")
 async def shutdown_server():
     """Эндпоинт для graceful shutdown"""
-    os.kill(os.getpid(), signal.SIGINT)
+    JOBS.cancel_all()  # SSE-потоки закроются, когда обучения остановятся
+    close_segments()
+    stop_server()
     return {"message": "Server shutting down..."}
 
 if __name__ == "__main__":
-    logger.info(f"Starting ML Server on {HOST}:{PORT}")
-    logger.info(f"Docs available at: http://{HOST}:{PORT}/docs")
+    parser = argparse.ArgumentParser(description="ResSys ML server")
+    parser.add_argument("--host", default=HOST)
+    parser.add_argument("--port", type=int, default=PORT)
+    parser.add_argument("--uds", default=None, help="Unix domain socket вместо TCP (transport = unix у клиента)")
+    parser.add_argument("--threads", type=int, default=0,
+                        help="потоков torch на процесс; клиент с workers > 1 делит между ними ядра")
+    parser.add_argument("--daemon", action="store_true",
+                        help="сервер переживает клиента: файл блокировки и выход по простою")
+    parser.add_argument("--lock-file", default=None, help="файл блокировки демона (по умолчанию в APPDATA)")
+    parser.add_argument("--idle-timeout", type=int, default=1800,
+                        help="секунд без запросов до выхода демона, 0 - не выходить")
+    args = parser.parse_args()
+
+    if args.daemon:
+        lock_path = args.lock_file or str(Path(os.getenv('APPDATA', '.')) / "ResSysApp" / "server.lock")
+        LOCK = LockFile(lock_path, {
+            "pid": os.getpid(),
+            "port": args.port,
+            "uds": args.uds or "",
+            "version": SERVER_VERSION,
+            "started": datetime.now().isoformat()
+        })
+        try:
+            LOCK.acquire()
+        except RuntimeError as e:
+            logger.error(str(e))
+            sys.exit(1)
+        if args.idle_timeout > 0:
+            logger.info(f"Daemon mode: exit after {args.idle_timeout} s without requests")
+            WATCHDOG.start(args.idle_timeout, lambda: JOBS.active_count() > 0, stop_server)
+
+    if args.threads > 0:
+        import torch
+        torch.set_num_threads(args.threads)
+        logger.info(f"Torch threads: {args.threads}")
+
+    if args.uds:
+        logger.info(f"Starting ML Server on unix socket {args.uds}")
+        bind = {"uds": args.uds}
+    else:
+        logger.info(f"Starting ML Server on {args.host}:{args.port}")
+        logger.info(f"Docs available at: http://{args.host}:{args.port}/docs")
+        bind = {"host": args.host, "port": args.port}
     
-    uvicorn.run(
-        app,
-        host=HOST,
-        port=PORT,
-        log_level="info" if not DEBUG else "debug",
-        access_log=False
-        # reload=DEBUG 
-    )
\ No newline at end of file
+    try:
+        uvicorn.run(
+            app,
+            **bind,
+            log_level="info" if not DEBUG else "debug",
+            access_log=False,
+            timeout_keep_alive=30  # клиент держит пул keep-alive соединений
+            # reload=DEBUG 
+        )
+    finally:
+        if LOCK:
+            LOCK.release()
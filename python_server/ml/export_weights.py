@@ -0,0 +1,100 @@
+import struct
+import sys, os
+from pathlib import Path
+
+import torch
+
+sys.path.append(os.path.abspath(os.path.join(os.path.dirname(__file__), '..', 'models')))
+from ConvLayers_model import DynamicNMRRegressor
+
+# Формат .rsw читает client/nmr_inference.cpp
+MAGIC = b"RSWEIGHT"
+VERSION = 1
+
+# Порядок тензоров в файле = порядок слоёв DynamicNMRRegressor
+TENSOR_KEYS = [
+    "shared_conv.0.weight", "shared_conv.0.bias",
+    "shared_conv.3.weight", "shared_conv.3.bias",
+    "final_fc.0.weight", "final_fc.0.bias",
+    "final_fc.3.weight", "final_fc.3.bias",
+]
+
+REFERENCE_SAMPLES = 4
+
+
+def read_base_config(config_path):
+    """x_lengths и num_targets_y из конфига обучающей базы"""
+    config = {}
+    with open(config_path, 'r') as f:
+        for line in f:
+            line = line.strip()
+            if line and '=' in line:
+                key, value = line.split('=', 1)
+                config[key.strip()] = value.strip()
+    x_lengths = list(map(int, config['x_lengths'].split(',')))
+    return x_lengths, int(config['num_targets_y'])
+
+
+def get_native_weights_path(weights_path):
+    """base_model.pth / base_model_best.pth -> base_model.rsw"""
+    path = Path(weights_path)
+    stem = path.stem[:-5] if path.stem.endswith("_best") else path.stem
+    return path.with_name(stem + ".rsw")
+
+
+def _write_tensor(f, tensor):
+    data = tensor.detach().cpu().contiguous().float()
+    f.write(struct.pack("<I", data.dim()))
+    f.write(struct.pack(f"<{data.dim()}I", *data.shape))
+    f.write(data.numpy().astype("<f4").tobytes())
+
+
+def export_model(model, x_lengths, num_targets, output_path):
+    """
+    Сохраняет веса модели для нативного движка клиента вместе с эталонным
+    прогоном PyTorch, по которому клиент проверяет свои результаты при загрузке
+    """
+    model.eval()
+    state = model.state_dict()
+
+    generator = torch.Generator().manual_seed(0)
+    reference_inputs = [torch.randn(REFERENCE_SAMPLES, length, generator=generator) for length in x_lengths]
+    with torch.no_grad():
+        reference_outputs = model(*reference_inputs)
+
+    tmp_path = Path(str(output_path) + ".tmp")
+    with open(tmp_path, "wb") as f:
+        f.write(MAGIC)
+        f.write(struct.pack("<III", VERSION, len(x_lengths), num_targets))
+        f.write(struct.pack(f"<{len(x_lengths)}I", *x_lengths))
+
+        for key in TENSOR_KEYS:
+            _write_tensor(f, state[key])
+
+        f.write(struct.pack("<I", REFERENCE_SAMPLES))
+        for x in reference_inputs:
+            f.write(x.numpy().astype("<f4").tobytes())
+        f.write(reference_outputs.numpy().astype("<f4").tobytes())
+
+    os.replace(tmp_path, output_path)
+    return str(output_path)
+
+
+def export_weights(weights_path, x_lengths, num_targets, output_path=None):
+    """Экспорт .pth файла DynamicNMRRegressor в .rsw"""
+    model = DynamicNMRRegressor(x_lengths, num_targets)
+    model.load_state_dict(torch.load(weights_path, map_location="cpu", weights_only=True))
+    if output_path is None:
+        output_path = get_native_weights_path(weights_path)
+    return export_model(model, x_lengths, num_targets, output_path)
+
+
+if __name__ == "__main__":
+    # python export_weights.py <weights.pth> <base_config.txt> [output.rsw]
+    if len(sys.argv) < 3:
+        print("Usage: export_weights.py <weights.pth> <base_config.txt> [output.rsw]")
+        sys.exit(1)
+
+    x_lengths, num_targets = read_base_config(sys.argv[2])
+    output = export_weights(sys.argv[1], x_lengths, num_targets, sys.argv[3] if len(sys.argv) > 3 else None)
+    print(f"Native weights saved to {output}")
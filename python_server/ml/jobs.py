@@ -0,0 +1,131 @@
+import math
+import threading
+import time
+import uuid
+from concurrent.futures import ThreadPoolExecutor
+
+import ml.train as TRAIN
+
+TERMINAL_STATES = ("succeeded", "failed", "cancelled")
+
+
+class TrainingJob:
+    """Одно обучение: состояние и журнал событий, который читают SSE-подписчики"""
+
+    def __init__(self, base_name, base_path, config_path, model_type):
+        self.id = uuid.uuid4().hex[:12]
+        self.base_name = base_name
+        self.base_path = base_path
+        self.config_path = config_path
+        self.model_type = model_type
+        self.state = "queued"
+        self.created = time.time()
+        self.events = []            # (event, data) по порядку; индекс = id события - 1
+        self.last_epoch = None
+        self.result = None
+        self.cancel_event = threading.Event()
+        self.cond = threading.Condition()
+
+    @property
+    def finished(self):
+        return self.state in TERMINAL_STATES
+
+    def publish(self, event, data):
+        with self.cond:
+            if event == "epoch":
+                self.last_epoch = data
+            self.events.append((event, data))
+            self.cond.notify_all()
+
+    def set_state(self, state, result=None):
+        # Состояние и событие меняются под одной блокировкой: подписчик не пропустит "done"
+        with self.cond:
+            self.state = state
+            if result is not None:
+                self.result = result
+            data = dict(result or {}, state=state)
+            self.events.append(("done" if self.finished else "state", data))
+            self.cond.notify_all()
+
+    def wait_events(self, start, timeout):
+        """События начиная с индекса start; ждёт не дольше timeout, если новых нет"""
+        with self.cond:
+            if len(self.events) <= start and not self.finished:
+                self.cond.wait(timeout)
+            return self.events[start:], self.finished
+
+    def summary(self):
+        with self.cond:
+            return {
+                "job_id": self.id,
+                "base_name": self.base_name,
+                "model_type": self.model_type,
+                "state": self.state,
+                "created": self.created,
+                "progress": self.last_epoch,
+                "result": self.result,
+            }
+
+
+class TrainingJobManager:
+    """Очередь обучений: не больше max_parallel одновременно, остальные ждут в queued"""
+
+    def __init__(self, max_parallel=1):
+        self.jobs = {}
+        self.lock = threading.Lock()
+        self.executor = ThreadPoolExecutor(max_workers=max_parallel, thread_name_prefix="train")
+
+    def submit(self, base_name, base_path, config_path, model_type):
+        job = TrainingJob(base_name, base_path, config_path, model_type)
+        with self.lock:
+            self.jobs[job.id] = job
+        self.executor.submit(self._run, job)
+        return job
+
+    def get(self, job_id):
+        with self.lock:
+            return self.jobs.get(job_id)
+
+    def list(self):
+        with self.lock:
+            jobs = list(self.jobs.values())
+        return [job.summary() for job in jobs]
+
+    def cancel(self, job_id):
+        job = self.get(job_id)
+        if job is None:
+            return False
+        job.cancel_event.set()
+        return True
+
+    def active_count(self):
+        with self.lock:
+            return sum(1 for job in self.jobs.values() if not job.finished)
+
+    def cancel_all(self):
+        with self.lock:
+            jobs = list(self.jobs.values())
+        for job in jobs:
+            job.cancel_event.set()
+
+    def _run(self, job):
+        if job.cancel_event.is_set():
+            job.set_state("cancelled", {"message": "Training cancelled"})
+            return
+
+        job.set_state("running")
+        try:
+            best_loss, weights_path, accuracy = TRAIN.train(
+                job.base_name, job.base_path, job.config_path, job.model_type,
+                progress_cb=lambda progress: job.publish("epoch", progress),
+                should_stop=job.cancel_event.is_set)
+            job.set_state("succeeded", {
+                "message": f"Training completed for {job.base_name}",
+                "accuracy": accuracy,
+                "best_loss": best_loss if math.isfinite(best_loss) else None,
+                "weights_path": weights_path,
+            })
+        except TRAIN.TrainingCancelled:
+            job.set_state("cancelled", {"message": "Training cancelled"})
+        except Exception as e:
+            job.set_state("failed", {"message": str(e)})
@@ -1,8 +1,9 @@
 import torch
 import torch.nn as nn
-from torch.utils.data import DataLoader
 import numpy as np
 import sys, os
+import json
+import warnings
 from pathlib import Path
 from sklearn.metrics import r2_score, mean_squared_error
 
@@ -12,6 +13,10 @@ from ConvLayers_model import DynamicNMRRegressor
 
 sys.path.append(os.path.abspath(os.path.join(os.path.dirname(__file__), '..', 'preproc')))
 from Preprocess import parse_data_file, splitSamples
+from TensorPayload import decode_tensor_payload
+from SharedTensorRing import slot_views
+
+from tracing import span
 
 def get_weights_path(base_name, model_name):
     """Получаем путь к весам модели по названию базы и модели"""
@@ -46,14 +51,11 @@ def parse_config(config_path):
 
 def create_model(model_name, input_dims, num_targets):
     """Создаем модель по названию"""
-    if model_name == "svr":
-        # TODO: Заменить на вашу SVR модель
-        return DynamicNMRRegressor(input_dims, num_targets)
-    elif model_name == "convolutional":
-        return DynamicNMRRegressor(input_dims, num_targets)
-    elif model_name == "linear_regression":
-        # TODO: Заменить на вашу Linear Regression модель
+    if model_name == "convolutional":
         return DynamicNMRRegressor(input_dims, num_targets)
+    elif model_name in ("svr", "linear_regression"):
+        # Модели клиента (client/native_regression.h, .rsm): сервер загрузил бы вместо них веса CNN
+        raise Exception(f"Model {model_name} is predicted by the client, not by the server")
     else:
         raise Exception(f"Unknown model type: {model_name}")
 
@@ -86,65 +88,133 @@ def save_predictions(all_preds, all_targets, file_path, model_name, base_name, m
     
     return str(output_path)
 
-def pred(file_path, model_name, base_name):
-    """Основная функция предсказания"""
-    weights_path = get_weights_path(base_name, model_name)
-    config_path = get_model_config_path(base_name)
-    
-    config = parse_config(config_path)
+def load_base_config(base_name):
+    """num_features_x, x_lengths и num_targets_y из конфига базы"""
+    config = parse_config(get_model_config_path(base_name))
     num_features_x = int(config['num_features_x'])
     x_lengths = list(map(int, config['x_lengths'].split(',')))
     num_targets_y = int(config['num_targets_y'])
-    
-    test_data = parse_data_file(file_path)
-    x_test, y_test = splitSamples(test_data)
-    
-    # Проверки соответствие размеров
-    if len(x_test) != num_features_x:
-        raise Exception(f"Feature count mismatch: config has {num_features_x}, data has {len(x_test)}")
+    return num_features_x, x_lengths, num_targets_y
+
+def check_shapes(x_lengths_data, num_targets_data, num_features_x, x_lengths, num_targets_y):
+    """Проверки соответствие размеров"""
+    if len(x_lengths_data) != num_features_x:
+        raise Exception(f"Feature count mismatch: config has {num_features_x}, data has {len(x_lengths_data)}")
     
     for i, length in enumerate(x_lengths):
-        if len(x_test[i][0]) != length:
-            raise Exception(f"Feature X[{i}] length mismatch: config has {length}, data has {len(x_test[i][0])}")
+        if x_lengths_data[i] != length:
+            raise Exception(f"Feature X[{i}] length mismatch: config has {length}, data has {x_lengths_data[i]}")
     
-    if len(y_test[0]) != num_targets_y:
-        raise Exception(f"Target count mismatch: config has {num_targets_y}, data has {len(y_test[0])}")
+    if num_targets_data != num_targets_y:
+        raise Exception(f"Target count mismatch: config has {num_targets_y}, data has {num_targets_data}")
+
+def pred(file_path, model_name, base_name):
+    """Основная функция предсказания"""
+    with span("parse"):
+        num_features_x, x_lengths, num_targets_y = load_base_config(base_name)
+        
+        test_data = parse_data_file(file_path)
+        x_test, y_test = splitSamples(test_data)
+        
+        check_shapes([len(x[0]) for x in x_test], len(y_test[0]), num_features_x, x_lengths, num_targets_y)
+        
+        test_dataset = DynamicNMRDataset(*x_test, y=y_test)
+    return pred_tensors(test_dataset.x_signals, test_dataset.y, file_path, model_name, base_name, x_lengths)
+
+def pred_binary(body, file_path, model_name, base_name, inline=False):
+    """
+    Предсказание по телу POST /predict/binary: клиент уже разобрал и проверил файл.
+    inline - вернуть предсказания (см. inline_reply) вместо файла результатов
+    """
+    with span("parse"):
+        num_features_x, x_lengths, num_targets_y = load_base_config(base_name)
+        
+        x_test, y_test = decode_tensor_payload(body)
+        check_shapes([x.shape[1] for x in x_test], y_test.shape[1], num_features_x, x_lengths, num_targets_y)
+    
+    return pred_tensors(x_test, y_test, file_path, model_name, base_name, x_lengths, inline=inline)
+
+def pred_buffers(x_buffers, y_buffer, num_samples, file_path, model_name, base_name):
+    """
+    Предсказание во встроенном интерпретаторе (client/embedded_python.h): каналы X и Y -
+    memoryview поверх памяти C++, тензоры строятся над ними без копий и без HTTP
+    """
+    num_features_x, x_lengths, num_targets_y = load_base_config(base_name)
+    
+    # memoryview только для чтения - тензоры здесь тоже только читаются
+    with warnings.catch_warnings():
+        warnings.simplefilter("ignore", UserWarning)
+        x_test = [torch.frombuffer(b, dtype=torch.float32).view(num_samples, -1) for b in x_buffers]
+        y_test = torch.frombuffer(y_buffer, dtype=torch.float32).view(num_samples, -1)
+    check_shapes([x.shape[1] for x in x_test], y_test.shape[1], num_features_x, x_lengths, num_targets_y)
+    
+    return pred_tensors(x_test, y_test, file_path, model_name, base_name, x_lengths)
+
+def pred_shm(segment, request_offset, request_size, reply_offset, reply_count, file_path, model_name, base_name):
+    """
+    Предсказание по слоту общей памяти клиента (POST /predict/shm): вход читается
+    из сегмента без копий, предсказания пишутся в область ответа того же слота,
+    файл результатов пишет клиент
+    """
+    with span("parse"):
+        num_features_x, x_lengths, num_targets_y = load_base_config(base_name)
+        
+        request, reply = slot_views(segment, request_offset, request_size, reply_offset, reply_count)
+        x_test, y_test = decode_tensor_payload(request)
+        check_shapes([x.shape[1] for x in x_test], y_test.shape[1], num_features_x, x_lengths, num_targets_y)
+    if reply_count != y_test.numel():
+        raise Exception(f"Reply region holds {reply_count} values, need {y_test.numel()}")
     
+    return pred_tensors(x_test, y_test, file_path, model_name, base_name, x_lengths, reply=reply)
+
+def pred_tensors(x_test, y_test, file_path, model_name, base_name, x_lengths, reply=None, inline=False):
+    """
+    Прогон модели по готовым тензорам
+
+    :param x_test: список тензоров [P, L_i]
+    :param y_test: тензор [P, N]
+    :param reply: плоский тензор float32 [P * N] - куда положить предсказания вместо файла
+    :param inline: вернуть предсказания [P, N] первым значением вместо пути к файлу
+    """
+    weights_path = get_weights_path(base_name, model_name)
+    num_targets_y = y_test.shape[1]
     batch_size = 32
-    test_dataset = DynamicNMRDataset(*x_test, y=y_test)
-    test_dataloader = DataLoader(test_dataset, batch_size=batch_size, shuffle=False)
 
     device = torch.device('cuda' if torch.cuda.is_available() else 'cpu')
-    model = create_model(model_name, x_lengths, num_targets_y)
-    model.load_state_dict(torch.load(weights_path, map_location=device, weights_only=True))
-    model.to(device)
-    model.eval()
+    with span("load"):
+        model = create_model(model_name, x_lengths, num_targets_y)
+        model.load_state_dict(torch.load(weights_path, map_location=device, weights_only=True))
+        model.to(device)
+        model.eval()
 
     criterion = nn.MSELoss()
     test_running_loss = 0.0
+    num_batches = 0
     all_preds = []
     all_targets = []
 
-    with torch.no_grad():
-        for batch in test_dataloader:
-            *x_batch, y_batch = batch
-            x_batch = [x.to(device) for x in x_batch]
-            y_batch = y_batch.to(device)
+    # Те же пакеты, что дал бы DataLoader(shuffle=False), но срезами без поэлементной сборки
+    with span("infer"), torch.no_grad():
+        for start in range(0, len(y_test), batch_size):
+            x_batch = [x[start:start + batch_size].to(device) for x in x_test]
+            y_batch = y_test[start:start + batch_size].to(device)
             
             outputs = model(*x_batch)
             loss = criterion(outputs, y_batch)
             test_running_loss += loss.item()
+            num_batches += 1
             
             all_preds.append(outputs.cpu().numpy())
             all_targets.append(y_batch.cpu().numpy())
 
-    all_preds = np.concatenate(all_preds, axis=0)
-    all_targets = np.concatenate(all_targets, axis=0)
-    test_loss = test_running_loss / len(test_dataloader)
-    
-    # метрики
-    mse = mean_squared_error(all_targets, all_preds)
-    r2 = r2_score(all_targets, all_preds)
+    with span("metrics"):
+        all_preds = np.concatenate(all_preds, axis=0)
+        all_targets = np.concatenate(all_targets, axis=0)
+        test_loss = test_running_loss / num_batches
+        
+        # метрики
+        mse = mean_squared_error(all_targets, all_preds)
+        r2 = r2_score(all_targets, all_preds)
     
     metrics = {
         'mse': mse,
@@ -152,6 +222,31 @@ def pred(file_path, model_name, base_name):
         'test_loss': test_loss
     }
     
-    output_path = save_predictions(all_preds, all_targets, file_path, model_name, base_name, metrics)
+    with span("write"):
+        if reply is not None:
+            reply.copy_(torch.from_numpy(all_preds.reshape(-1)))
+            return None, metrics
+        if inline:
+            return all_preds.astype(np.float32, copy=False), metrics
+        
+        output_path = save_predictions(all_preds, all_targets, file_path, model_name, base_name, metrics)
     
-    return output_path, metrics
\ No newline at end of file
+    return output_path, metrics
+
+def inline_reply(preds, metrics):
+    """
+    Ответ /predict/binary?inline=1 (разбирает client/prediction_reply.h): короткие поля первыми,
+    предсказания [P, N] построчно одним плоским массивом. 9 значащих цифр восстанавливают float32
+    точно и короче repr float64; NaN и Infinity - как у json.dumps
+    """
+    with span("serialize"):
+        num_samples, num_targets = preds.shape
+        # метрики sklearn могут быть скалярами numpy - json их не пишет
+        metrics = {name: float(value) for name, value in metrics.items()}
+        head = json.dumps({"status": "success", "metrics": metrics, "num_samples": num_samples,
+                           "num_targets": num_targets})
+        values = ",".join(map("{:.9g}".format, preds.reshape(-1).tolist()))
+        if not np.isfinite(preds).all():
+            special = {"nan": "NaN", "inf": "Infinity", "-inf": "-Infinity"}
+            values = ",".join(special.get(v, v) for v in values.split(","))
+        return head[:-1] + ', "predictions": [' + values + "]}"
@@ -7,11 +7,20 @@ from pathlib import Path
 from sklearn.metrics import r2_score
 
 sys.path.append(os.path.abspath(os.path.join(os.path.dirname(__file__), '..', 'models')))
-from Dataset import DynamicNMRDataset
+from Dataset import DynamicNMRDataset, IndexedNMRDataset
 from ConvLayers_model import DynamicNMRRegressor
 
 sys.path.append(os.path.abspath(os.path.join(os.path.dirname(__file__), '..', 'preproc')))
-from Preprocess import parse_data_file, splitSamples, split_data
+from Preprocess import parse_data_file, splitSamples, split_data, split_indices
+from BinaryBase import binary_base_path, load_binary_base, validate_binary_config
+from SplitIndex import split_index_path, load_split_index, fold_indices
+
+from ml.export_weights import export_model, get_native_weights_path
+
+class TrainingCancelled(Exception):
+    """Обучение остановлено по запросу клиента (should_stop)"""
+
+NUM_EPOCHS = 250
 
 def parse_config(config_path):
     """Парсинг конфигурационного файла"""
@@ -79,42 +88,64 @@ def get_best_model_path(base_name, model_name, models_dir):
 
 def create_model(model_name, input_dims, num_targets):
     """Выбор модели по названию"""
-    if model_name == "svr":
-        # TODO svr
-        return DynamicNMRRegressor(input_dims, num_targets)
-    elif model_name == "convolutional":
-        return DynamicNMRRegressor(input_dims, num_targets)
-    elif model_name == "linear_regression":
-        # TODO smth else
+    if model_name == "convolutional":
         return DynamicNMRRegressor(input_dims, num_targets)
+    elif model_name in ("svr", "linear_regression"):
+        # Обучаются клиентом по .rslb (client/native_regression.h), сервер обучил бы вместо них CNN
+        raise Exception(f"Model {model_name} is trained by the client, not by the server")
     else:
         raise Exception(f"Unknown model type: {model_name}")
 
-def train(base_name, path_to_base, path_to_config, model_name):
+def train(base_name, path_to_base, path_to_config, model_name, progress_cb=None, should_stop=None, fold=None):
+    """
+    :param progress_cb: вызывается после каждой эпохи со словарём epoch/train_loss/test_loss/r2
+    :param should_stop: проверяется перед каждым пакетом; True - TrainingCancelled, веса не сохраняются
+    :param fold: номер фолда из .rssplit для перекрёстной проверки (None - обычное разбиение train/test)
+    """
     models_dir = Path(os.getenv('APPDATA')) / "ResSysApp" / "models"
     models_dir.mkdir(parents=True, exist_ok=True)
     
     config = parse_config(path_to_config)
     
-    parsed_data = parse_data_file(path_to_base)
-    
-    validate_config(config, parsed_data)
-    
-    train_data, test_data = split_data(parsed_data, train_ratio=0.85, shuffle=True, random_seed=42)
-    x_train, y_train = splitSamples(train_data)
-    x_test, y_test = splitSamples(test_data)
+    binary_path = binary_base_path(path_to_base)
+    if binary_path.exists():
+        # Бинарная копия от клиента: текст не разбираем, записи берутся из memmap по индексам
+        base = load_binary_base(binary_path)
+        validate_binary_config(config, base)
+        
+        split_path = split_index_path(path_to_base)
+        if split_path.exists():
+            # Разбиение от клиента (seed из [training] app_config.ini), индексы тоже отображены в память
+            split = load_split_index(split_path, base['num_samples'])
+            train_idx, test_idx = fold_indices(split, fold) if fold is not None else (split['train'], split['test'])
+        elif fold is not None:
+            raise Exception(f"No split index file for fold {fold}: {split_path}")
+        else:
+            train_idx, test_idx = split_indices(base['num_samples'], train_ratio=0.85, shuffle=True, random_seed=42)
+        
+        train_dataset = IndexedNMRDataset(base['x'], base['y'], train_idx)
+        test_dataset = IndexedNMRDataset(base['x'], base['y'], test_idx)
+        input_dims = base['x_lengths']
+        num_targets = base['num_targets_y']
+    else:
+        parsed_data = parse_data_file(path_to_base)
+        
+        validate_config(config, parsed_data)
+        
+        train_data, test_data = split_data(parsed_data, train_ratio=0.85, shuffle=True, random_seed=42)
+        x_train, y_train = splitSamples(train_data)
+        x_test, y_test = splitSamples(test_data)
+        
+        train_dataset = DynamicNMRDataset(*x_train, y=y_train)
+        test_dataset = DynamicNMRDataset(*x_test, y=y_test)
+        input_dims = [len(x[0]) for x in x_train]
+        num_targets = len(y_train[0])
+        
+        assert input_dims == [len(x[0]) for x in x_test] and num_targets == len(y_test[0]), "Несоответствие размеров train/test"
 
     batch_size = 32
-    train_dataset = DynamicNMRDataset(*x_train, y=y_train)
     train_dataloader = DataLoader(train_dataset, batch_size=batch_size, shuffle=True)
-
-    test_dataset = DynamicNMRDataset(*x_test, y=y_test)
     test_dataloader = DataLoader(test_dataset, batch_size=batch_size, shuffle=False)
-
-    input_dims = [len(x[0]) for x in x_train]
-    num_targets = len(y_train[0])
-
-    assert input_dims == [len(x[0]) for x in x_test] and num_targets == len(y_test[0]), "Несоответствие размеров train/test"
     # print(f"Input dimensions: {input_dims}, Number of targets: {num_targets}")
 
     device = torch.device('cuda' if torch.cuda.is_available() else 'cpu')
@@ -143,11 +174,16 @@ def train(base_name, path_to_base, path_to_config, model_name):
     final_weights_path = get_model_path(base_name, model_name, models_dir)
     best_weights_path = get_best_model_path(base_name, model_name, models_dir)
 
-    for epoch in range(250):
+    for epoch in range(NUM_EPOCHS):
         model.train()
         train_running_loss = 0.0
         
         for batch in train_dataloader:
+            if should_stop is not None and should_stop():
+                if best_weights_path.exists():
+                    best_weights_path.unlink()
+                raise TrainingCancelled()
+            
             *x_batch, y_batch = batch
             x_batch = [x.to(device) for x in x_batch]
             y_batch = y_batch.to(device)
@@ -189,6 +225,17 @@ def train(base_name, path_to_base, path_to_config, model_name):
         history['test_loss'].append(test_loss)
         history['r2'].append(r2)
         
+        if progress_cb is not None:
+            best_so_far = test_loss if test_loss < best_test_loss and r2 >= r2_threshold else best_test_loss
+            progress_cb({
+                'epoch': epoch + 1,
+                'epochs': NUM_EPOCHS,
+                'train_loss': train_loss,
+                'test_loss': test_loss,
+                'r2': float(r2),
+                'best_test_loss': best_so_far if best_so_far != float('inf') else None,
+            })
+        
         # print(f"Epoch {epoch + 1}")
         # print(f"Train Loss: {train_loss:.4f} | Test Loss: {test_loss:.4f} | R² Score: {r2:.4f}")
         
@@ -223,4 +270,10 @@ def train(base_name, path_to_base, path_to_config, model_name):
 
     torch.save(model.state_dict(), final_weights_path)
     
+    # Копия весов для нативного движка клиента (client/nmr_inference)
+    try:
+        export_model(model.to('cpu'), input_dims, num_targets, get_native_weights_path(final_weights_path))
+    except Exception as e:
+        print(f"Native weights export failed: {e}")
+    
     return best_test_loss, str(final_weights_path), best_r2
\ No newline at end of file
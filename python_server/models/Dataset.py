@@ -1,3 +1,4 @@
+import numpy as np
 import torch
 from torch.utils.data import Dataset
 
@@ -7,11 +8,34 @@ class DynamicNMRDataset(Dataset):
         :param x_signals: Списки сигналов (каждый размером [P, L_i], L_i может отличаться)
         :param y: Целевые переменные [P, N]
         """
-        self.x_signals = [torch.FloatTensor(x) for x in x_signals]
-        self.y = torch.FloatTensor(y)
+        # as_tensor не копирует уже готовые float32-массивы numpy
+        self.x_signals = [torch.as_tensor(x, dtype=torch.float32) for x in x_signals]
+        self.y = torch.as_tensor(y, dtype=torch.float32)
         
     def __len__(self):
         return len(self.y)
     
     def __getitem__(self, idx):
-        return tuple(x[idx] for x in self.x_signals) + (self.y[idx],)
\ No newline at end of file
+        return tuple(x[idx] for x in self.x_signals) + (self.y[idx],)
+
+class IndexedNMRDataset(Dataset):
+    def __init__(self, x_signals, y, indices):
+        """
+        Выборка из отображённой в память базы (.rslb) по номерам записей: база не
+        копируется, строки читаются с диска при обращении
+
+        :param x_signals: массивы каналов [P, L_i] (np.memmap)
+        :param y: целевые переменные [P, N] (np.memmap)
+        :param indices: номера записей выборки (срез np.memmap из .rssplit или список)
+        """
+        self.x_signals = x_signals
+        self.y = y
+        self.indices = indices
+
+    def __len__(self):
+        return len(self.indices)
+
+    def __getitem__(self, idx):
+        i = int(self.indices[idx])
+        # np.array копирует одну строку: memmap только для чтения, а torch ждёт записываемый буфер
+        return tuple(torch.from_numpy(np.array(x[i])) for x in self.x_signals) + (torch.from_numpy(np.array(self.y[i])),)
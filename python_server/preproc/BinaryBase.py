@@ -0,0 +1,87 @@
+import struct
+from pathlib import Path
+
+import numpy as np
+
+# Формат .rslb описан в client/learning_base_binary.h
+MAGIC = b"RSLBASE\0"
+VERSION = 1
+FIXED_HEADER = struct.Struct("<8sIIQIIQQQ")
+FIXED_HEADER_SIZE = 64
+
+
+def binary_base_path(text_path):
+    """Путь к бинарной копии базы, которую клиент пишет рядом с .txt"""
+    return Path(text_path).with_suffix(".rslb")
+
+
+def load_binary_base(path):
+    """
+    Отображает .rslb в память без копирования
+
+    :return: словарь с name, y_precision, x (список массивов [P, L_i]),
+             y ([P, N]) и record_offsets ([P])
+    """
+    with open(path, "rb") as f:
+        head = f.read(FIXED_HEADER_SIZE)
+        if len(head) < FIXED_HEADER_SIZE:
+            raise Exception(f"Binary learning base is truncated: {path}")
+
+        (magic, version, header_size, num_samples, num_targets_y, num_features_x,
+         y_offset, offsets_offset, file_size) = FIXED_HEADER.unpack_from(head)
+        if magic != MAGIC:
+            raise Exception(f"Not a binary learning base: {path}")
+        if version != VERSION:
+            raise Exception(f"Unsupported binary learning base version: {version}")
+
+        variable = f.read(header_size - FIXED_HEADER_SIZE)
+
+    if Path(path).stat().st_size != file_size:
+        raise Exception(f"Binary learning base is truncated: {path}")
+
+    pos = 0
+    x_offsets = struct.unpack_from(f"<{num_features_x}Q", variable, pos)
+    pos += 8 * num_features_x
+    x_lengths = struct.unpack_from(f"<{num_features_x}I", variable, pos)
+    pos += 4 * num_features_x
+    y_precision = struct.unpack_from(f"<{num_targets_y}d", variable, pos)
+    pos += 8 * num_targets_y
+    (name_length,) = struct.unpack_from("<I", variable, pos)
+    pos += 4
+    name = variable[pos:pos + name_length].decode("utf-8")
+
+    x = [
+        np.memmap(path, dtype="<f4", mode="r", offset=offset, shape=(num_samples, length))
+        for offset, length in zip(x_offsets, x_lengths)
+    ]
+    y = np.memmap(path, dtype="<f4", mode="r", offset=y_offset, shape=(num_samples, num_targets_y))
+    record_offsets = np.memmap(path, dtype="<u8", mode="r", offset=offsets_offset, shape=(num_samples,))
+
+    return {
+        "name": name,
+        "num_samples": num_samples,
+        "num_targets_y": num_targets_y,
+        "num_features_x": num_features_x,
+        "x_lengths": list(x_lengths),
+        "y_precision": list(y_precision),
+        "x": x,
+        "y": y,
+        "record_offsets": record_offsets,
+    }
+
+
+def validate_binary_config(config, base):
+    """Проверка соответствия конфига бинарной базе (аналог validate_config)"""
+    num_samples = int(config['num_samples'])
+    if base['num_samples'] != num_samples:
+        raise Exception(f"Sample count mismatch: config has {num_samples}, data has {base['num_samples']}")
+
+    num_targets_y = int(config['num_targets_y'])
+    if base['num_targets_y'] != num_targets_y:
+        raise Exception(f"Target variables count mismatch: config has {num_targets_y}, data has {base['num_targets_y']}")
+
+    x_lengths = list(map(int, config['x_lengths'].split(',')))
+    if base['x_lengths'] != x_lengths:
+        raise Exception(f"Feature lengths mismatch: config has {x_lengths}, data has {base['x_lengths']}")
+
+    return True
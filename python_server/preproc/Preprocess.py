@@ -1,6 +1,6 @@
+import itertools
 import os
 import random
-from copy import deepcopy
 
 def parse_directory(directory_path):
     all_samples = []
@@ -23,75 +23,77 @@ def parse_directory(directory_path):
     return all_samples
 
 def parse_data_file(file_path):
+    # Файл читается построчно, без readlines(): в памяти только разобранные записи
     with open(file_path, 'r') as file:
-        lines = file.readlines()
-    try:
-        first_line = lines[1].strip()
-        A = int(first_line.split('with ')[1].split(' records')[0])
-    except:
-        # print("test data")
-        pass
-    samples = []
-    current_sample = None
-    current_x_key = None
-    collecting_x_data = False
-    x_data_buffer = []
+        lines = iter(file)
+        header = [next(lines, ''), next(lines, '')]
+        try:
+            first_line = header[1].strip()
+            A = int(first_line.split('with ')[1].split(' records')[0])
+        except:
+            # print("test data")
+            pass
+        samples = []
+        current_sample = None
+        current_x_key = None
+        collecting_x_data = False
+        x_data_buffer = []
 
-    for line in lines:
-        line = line.strip()
+        for line in itertools.chain(header, lines):
+            line = line.strip()
         
-        if "*******************new*record*******************" in line:
-            if current_sample is not None:
-                if current_x_key is not None and x_data_buffer:
-                    current_sample[current_x_key] = x_data_buffer
-                samples.append(current_sample)
+            if "*******************new*record*******************" in line:
+                if current_sample is not None:
+                    if current_x_key is not None and x_data_buffer:
+                        current_sample[current_x_key] = x_data_buffer
+                    samples.append(current_sample)
             
-            current_sample = {"Yi": []}
-            current_x_key = None
-            collecting_x_data = False
-            x_data_buffer = []
-            continue
+                current_sample = {"Yi": []}
+                current_x_key = None
+                collecting_x_data = False
+                x_data_buffer = []
+                continue
         
-        if line.startswith("nY="):
-            nY = int(line.split('=')[1].strip())
-            continue
+            if line.startswith("nY="):
+                nY = int(line.split('=')[1].strip())
+                continue
         
-        if line.startswith("Y"):
-            parts = line.split('=')
-            if len(parts) == 2:
-                try:
-                    y_value = float(parts[1].strip())
-                    current_sample["Yi"].append(y_value)
-                except ValueError:
-                    pass
-            continue
+            if line.startswith("Y"):
+                parts = line.split('=')
+                if len(parts) == 2:
+                    try:
+                        y_value = float(parts[1].strip())
+                        current_sample["Yi"].append(y_value)
+                    except ValueError:
+                        pass
+                continue
         
-        if line.startswith("nX="):
-            nX = int(line.split('=')[1].strip())
-            for i in range(nX):
-                current_sample[f"X[{i}]"] = []
-            continue
+            if line.startswith("nX="):
+                nX = int(line.split('=')[1].strip())
+                for i in range(nX):
+                    current_sample[f"X[{i}]"] = []
+                continue
         
-        if "array of X[" in line and "with" in line:
-            if current_x_key is not None and x_data_buffer:
-                current_sample[current_x_key] = x_data_buffer
-                x_data_buffer = []
+            if "array of X[" in line and "with" in line:
+                if current_x_key is not None and x_data_buffer:
+                    current_sample[current_x_key] = x_data_buffer
+                    x_data_buffer = []
             
-            x_index = line.split('array of X[')[1].split(']')[0]
-            current_x_key = f"X[{x_index}]"
-            collecting_x_data = True
-            continue
+                x_index = line.split('array of X[')[1].split(']')[0]
+                current_x_key = f"X[{x_index}]"
+                collecting_x_data = True
+                continue
         
-        # Сбор данных эксперимента
-        if collecting_x_data:
-            numbers = []
-            for part in line.split():
-                try:
-                    num = float(part)
-                    numbers.append(num)
-                except ValueError:
-                    pass
-            x_data_buffer.extend(numbers)
+            # Сбор данных эксперимента
+            if collecting_x_data:
+                numbers = []
+                for part in line.split():
+                    try:
+                        num = float(part)
+                        numbers.append(num)
+                    except ValueError:
+                        pass
+                x_data_buffer.extend(numbers)
     
     if current_sample is not None:
         if current_x_key is not None and x_data_buffer:
@@ -126,7 +128,8 @@ def split_data(parsed_data, train_ratio=0.8, shuffle=True, random_seed=None):
     :param random_seed: Фиксирует случайность для воспроизводимости
     :return: train_data, test_data (оба в том же формате, что и parsed_data)
     """
-    data_copy = deepcopy(parsed_data)
+    # Записи не изменяются, поэтому достаточно копии списка - deepcopy удваивал память под базу
+    data_copy = list(parsed_data)
     
     if random_seed is not None:
         random.seed(random_seed)
@@ -139,4 +142,21 @@ def split_data(parsed_data, train_ratio=0.8, shuffle=True, random_seed=None):
     train_data = data_copy[:split_idx]
     test_data = data_copy[split_idx:]
     
-    return train_data, test_data
\ No newline at end of file
+    return train_data, test_data
+
+def split_indices(num_samples, train_ratio=0.8, shuffle=True, random_seed=None):
+    """
+    То же разбиение, что и split_data, но над индексами записей: перестановка
+    совпадает с random.shuffle списка той же длины, а данные не копируются
+    """
+    indices = list(range(num_samples))
+    
+    if random_seed is not None:
+        random.seed(random_seed)
+    
+    if shuffle:
+        random.shuffle(indices)
+    
+    split_idx = int(num_samples * train_ratio)
+    
+    return indices[:split_idx], indices[split_idx:]
\ No newline at end of file
@@ -0,0 +1,93 @@
+import struct
+import threading
+from multiprocessing import shared_memory
+
+import torch
+
+# Раскладка сегмента описана в client/shared_tensor_ring.h
+MAGIC = b"RSSHMRNG"
+VERSION = 1
+HEADER = struct.Struct("<8sIIQ")
+
+_segments = {}
+_retired = []  # сегменты прошлых клиентов, поверх которых ещё живы тензоры
+_lock = threading.Lock()
+
+
+def _attach(name):
+    """Подключение к сегменту клиента; сегмент создаёт и удаляет только клиент"""
+    try:
+        return shared_memory.SharedMemory(name=name, track=False)
+    except TypeError:
+        # До Python 3.13 нет track: иначе resource_tracker удалит чужой сегмент при выходе сервера
+        shm = shared_memory.SharedMemory(name=name)
+        try:
+            from multiprocessing import resource_tracker
+            resource_tracker.unregister(shm._name, "shared_memory")
+        except Exception:
+            pass
+        return shm
+
+
+def _release_retired():
+    for shm in list(_retired):
+        try:
+            shm.close()
+        except BufferError:
+            continue  # запрос ещё работает с буфером - закроем при следующем обращении
+        _retired.remove(shm)
+
+
+def _get_segment_locked(name):
+    shm = _segments.get(name)
+    if shm is None:
+        shm = _attach(name)
+        magic, version, _, _ = HEADER.unpack_from(shm.buf)
+        if magic != MAGIC:
+            shm.close()
+            raise Exception(f"Not a ResSys shared memory segment: {name}")
+        if version != VERSION:
+            shm.close()
+            raise Exception(f"Unsupported shared memory ring version: {version}")
+        # Новое имя - новый клиент: демон переживает клиентов, и кольца прошлых сессий
+        # иначе оставались бы отображены до выхода сервера
+        _retired.extend(_segments.values())
+        _segments.clear()
+        _segments[name] = shm
+    _release_retired()
+    return shm
+
+
+def get_segment(name):
+    """Отображение сегмента по имени (переиспользуется между запросами, пока не подключится другой клиент)"""
+    with _lock:
+        return _get_segment_locked(name)
+
+
+def slot_views(name, request_offset, request_size, reply_offset, reply_count):
+    """
+    Вход и область ответа слота без копирования
+
+    :return: memoryview входа (формат TensorPayload), тензор float32 [reply_count] для ответа
+    """
+    # Представления создаются под замком: сегмент, на котором их уже создали, не закроется
+    with _lock:
+        shm = _get_segment_locked(name)
+        if request_offset + request_size > shm.size or reply_offset + 4 * reply_count > shm.size:
+            raise Exception("Shared memory slot is out of segment bounds")
+
+        request = shm.buf[request_offset:request_offset + request_size]
+        reply = torch.frombuffer(shm.buf, dtype=torch.float32, count=reply_count, offset=reply_offset)
+    return request, reply
+
+
+def close_segments():
+    with _lock:
+        _retired.extend(_segments.values())
+        _segments.clear()
+        for shm in _retired:
+            try:
+                shm.close()
+            except BufferError:
+                pass  # ещё живы тензоры поверх буфера - отображение закроется с процессом
+        _retired.clear()
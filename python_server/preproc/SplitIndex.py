@@ -0,0 +1,60 @@
+import struct
+from pathlib import Path
+
+import numpy as np
+
+# Формат .rssplit описан в client/learning_base_split.h
+MAGIC = b"RSSPLIT\0"
+VERSION = 1
+FIXED_HEADER = struct.Struct("<8sIIQQQI")
+FIXED_HEADER_SIZE = 64
+
+
+def split_index_path(text_path):
+    """Путь к файлу разбиения, который клиент пишет рядом с .txt и .rslb"""
+    return Path(text_path).with_suffix(".rssplit")
+
+
+def load_split_index(path, num_samples):
+    """
+    Отображает индексы разбиения в память
+
+    :param num_samples: число записей базы - файл от другой версии базы отвергается
+    :return: словарь с seed, train и test (срезы перестановки, без копий)
+             и folds - список проверочных частей фолдов
+    """
+    with open(path, "rb") as f:
+        head = f.read(FIXED_HEADER_SIZE)
+        if len(head) < FIXED_HEADER_SIZE:
+            raise Exception(f"Learning base split is truncated: {path}")
+
+        magic, version, header_size, split_samples, seed, train_count, num_folds = FIXED_HEADER.unpack_from(head)
+        if magic != MAGIC:
+            raise Exception(f"Not a learning base split: {path}")
+        if version != VERSION:
+            raise Exception(f"Unsupported learning base split version: {version}")
+        if split_samples != num_samples:
+            raise Exception(f"Split is for {split_samples} samples, base has {num_samples}")
+
+        bounds = struct.unpack(f"<{num_folds + 1}Q", f.read(8 * (num_folds + 1))) if num_folds else ()
+
+    if Path(path).stat().st_size != header_size + 8 * num_samples:
+        raise Exception(f"Learning base split is truncated: {path}")
+
+    permutation = np.memmap(path, dtype="<u8", mode="r", offset=header_size, shape=(num_samples,))
+    return {
+        "seed": seed,
+        "permutation": permutation,
+        "train": permutation[:train_count],
+        "test": permutation[train_count:],
+        "folds": [permutation[bounds[k]:bounds[k + 1]] for k in range(num_folds)],
+    }
+
+
+def fold_indices(split, fold):
+    """Обучающие и проверочные индексы k-го фолда (копируются только индексы остальных фолдов)"""
+    folds = split["folds"]
+    if not 0 <= fold < len(folds):
+        raise Exception(f"Fold {fold} is out of range, split has {len(folds)} folds")
+    train = np.concatenate([f for k, f in enumerate(folds) if k != fold])
+    return train, folds[fold]
@@ -0,0 +1,44 @@
+import struct
+import warnings
+
+import torch
+
+# Формат тела POST /predict/binary описан в client/prediction_payload.h
+MAGIC = b"RSTENSOR"
+VERSION = 1
+FIXED_HEADER = struct.Struct("<8sIIIII")
+
+
+def decode_tensor_payload(body):
+    """
+    Разбирает тело запроса в тензоры без копирования данных
+
+    :param body: bytes из запроса
+    :return: x (список тензоров [P, L_i]), y ([P, N])
+    """
+    if len(body) < FIXED_HEADER.size:
+        raise Exception("Binary payload is truncated")
+
+    magic, version, header_size, num_samples, num_targets_y, num_features_x = FIXED_HEADER.unpack_from(body)
+    if magic != MAGIC:
+        raise Exception("Not a tensor payload")
+    if version != VERSION:
+        raise Exception(f"Unsupported tensor payload version: {version}")
+
+    x_lengths = struct.unpack_from(f"<{num_features_x}I", body, FIXED_HEADER.size)
+    expected = header_size + 4 * num_samples * (sum(x_lengths) + num_targets_y)
+    if len(body) != expected:
+        raise Exception(f"Binary payload size mismatch: expected {expected} bytes, got {len(body)}")
+
+    # bytes только для чтения - тензоры здесь тоже только читаются
+    with warnings.catch_warnings():
+        warnings.simplefilter("ignore", UserWarning)
+        offset = header_size
+        x = []
+        for length in x_lengths:
+            count = num_samples * length
+            x.append(torch.frombuffer(body, dtype=torch.float32, count=count, offset=offset).view(num_samples, length))
+            offset += 4 * count
+        y = torch.frombuffer(body, dtype=torch.float32, count=num_samples * num_targets_y, offset=offset)
+
+    return x, y.view(num_samples, num_targets_y)
@@ -0,0 +1,113 @@
+import json
+import logging
+import os
+import threading
+import time
+
+logger = logging.getLogger("PY_Server")
+
+
+def pid_alive(pid):
+    """Жив ли процесс pid (и доступен ли он текущему пользователю)"""
+    if pid <= 0:
+        return False
+    if os.name == "nt":
+        import ctypes
+        PROCESS_QUERY_LIMITED_INFORMATION = 0x1000
+        STILL_ACTIVE = 259
+        kernel32 = ctypes.windll.kernel32
+        handle = kernel32.OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, False, pid)
+        if not handle:
+            return False
+        code = ctypes.c_ulong()
+        ok = kernel32.GetExitCodeProcess(handle, ctypes.byref(code))
+        kernel32.CloseHandle(handle)
+        return bool(ok) and code.value == STILL_ACTIVE
+    try:
+        os.kill(pid, 0)
+    except OSError:
+        return False
+    return True
+
+
+class LockFile:
+    """
+    Файл блокировки сервера-демона (читает client/server_daemon.h):
+    {"pid", "port", "uds", "version", "started"}. Создаётся эксклюзивно,
+    файл умершего сервера считается устаревшим и перезаписывается.
+    """
+
+    def __init__(self, path, info):
+        self.path = path
+        self.info = info
+        self.owned = False
+
+    def acquire(self):
+        os.makedirs(os.path.dirname(self.path) or ".", exist_ok=True)
+        for _ in range(2):
+            try:
+                fd = os.open(self.path, os.O_CREAT | os.O_EXCL | os.O_WRONLY, 0o600)
+            except FileExistsError:
+                other = self._read()
+                if other and pid_alive(int(other.get("pid", 0))):
+                    raise RuntimeError(f"Another server is already running (pid {other.get('pid')})")
+                os.remove(self.path)
+                continue
+            with os.fdopen(fd, "w") as f:
+                json.dump(self.info, f)
+            self.owned = True
+            return
+        raise RuntimeError(f"Cannot create lock file {self.path}")
+
+    def release(self):
+        # Удаляем только свой файл: после выхода по простою его мог уже занять новый сервер
+        if self.owned:
+            other = self._read()
+            if other and int(other.get("pid", 0)) == os.getpid():
+                os.remove(self.path)
+            self.owned = False
+
+    def _read(self):
+        try:
+            with open(self.path) as f:
+                return json.load(f)
+        except (OSError, ValueError):
+            return None
+
+
+class IdleWatchdog:
+    """Вызывает on_idle, если timeout секунд не было запросов и is_busy() ложно"""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.in_flight = 0
+        self.last_activity = time.monotonic()
+
+    def begin(self):
+        with self.lock:
+            self.in_flight += 1
+            self.last_activity = time.monotonic()
+
+    def end(self):
+        with self.lock:
+            self.in_flight -= 1
+            self.last_activity = time.monotonic()
+
+    def start(self, timeout, is_busy, on_idle):
+        def watch():
+            while True:
+                time.sleep(min(timeout, 30))
+                with self.lock:
+                    idle = self.in_flight == 0 and time.monotonic() - self.last_activity >= timeout
+                if not idle:
+                    continue
+                # Ошибка колбэка не должна молча убить поток: иначе демон никогда не выйдет
+                try:
+                    if is_busy():
+                        continue
+                    on_idle()
+                    return
+                except Exception:
+                    logger.exception("Idle watchdog callback failed")
+
+        threading.Thread(target=watch, name="idle-watchdog", daemon=True).start()
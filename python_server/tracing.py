@@ -0,0 +1,53 @@
+import contextvars
+import json
+import os
+import time
+from contextlib import contextmanager
+
+# Заголовки трассировки (client/trace_recorder.h): клиент присылает X-Trace-Id,
+# сервер возвращает его же и свои интервалы в X-Trace-Spans
+TRACE_HEADER = "X-Trace-Id"
+SPANS_HEADER = "X-Trace-Spans"
+
+_current = contextvars.ContextVar("ressys_trace", default=None)
+
+
+def _now_us():
+    return time.time_ns() // 1000
+
+
+class RequestTrace:
+    """Интервалы одного запроса: [name, начало в мкс от эпохи, длительность в мкс]"""
+
+    def __init__(self, trace_id):
+        self.trace_id = trace_id
+        self.spans = []
+
+    def header(self):
+        # ensure_ascii - значение заголовка должно остаться latin-1
+        return json.dumps({"pid": os.getpid(), "spans": self.spans}, separators=(",", ":"))
+
+
+@contextmanager
+def request_trace(trace_id):
+    """Делает trace текущим для запроса; контекст копируется и в пул потоков run_in_threadpool"""
+    trace = RequestTrace(trace_id)
+    token = _current.set(trace)
+    try:
+        yield trace
+    finally:
+        _current.reset(token)
+
+
+@contextmanager
+def span(name):
+    """Интервал этапа обработки; вне трассируемого запроса ничего не делает"""
+    trace = _current.get()
+    if trace is None:
+        yield
+        return
+    start = _now_us()
+    try:
+        yield
+    finally:
+        trace.spans.append([name, start, _now_us() - start])